@@ -90,6 +90,8 @@
 #include "utils/TuxBoxUtil.h"
 #include "utils/SystemInfo.h"
 #include "utils/TimeUtils.h"
+#include "utils/LibraryWatcher.h"
+#include "threads/LockProfiler.h"
 #include "GUILargeTextureManager.h"
 #include "TextureCache.h"
 #include "music/LastFmManager.h"
@@ -1732,6 +1734,8 @@ void CApplication::DimLCDOnPlayback(bool dim)
 
 void CApplication::StartServices()
 {
+  CAnnouncementManager::Start();
+
 #if !defined(_WIN32) && defined(HAS_DVD_DRIVE)
   // Start Thread for DVD Mediatype detection
   CLog::Log(LOGNOTICE, "start dvd mediatype detection");
@@ -1765,6 +1769,8 @@ void CApplication::StopServices()
 #endif
 
   g_peripherals.Clear();
+
+  CAnnouncementManager::Stop();
 }
 
 void CApplication::ReloadSkin()
@@ -3462,6 +3468,12 @@ void CApplication::Stop(int exitCode)
     if( m_bSystemScreenSaverEnable )
       g_Windowing.EnableSystemScreenSaver(true);
 
+    // report the most contended locks and the messenger latencies of this
+    // session before we tear down
+    if (XbmcThreads::LockProfiler::IsEnabled())
+      XbmcThreads::LockProfiler::Dump();
+    m_applicationMessenger.DumpStats();
+
     CLog::Log(LOGNOTICE, "Storing total System Uptime");
     g_settings.m_iSystemTimeTotalUp = g_settings.m_iSystemTimeTotalUp + (int)(CTimeUtils::GetFrameTime() / 60000);
 
@@ -3487,6 +3499,8 @@ void CApplication::Stop(int exitCode)
     if (m_videoInfoScanner->IsScanning())
       m_videoInfoScanner->Stop();
 
+    CLibraryWatcher::Get().StopWatching();
+
     m_applicationMessenger.Cleanup();
 
     StopPVRManager();
@@ -4842,6 +4856,14 @@ bool CApplication::OnMessage(CGUIMessage& message)
     }
     break;
 
+  case GUI_MSG_PLAYLIST_CHANGED:
+    {
+      // the item queued in the player may no longer be the next one
+      if (m_pPlayer)
+        m_pPlayer->OnPlayListChanged();
+    }
+    break;
+
   case GUI_MSG_QUEUE_NEXT_ITEM:
     {
       // Check to see if our playlist player has a new item for us,
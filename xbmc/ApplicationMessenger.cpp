@@ -33,6 +33,7 @@
 #include "interfaces/Builtins.h"
 #include "network/Network.h"
 #include "utils/log.h"
+#include "utils/TimeUtils.h"
 #include "utils/URIUtils.h"
 #include "guilib/GUIWindowManager.h"
 #include "settings/Settings.h"
@@ -99,6 +100,34 @@ void CDelayedMessage::Process()
     g_application.getApplicationMessenger().SendMessage(m_msg, false);
 }
 
+// how many processed messages we keep around for reuse
+#define MESSAGE_POOL_SIZE 64
+
+bool CMessageFuture::IsDone() const
+{
+  return !m_done || m_done->WaitMSec(0);
+}
+
+bool CMessageFuture::Wait(unsigned int milliSeconds)
+{
+  return !m_done || m_done->WaitMSec(milliSeconds);
+}
+
+void CMessageFuture::Wait()
+{
+  if (m_done)
+    m_done->Wait();
+}
+
+CApplicationMessenger::CApplicationMessenger()
+{
+  lf_mpsc_init(&m_messages);
+  lf_mpsc_init(&m_windowMessages);
+  m_pool.reserve(MESSAGE_POOL_SIZE);
+  m_poolLock = 0;
+  m_stopped = false;
+}
+
 CApplicationMessenger::~CApplicationMessenger()
 {
   Cleanup();
@@ -106,111 +135,167 @@ CApplicationMessenger::~CApplicationMessenger()
 
 void CApplicationMessenger::Cleanup()
 {
-  CSingleLock lock (m_critSection);
+  // no message may be queued after the final drain, its sender would wait forever
+  CExclusiveLock queueLock(m_queueSection);
+  m_stopped = true;
 
-  while (m_vecMessages.size() > 0)
+  lf_mpsc_queue *queues[] = { &m_messages, &m_windowMessages };
+  for (unsigned int i = 0; i < sizeof(queues) / sizeof(queues[0]); i++)
   {
-    ThreadMessage* pMsg = m_vecMessages.front();
+    lf_mpsc_node *node;
+    while ((node = lf_mpsc_pop(queues[i])) != NULL)
+    {
+      QueuedMessage *msg = (QueuedMessage *)node;
+      if (msg->msg.waitEvent)
+        msg->msg.waitEvent->Set();
+      delete msg;
+    }
+  }
 
-    if (pMsg->waitEvent)
-      pMsg->waitEvent->Set();
+  CAtomicSpinLock lock(m_poolLock);
+  for (vector<QueuedMessage*>::iterator it = m_pool.begin(); it != m_pool.end(); ++it)
+    delete *it;
+  m_pool.clear();
+}
 
-    delete pMsg;
-    m_vecMessages.pop();
+CApplicationMessenger::QueuedMessage *CApplicationMessenger::AllocMessage()
+{
+  {
+    CAtomicSpinLock lock(m_poolLock);
+    if (!m_pool.empty())
+    {
+      QueuedMessage *msg = m_pool.back();
+      m_pool.pop_back();
+      return msg;
+    }
   }
+  return new QueuedMessage;
+}
 
-  while (m_vecWindowMessages.size() > 0)
+void CApplicationMessenger::FreeMessage(QueuedMessage *msg)
+{
+  // drop whatever the message still references, but keep the buffers
+  msg->msg.strParam.clear();
+  msg->msg.params.clear();
+  msg->msg.waitEvent.reset();
+  msg->msg.lpVoid = NULL;
   {
-    ThreadMessage* pMsg = m_vecWindowMessages.front();
+    CAtomicSpinLock lock(m_poolLock);
+    if (m_pool.size() < MESSAGE_POOL_SIZE)
+    {
+      m_pool.push_back(msg);
+      return;
+    }
+  }
+  delete msg;
+}
 
-    if (pMsg->waitEvent)
-      pMsg->waitEvent->Set();
+bool CApplicationMessenger::QueueMessage(const ThreadMessage &message)
+{
+  // pushers only share the section, it just keeps them out of Cleanup()
+  CSharedLock queueLock(m_queueSection);
+  if (m_stopped || g_application.m_bStop)
+    return false;
 
-    delete pMsg;
-    m_vecWindowMessages.pop();
-  }
+  QueuedMessage *msg = AllocMessage();
+  msg->msg = message;
+  msg->queued = CurrentHostCounter();
+
+  if (msg->msg.dwMessage == TMSG_DIALOG_DOMODAL)
+    lf_mpsc_push(&m_windowMessages, &msg->node);
+  else
+    lf_mpsc_push(&m_messages, &msg->node);
+  // the application thread owns the message from here on, so it must not
+  // be touched any more.
+  return true;
 }
 
-void CApplicationMessenger::SendMessage(ThreadMessage& message, bool wait)
+CMessageFuture CApplicationMessenger::SendMessageAsync(ThreadMessage& message)
 {
+  CMessageFuture future;
   message.waitEvent.reset();
-  boost::shared_ptr<CEvent> waitEvent;
-  if (wait)
-  { // check that we're not being called from our application thread, else we'll be waiting
-    // forever!
-    if (!g_application.IsCurrentThread())
-    {
-      message.waitEvent.reset(new CEvent(true));
-      waitEvent = message.waitEvent;
-    }
-    else
-    {
-      //OutputDebugString("Attempting to wait on a SendMessage() from our application thread will cause lockup!\n");
-      //OutputDebugString("Sending immediately\n");
-      ProcessMessage(&message);
-      return;
-    }
+  if (g_application.IsCurrentThread())
+  { // we're the thread that would process it, so just do it now
+    ProcessMessage(&message);
+    return future;
   }
 
-  CSingleLock lock (m_critSection);
+  future.m_done.reset(new CEvent(true));
+  message.waitEvent = future.m_done;
+  if (!QueueMessage(message))
+    future.m_done->Set(); // dropped as we're stopping - don't leave anyone waiting
+  message.waitEvent.reset();
+  return future;
+}
 
-  if (g_application.m_bStop)
+void CApplicationMessenger::SendMessage(ThreadMessage& message, bool wait)
+{
+  if (wait)
   {
-    if (message.waitEvent)
-      message.waitEvent.reset();
+    CMessageFuture future = SendMessageAsync(message);
+    if (!future.IsDone())
+    {
+      // ensure the thread doesn't hold the graphics lock
+      CSingleExit exit(g_graphicsContext);
+      future.Wait();
+    }
     return;
   }
 
-  ThreadMessage* msg = new ThreadMessage();
-  msg->dwMessage = message.dwMessage;
-  msg->dwParam1 = message.dwParam1;
-  msg->dwParam2 = message.dwParam2;
-  msg->waitEvent = message.waitEvent;
-  msg->lpVoid = message.lpVoid;
-  msg->strParam = message.strParam;
-  msg->params = message.params;
-
-  if (msg->dwMessage == TMSG_DIALOG_DOMODAL)
-    m_vecWindowMessages.push(msg);
-  else
-    m_vecMessages.push(msg);
-  lock.Leave();  // this releases the lock on the vec of messages and
-                 //   allows the ProcessMessage to execute and therefore
-                 //   delete the message itself. Therefore any accesss
-                 //   of the message itself after this point consittutes
-                 //   a race condition (yarc - "yet another race condition")
-                 //
-  if (waitEvent) // ... it just so happens we have a spare reference to the
-                 //  waitEvent ... just for such contingencies :)
-  { 
-    // ensure the thread doesn't hold the graphics lock
-    CSingleExit exit(g_graphicsContext);
-    waitEvent->Wait();
-  }
+  message.waitEvent.reset();
+  QueueMessage(message);
 }
 
 void CApplicationMessenger::ProcessMessages()
 {
   // process threadmessages
-  CSingleLock lock (m_critSection);
-  while (m_vecMessages.size() > 0)
+  ProcessQueue(&m_messages);
+}
+
+void CApplicationMessenger::ProcessQueue(lf_mpsc_queue *queue)
+{
+  // each message is popped before it's processed, as it might make another
+  // thread call processmessages or sendmessage, or bring us back here via
+  // the render loop.
+  lf_mpsc_node *node;
+  while ((node = lf_mpsc_pop(queue)) != NULL)
   {
-    ThreadMessage* pMsg = m_vecMessages.front();
-    //first remove the message from the queue, else the message could be processed more then once
-    m_vecMessages.pop();
+    QueuedMessage *msg = (QueuedMessage *)node;
+    boost::shared_ptr<CEvent> waitEvent = msg->msg.waitEvent;
+    DWORD type = msg->msg.dwMessage;
 
-    //Leave here as the message might make another
-    //thread call processmessages or sendmessage
+    int64_t start = CurrentHostCounter();
+    ProcessMessage(&msg->msg);
+    int64_t end = CurrentHostCounter();
 
-    boost::shared_ptr<CEvent> waitEvent = pMsg->waitEvent; 
-    lock.Leave(); // <- see the large comment in SendMessage ^
+    MessageStats &stats = m_stats[type];
+    stats.count++;
+    if (waitEvent)
+      stats.waited++;
+    stats.queueTime += start - msg->queued;
+    stats.queueTimeMax = std::max(stats.queueTimeMax, start - msg->queued);
+    stats.processTime += end - start;
 
-    ProcessMessage(pMsg);
+    FreeMessage(msg);
     if (waitEvent)
       waitEvent->Set();
-    delete pMsg;
+  }
+}
 
-    lock.Enter();
+void CApplicationMessenger::DumpStats()
+{
+  if (m_stats.empty())
+    return;
+
+  double msPerTick = 1000.0 / CurrentHostFrequency();
+  CLog::Log(LOGDEBUG, "%s - message count waited queued(avg/max ms) processed(avg ms)", __FUNCTION__);
+  for (map<DWORD, MessageStats>::const_iterator it = m_stats.begin(); it != m_stats.end(); ++it)
+  {
+    const MessageStats &stats = it->second;
+    CLog::Log(LOGDEBUG, "%s - %4u %6u %6u %8.2f/%8.2f %8.2f", __FUNCTION__, (unsigned int)it->first,
+              stats.count, stats.waited,
+              msPerTick * stats.queueTime / stats.count, msPerTick * stats.queueTimeMax,
+              msPerTick * stats.processTime / stats.count);
   }
 }
 
@@ -792,26 +877,8 @@ void CApplicationMessenger::ProcessMessage(ThreadMessage *pMsg)
 
 void CApplicationMessenger::ProcessWindowMessages()
 {
-  CSingleLock lock (m_critSection);
   //message type is window, process window messages
-  while (m_vecWindowMessages.size() > 0)
-  {
-    ThreadMessage* pMsg = m_vecWindowMessages.front();
-    //first remove the message from the queue, else the message could be processed more then once
-    m_vecWindowMessages.pop();
-
-    // leave here in case we make more thread messages from this one
-
-    boost::shared_ptr<CEvent> waitEvent = pMsg->waitEvent;
-    lock.Leave(); // <- see the large comment in SendMessage ^
-
-    ProcessMessage(pMsg);
-    if (waitEvent)
-      waitEvent->Set();
-    delete pMsg;
-
-    lock.Enter();
-  }
+  ProcessQueue(&m_windowMessages);
 }
 
 int CApplicationMessenger::SetResponse(CStdString response)
@@ -26,9 +26,12 @@
 #include "guilib/Key.h"
 #include "threads/Thread.h"
 #include "threads/Event.h"
+#include "threads/LockFree.h"
+#include "threads/SharedSection.h"
 #include <boost/shared_ptr.hpp>
 
-#include <queue>
+#include <map>
+#include <vector>
 
 class CFileItem;
 class CFileItemList;
@@ -129,17 +132,38 @@ struct ThreadMessageCallback
   void *userptr;
 };
 
+/*! \brief Completion handle for a message sent with SendMessageAsync().
+ Copies share the same state, so it can be handed on to whoever needs the result.
+ */
+class CMessageFuture
+{
+public:
+  bool IsDone() const;                   ///< true once the message has been processed (or dropped)
+  bool Wait(unsigned int milliSeconds);  ///< wait up to milliSeconds for completion, returns IsDone()
+  void Wait();                           ///< wait until the message has been processed
+private:
+  friend class CApplicationMessenger;
+  boost::shared_ptr<CEvent> m_done;
+};
+
 class CApplicationMessenger
 {
 
 public:
+  CApplicationMessenger();
   ~CApplicationMessenger();
 
   void Cleanup();
   // if a message has to be send to the gui, use MSG_TYPE_WINDOW instead
   void SendMessage(ThreadMessage& msg, bool wait = false);
+  /*! \brief Queue a message without blocking the caller.
+   Use the returned future to find out when the application thread has processed it.
+   Messages sent from the application thread itself are processed immediately.
+   */
+  CMessageFuture SendMessageAsync(ThreadMessage& msg);
   void ProcessMessages(); // only call from main thread.
   void ProcessWindowMessages();
+  void DumpStats(); ///< log queueing and processing times per message type (main thread only)
 
 
   void MediaPlay(std::string filename);
@@ -216,10 +240,39 @@ public:
 private:
   void ProcessMessage(ThreadMessage *pMsg);
 
-
-  std::queue<ThreadMessage*> m_vecMessages;
-  std::queue<ThreadMessage*> m_vecWindowMessages;
-  CCriticalSection m_critSection;
+  struct QueuedMessage
+  {
+    lf_mpsc_node node; // must be first
+    ThreadMessage msg;
+    int64_t queued;
+  };
+
+  struct MessageStats
+  {
+    MessageStats() : count(0), waited(0), queueTime(0), queueTimeMax(0), processTime(0) {}
+    unsigned int count;
+    unsigned int waited;  ///< how many of them had a caller blocked on them
+    int64_t queueTime;
+    int64_t queueTimeMax;
+    int64_t processTime;
+  };
+
+  bool QueueMessage(const ThreadMessage &message);
+  void ProcessQueue(lf_mpsc_queue *queue);
+  QueuedMessage *AllocMessage();
+  void FreeMessage(QueuedMessage *msg);
+
+  // any thread may push, only the application thread pops
+  lf_mpsc_queue m_messages;
+  lf_mpsc_queue m_windowMessages;
+  CSharedSection m_queueSection; ///< held shared while pushing, exclusively by Cleanup()
+  bool m_stopped;
+
+  // processed messages are kept around for reuse
+  std::vector<QueuedMessage*> m_pool;
+  long m_poolLock;
+
+  std::map<DWORD, MessageStats> m_stats; ///< only touched by the application thread
   CCriticalSection m_critBuffer;
   CStdString bufferResponse;
 
@@ -31,6 +31,7 @@
 #include "GUIInfoManager.h"
 #include "filesystem/DllLibCurl.h"
 #include "filesystem/DirectoryCache.h"
+#include "filesystem/DirectoryDiskCache.h"
 #include "GUIPassword.h"
 #include "LangInfo.h"
 #include "utils/LangCodeExpander.h"
@@ -53,6 +54,7 @@
 
   CGUIWindowManager  g_windowManager;
   XFILE::CDirectoryCache g_directoryCache;
+  XFILE::CDirectoryDiskCache g_directoryDiskCache;
 
   CGUITextureManager g_TextureManager;
   CGUILargeTextureManager g_largeTextureManager;
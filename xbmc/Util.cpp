@@ -47,6 +47,7 @@
 #include "filesystem/StackDirectory.h"
 #include "filesystem/MultiPathDirectory.h"
 #include "filesystem/DirectoryCache.h"
+#include "filesystem/DirectoryWalker.h"
 #include "filesystem/SpecialProtocol.h"
 #include "filesystem/RSSDirectory.h"
 #include "ThumbnailCache.h"
@@ -1811,36 +1812,48 @@ int CUtil::GMTZoneCalc(int iRescBiases, int iHour, int iMinute, int &iMinuteNew)
   return iHourUTC;
 }
 
-void CUtil::GetRecursiveListing(const CStdString& strPath, CFileItemList& items, const CStdString& strMask, bool bUseFileDirectories)
+static void GetRecursiveListing(CDirectoryWalker &walker, const CStdString& strPath, CFileItemList& items)
 {
   CFileItemList myItems;
-  int flags = DIR_FLAG_DEFAULTS;
-  if (!bUseFileDirectories)
-    flags |= DIR_FLAG_NO_FILE_DIRS;
-  CDirectory::GetDirectory(strPath,myItems,strMask,flags);
+  walker.GetDirectory(strPath,myItems);
   for (int i=0;i<myItems.Size();++i)
   {
     if (myItems[i]->m_bIsFolder)
-      CUtil::GetRecursiveListing(myItems[i]->GetPath(),items,strMask,bUseFileDirectories);
+      GetRecursiveListing(walker,myItems[i]->GetPath(),items);
     else
       items.Add(myItems[i]);
   }
 }
 
-void CUtil::GetRecursiveDirsListing(const CStdString& strPath, CFileItemList& item)
+void CUtil::GetRecursiveListing(const CStdString& strPath, CFileItemList& items, const CStdString& strMask, bool bUseFileDirectories)
+{
+  int flags = DIR_FLAG_DEFAULTS;
+  if (!bUseFileDirectories)
+    flags |= DIR_FLAG_NO_FILE_DIRS;
+  CDirectoryWalker walker(strMask,flags);
+  ::GetRecursiveListing(walker,strPath,items);
+}
+
+static void GetRecursiveDirsListing(CDirectoryWalker &walker, const CStdString& strPath, CFileItemList& item)
 {
   CFileItemList myItems;
-  CDirectory::GetDirectory(strPath,myItems,"",DIR_FLAG_NO_FILE_DIRS);
+  walker.GetDirectory(strPath,myItems);
   for (int i=0;i<myItems.Size();++i)
   {
     if (myItems[i]->m_bIsFolder && !myItems[i]->GetPath().Equals(".."))
     {
       item.Add(myItems[i]);
-      CUtil::GetRecursiveDirsListing(myItems[i]->GetPath(),item);
+      GetRecursiveDirsListing(walker,myItems[i]->GetPath(),item);
     }
   }
 }
 
+void CUtil::GetRecursiveDirsListing(const CStdString& strPath, CFileItemList& item)
+{
+  CDirectoryWalker walker("",DIR_FLAG_NO_FILE_DIRS);
+  ::GetRecursiveDirsListing(walker,strPath,item);
+}
+
 void CUtil::ForceForwardSlashes(CStdString& strPath)
 {
   int iPos = strPath.ReverseFind('\\');
@@ -21,6 +21,7 @@
 
 #include "AudioDecoder.h"
 #include "CodecFactory.h"
+#include "settings/AdvancedSettings.h"
 #include "settings/GUISettings.h"
 #include "FileItem.h"
 #include "music/tags/MusicInfoTag.h"
@@ -32,6 +33,12 @@ CAudioDecoder::CAudioDecoder()
 {
   m_codec = NULL;
 
+  m_outputBuffer = NULL;
+  m_outputBufferSize = 0;
+  m_pcmInputBuffer = NULL;
+  m_pcmInputBufferSize = 0;
+  m_queuedSize = 0;
+
   m_eof = false;
 
   m_status = STATUS_NO_FILE;
@@ -50,6 +57,13 @@ void CAudioDecoder::Destroy()
 
   m_pcmBuffer.Destroy();
 
+  delete[] m_outputBuffer;
+  m_outputBuffer = NULL;
+  m_outputBufferSize = 0;
+  delete[] m_pcmInputBuffer;
+  m_pcmInputBuffer = NULL;
+  m_pcmInputBufferSize = 0;
+
   if ( m_codec )
     delete m_codec;
   m_codec = NULL;
@@ -93,8 +107,22 @@ bool CAudioDecoder::Create(const CFileItem &file, int64_t seekOffset)
     return false;
   }
 
-  /* allocate the pcmBuffer for 2 seconds of audio */
-  m_pcmBuffer.Create(2 * blockSize * m_codec->m_SampleRate);
+  /* allocate the pcmBuffer for the configured amount of audio, bounded by the memory limit.
+     it holds at least two reads from the codec */
+  unsigned int bytesPerSample = m_codec->m_BitsPerSample >> 3;
+  unsigned int bufferSize = (unsigned int)((uint64_t)g_advancedSettings.m_audioDecodeBufferMsec * blockSize * m_codec->m_SampleRate / 1000);
+  bufferSize = std::min(bufferSize, (unsigned int)g_advancedSettings.m_audioDecodeBufferMaxKB * 1024);
+  bufferSize = std::max(bufferSize, 2 * INPUT_SAMPLES * bytesPerSample);
+  bufferSize -= bufferSize % blockSize;
+  m_pcmBuffer.Create(bufferSize);
+
+  /* don't wait for more than 2 seconds of audio before the stream can be played */
+  m_queuedSize = std::min(bufferSize, 2 * blockSize * m_codec->m_SampleRate) / 10 * 9;
+
+  m_pcmInputBufferSize = INPUT_SAMPLES * bytesPerSample;
+  m_pcmInputBuffer = new BYTE[m_pcmInputBufferSize];
+  m_outputBufferSize = OUTPUT_SAMPLES * bytesPerSample;
+  m_outputBuffer = new BYTE[m_outputBufferSize];
 
   // set total time from the given tag
   if (file.HasMusicInfoTag() && file.GetMusicInfoTag()->GetDuration())
@@ -149,7 +177,7 @@ unsigned int CAudioDecoder::GetDataSize()
 void *CAudioDecoder::GetData(unsigned int samples)
 {
   unsigned int size  = samples * (m_codec->m_BitsPerSample >> 3);
-  if (size > sizeof(m_outputBuffer))
+  if (size > m_outputBufferSize)
   {
     CLog::Log(LOGERROR, "CAudioDecoder::GetData - More data was requested then we have space to buffer!");
     return NULL;
@@ -200,7 +228,7 @@ int CAudioDecoder::ReadSamples(int numsamples)
       m_pcmBuffer.WriteData((char *)m_pcmInputBuffer, readSize);
 
       // update status
-      if (m_status == STATUS_QUEUING && m_pcmBuffer.getMaxReadSize() > m_pcmBuffer.getSize() * 0.9)
+      if (m_status == STATUS_QUEUING && m_pcmBuffer.getMaxReadSize() >= m_queuedSize)
       {
         CLog::Log(LOGINFO, "AudioDecoder: File is queued");
         m_status = STATUS_QUEUED;
@@ -33,11 +33,11 @@ class CFileItem;
                             // using a multiple of 1, 2, 3, 4, 5, 6 to guarantee track alignment
                             // note that 7 or higher channels won't work too well.
 
-#define INPUT_SIZE PACKET_SIZE * 3      // input data size we read from the codecs at a time
-                                        // * 3 to allow 24 bit audio
+#define DECODE_PACKETS 4                              // packets we read from the codecs at a time, which
+                                                      // cuts the per call overhead of the codecs
 
-#define OUTPUT_SAMPLES PACKET_SIZE      // max number of output samples
-#define INPUT_SAMPLES  PACKET_SIZE      // number of input samples (distributed over channels)
+#define OUTPUT_SAMPLES (PACKET_SIZE * DECODE_PACKETS) // max number of output samples
+#define INPUT_SAMPLES  (PACKET_SIZE * DECODE_PACKETS) // number of input samples (distributed over channels)
 
 #define STATUS_NO_FILE  0
 #define STATUS_QUEUING  1
@@ -82,11 +82,17 @@ private:
   CRingBuffer m_pcmBuffer;
 
   // output buffer (for transferring data from the Pcm Buffer to the rest of the audio chain)
-  float m_outputBuffer[OUTPUT_SAMPLES];
+  // sized for OUTPUT_SAMPLES in the sample format of the codec
+  BYTE *m_outputBuffer;
+  unsigned int m_outputBufferSize;
 
-  // input buffer (for transferring data from the Codecs to our Pcm Ringbuffer
-  BYTE m_pcmInputBuffer[INPUT_SIZE];
-  float m_inputBuffer[INPUT_SAMPLES];
+  // input buffer (for transferring data from the Codecs to our Pcm Ringbuffer)
+  // sized for INPUT_SAMPLES in the sample format of the codec
+  BYTE *m_pcmInputBuffer;
+  unsigned int m_pcmInputBufferSize;
+
+  // amount of decoded data after which the stream is queued
+  unsigned int m_queuedSize;
 
   // status
   bool    m_eof;
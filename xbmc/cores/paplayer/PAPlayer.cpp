@@ -35,7 +35,6 @@
 #include "threads/SingleLock.h"
 #include "cores/AudioEngine/Utils/AEUtil.h"
 
-#define TIME_TO_CACHE_NEXT_FILE 5000 /* 5 seconds before end of song, start caching the next song */
 #define FAST_XFADE_TIME           80 /* 80 milliseconds */
 
 // PAP: Psycho-acoustic Audio Player
@@ -52,12 +51,18 @@ PAPlayer::PAPlayer(IPlayerCallback& callback) :
   m_isFinished       (false),
   m_currentStream    (NULL ),
   m_audioCallback    (NULL ),
-  m_FileItem         (new CFileItem() )
+  m_FileItem         (new CFileItem() ),
+  m_preloadGeneration(0    ),
+  m_preloadBusy      (false),
+  m_preloadThread    (NULL ),
+  m_preloadStop      (false)
 {
 }
 
 PAPlayer::~PAPlayer()
 {
+  StopPreload();
+
   if (!m_isPaused)
     SoftStop(true, true);
   CloseAllStreams(false);  
@@ -175,8 +180,84 @@ void PAPlayer::SoftStop(bool wait/* = false */, bool close/* = true */)
   }
 }
 
+void PAPlayer::FreeStream(StreamInfo *si)
+{
+  if (si->m_stream)
+  {
+    CAEFactory::FreeStream(si->m_stream);
+    si->m_stream = NULL;
+  }
+
+  si->m_decoder.Destroy();
+  delete si;
+}
+
+void PAPlayer::StopPreload()
+{
+  if (!m_preloadThread)
+    return;
+
+  m_preloadStop = true;
+  m_preloadEvent.Set();
+  m_preloadThread->StopThread(true);
+  delete m_preloadThread;
+  m_preloadThread = NULL;
+
+  CSingleLock lock(m_preloadLock);
+  while(!m_preloadQueue.empty())
+  {
+    delete m_preloadQueue.front();
+    m_preloadQueue.pop_front();
+  }
+}
+
+bool PAPlayer::CancelPreload()
+{
+  /* drop the files that are waiting to be preloaded, and the one being preloaded right now */
+  CSingleLock lock(m_preloadLock);
+  bool cancelled = m_preloadBusy || !m_preloadQueue.empty();
+  while(!m_preloadQueue.empty())
+  {
+    delete m_preloadQueue.front();
+    m_preloadQueue.pop_front();
+  }
+  ++m_preloadGeneration;
+
+  return cancelled;
+}
+
+void PAPlayer::RestartPreload()
+{
+  if (!CancelPreload())
+    return;
+
+  /* have the next file requested again once the current stream gets to its preload point */
+  {
+    CExclusiveLock lock(m_streamsLock);
+    if (m_currentStream && !m_currentStream->m_playNextTriggered)
+    {
+      m_currentStream->m_prepareTriggered = false;
+      return;
+    }
+  }
+
+  /* nothing is going to ask for it anymore */
+  m_callback.OnQueueNextItem();
+}
+
+bool PAPlayer::IsPreloadCancelled(int generation)
+{
+  if (generation < 0)
+    return false;
+
+  CSingleLock lock(m_preloadLock);
+  return m_preloadStop || generation != m_preloadGeneration;
+}
+
 void PAPlayer::CloseAllStreams(bool fade/* = true */)
 {
+  CancelPreload();
+
   if (!fade) 
   {
     CExclusiveLock lock(m_streamsLock);    
@@ -184,30 +265,14 @@ void PAPlayer::CloseAllStreams(bool fade/* = true */)
     {
       StreamInfo* si = m_streams.front();
       m_streams.pop_front();
-      
-      if (si->m_stream)
-      {
-        CAEFactory::FreeStream(si->m_stream);
-        si->m_stream = NULL;
-      }
-
-      si->m_decoder.Destroy();
-      delete si;
+      FreeStream(si);
     }
 
     while(!m_finishing.empty())
     {
       StreamInfo* si = m_finishing.front();
       m_finishing.pop_front();
-
-      if (si->m_stream)
-      {
-        CAEFactory::FreeStream(si->m_stream);
-        si->m_stream = NULL;
-      }
-
-      si->m_decoder.Destroy();
-      delete si;
+      FreeStream(si);
     }
     m_currentStream = NULL;
   }
@@ -257,10 +322,100 @@ void PAPlayer::UpdateCrossFadingTime(const CFileItem& file)
 
 bool PAPlayer::QueueNextFile(const CFileItem &file)
 {
-  return QueueNextFileEx(file);
+  /* opening and decoding the start of the file can take a while on slow sources, so
+     it's done by the preload thread. it adds the stream once it has been pre-decoded */
+  {
+    CSingleLock lock(m_preloadLock);
+    m_preloadQueue.push_back(new CFileItem(file));
+  }
+
+  if (!m_preloadThread)
+  {
+    m_preloadStop   = false;
+    m_preloadThread = new CThread(this, "PAPlayer preload");
+    m_preloadThread->Create();
+  }
+  m_preloadEvent.Set();
+
+  return true;
+}
+
+void PAPlayer::Run()
+{
+  while(!m_preloadStop)
+  {
+    CFileItem *file = NULL;
+    int generation;
+    {
+      CSingleLock lock(m_preloadLock);
+      if (!m_preloadQueue.empty())
+      {
+        file = m_preloadQueue.front();
+        m_preloadQueue.pop_front();
+        m_preloadBusy = true;
+      }
+      generation = m_preloadGeneration;
+    }
+
+    if (!file)
+    {
+      m_preloadEvent.WaitMSec(1000);
+      continue;
+    }
+
+    /* the stream is handed over as soon as its AE stream is primed, the
+       player keeps decoding it from there like any other stream */
+    StreamInfo *si = OpenStream(*file, true, generation);
+    if (si)
+      PrepareStream(si, generation);
+
+    CSingleLock lock(m_preloadLock);
+    m_preloadBusy = false;
+    if (m_preloadStop || generation != m_preloadGeneration)
+    {
+      /* the preload was cancelled while this file was opened */
+      if (si)
+        FreeStream(si);
+    }
+    else if (si)
+    {
+      CExclusiveLock streamsLock(m_streamsLock);
+      SlaveStream(si);
+      m_streams.push_back(si);
+      *m_FileItem = *file;
+      CLog::Log(LOGDEBUG, "PAPlayer::Run - Preloaded %s", file->GetPath().c_str());
+    }
+    else
+    {
+      lock.Leave();
+      m_callback.OnQueueNextItem();
+    }
+
+    delete file;
+  }
 }
 
 bool PAPlayer::QueueNextFileEx(const CFileItem &file, bool fadeIn/* = true */)
+{
+  StreamInfo *si = OpenStream(file, fadeIn);
+  if (!si)
+  {
+    m_callback.OnQueueNextItem();
+    return false;
+  }
+
+  PrepareStream(si);
+
+  /* add the stream to the list */
+  CExclusiveLock lock(m_streamsLock);
+  m_streams.push_back(si);
+
+  *m_FileItem = file;
+
+  return true;
+}
+
+PAPlayer::StreamInfo* PAPlayer::OpenStream(const CFileItem &file, bool fadeIn, int generation/* = -1 */)
 {
   //set crossfade time for the file being queued
   UpdateCrossFadingTime(file);
@@ -269,11 +424,10 @@ bool PAPlayer::QueueNextFileEx(const CFileItem &file, bool fadeIn/* = true */)
 
   if (!si->m_decoder.Create(file, (file.m_lStartOffset * 1000) / 75))
   {
-    CLog::Log(LOGWARNING, "PAPlayer::QueueNextFileEx - Failed to create the decoder");
+    CLog::Log(LOGWARNING, "PAPlayer::OpenStream - Failed to create the decoder");
 
     delete si;
-    m_callback.OnQueueNextItem();
-    return false;
+    return NULL;
   }
 
   /* decode until there is data-available */
@@ -283,14 +437,20 @@ bool PAPlayer::QueueNextFileEx(const CFileItem &file, bool fadeIn/* = true */)
     int status = si->m_decoder.GetStatus();
     if (status == STATUS_ENDED   ||
         status == STATUS_NO_FILE ||
-        si->m_decoder.ReadSamples(PACKET_SIZE) == RET_ERROR)
+        si->m_decoder.ReadSamples(INPUT_SAMPLES) == RET_ERROR)
     {
-      CLog::Log(LOGINFO, "PAPlayer::QueueNextFileEx - Error reading samples");
+      CLog::Log(LOGINFO, "PAPlayer::OpenStream - Error reading samples");
 
       si->m_decoder.Destroy();
       delete si;
-      m_callback.OnQueueNextItem();
-      return false;
+      return NULL;
+    }
+
+    if (IsPreloadCancelled(generation))
+    {
+      si->m_decoder.Destroy();
+      delete si;
+      return NULL;
     }
 
     /* yield our time so that the main PAP thread doesnt stall */
@@ -310,6 +470,7 @@ bool PAPlayer::QueueNextFileEx(const CFileItem &file, bool fadeIn/* = true */)
   si->m_seekFrame          = -1;
   si->m_stream             = NULL;
   si->m_volume             = (fadeIn && m_crossFadeTime) ? 0.0f : 1.0f;
+  si->m_replayGain         = si->m_decoder.GetReplayGain();
   si->m_fadeOutTriggered   = false;
   si->m_isSlaved           = false;
 
@@ -317,8 +478,12 @@ bool PAPlayer::QueueNextFileEx(const CFileItem &file, bool fadeIn/* = true */)
   if (si->m_endOffset)
     streamTotalTime = si->m_endOffset - si->m_startOffset;
 
-  if (streamTotalTime >= TIME_TO_CACHE_NEXT_FILE + m_crossFadeTime)
-    si->m_prepareNextAtFrame = (int)((streamTotalTime - TIME_TO_CACHE_NEXT_FILE - m_crossFadeTime) * si->m_sampleRate / 1000.0f);
+  /* start preloading the next file early enough to have it pre-decoded before the crossfade */
+  int64_t preloadTime = g_advancedSettings.m_audioPreloadTimeMsec;
+  if (streamTotalTime >= preloadTime + m_crossFadeTime)
+    si->m_prepareNextAtFrame = (int)((streamTotalTime - preloadTime - m_crossFadeTime) * si->m_sampleRate / 1000.0f);
+  else
+    si->m_prepareNextAtFrame = 0;
 
   si->m_prepareTriggered = false;
 
@@ -329,18 +494,10 @@ bool PAPlayer::QueueNextFileEx(const CFileItem &file, bool fadeIn/* = true */)
 
   si->m_playNextTriggered = false;
 
-  PrepareStream(si);
-
-  /* add the stream to the list */
-  CExclusiveLock lock(m_streamsLock);
-  m_streams.push_back(si);
-
-  *m_FileItem = file;
-
-  return true;
+  return si;
 }
 
-inline bool PAPlayer::PrepareStream(StreamInfo *si)
+inline bool PAPlayer::PrepareStream(StreamInfo *si, int generation/* = -1 */)
 {
   /* if we have a stream we are already prepared */
   if (si->m_stream)
@@ -362,14 +519,14 @@ inline bool PAPlayer::PrepareStream(StreamInfo *si)
   }
 
   si->m_stream->SetVolume    (si->m_volume);
-  si->m_stream->SetReplayGain(si->m_decoder.GetReplayGain());
+  si->m_stream->SetReplayGain(si->m_replayGain);
 
-  /* if its not the first stream and crossfade is not enabled */
-  if (m_currentStream && m_currentStream != si && !m_crossFadeTime)
+  /* a preloaded stream is only slaved once it is handed over, the preload
+     can still be cancelled and the stream freed until then */
+  if (generation < 0)
   {
-    /* slave the stream for gapless */
-    si->m_isSlaved = true;
-    m_currentStream->m_stream->RegisterSlave(si->m_stream);
+    CSharedLock lock(m_streamsLock);
+    SlaveStream(si);
   }
 
   /* fill the stream's buffer */
@@ -378,7 +535,7 @@ inline bool PAPlayer::PrepareStream(StreamInfo *si)
     int status = si->m_decoder.GetStatus();
     if (status == STATUS_ENDED   ||
         status == STATUS_NO_FILE ||
-        si->m_decoder.ReadSamples(PACKET_SIZE) == RET_ERROR)
+        si->m_decoder.ReadSamples(INPUT_SAMPLES) == RET_ERROR)
     {
       CLog::Log(LOGINFO, "PAPlayer::PrepareStream - Stream Finished");
       break;
@@ -387,6 +544,9 @@ inline bool PAPlayer::PrepareStream(StreamInfo *si)
     if (!QueueData(si))
       break;
 
+    if (IsPreloadCancelled(generation))
+      return false;
+
     /* yield our time so that the main PAP thread doesnt stall */
     CThread::Sleep(1);
   }
@@ -396,8 +556,23 @@ inline bool PAPlayer::PrepareStream(StreamInfo *si)
   return true;
 }
 
+void PAPlayer::SlaveStream(StreamInfo *si)
+{
+  /* if its not the first stream and crossfade is not enabled */
+  if (m_crossFadeTime || !si->m_stream)
+    return;
+
+  if (m_currentStream && m_currentStream != si && m_currentStream->m_stream)
+  {
+    /* slave the stream for gapless */
+    si->m_isSlaved = true;
+    m_currentStream->m_stream->RegisterSlave(si->m_stream);
+  }
+}
+
 bool PAPlayer::CloseFile()
 {
+  StopPreload();
   m_callback.OnPlayBackStopped();
   return true;
 }
@@ -422,14 +597,16 @@ void PAPlayer::Process()
 
     double delay  = 100.0;
     double buffer = 100.0;
-    ProcessStreams(delay, buffer);
+    bool   active = ProcessStreams(delay, buffer);
 
     if (delay < buffer && delay > 0.75 * buffer)
       CThread::Sleep(MathUtils::round_int((buffer - delay) * 1000.0));
+    else if (!active)
+      CThread::Sleep(10); /* no stream is playing, eg. while the next file is still being preloaded */
   }
 }
 
-inline void PAPlayer::ProcessStreams(double &delay, double &buffer)
+inline bool PAPlayer::ProcessStreams(double &delay, double &buffer)
 {
   CSharedLock sharedLock(m_streamsLock);
   if (m_isFinished && m_streams.empty() && m_finishing.empty())
@@ -437,7 +614,7 @@ inline void PAPlayer::ProcessStreams(double &delay, double &buffer)
     m_isPlaying = false;
     delay       = 0;
     m_callback.OnPlayBackEnded();
-    return;
+    return false;
   }
 
   /* destroy any drained streams */
@@ -458,6 +635,8 @@ inline void PAPlayer::ProcessStreams(double &delay, double &buffer)
   sharedLock.Leave();
   CExclusiveLock lock(m_streamsLock);
 
+  /* if any stream is playing */
+  bool active = false;
   for(StreamList::iterator itt = m_streams.begin(); itt != m_streams.end(); ++itt)
   {
     StreamInfo* si = *itt;
@@ -499,11 +678,12 @@ inline void PAPlayer::ProcessStreams(double &delay, double &buffer)
       si->m_decoder.Destroy();      
       si->m_stream->Drain();
       m_finishing.push_back(si);
-      return;
+      return true;
     }
 
     if (!si->m_started)
       continue;
+    active = true;
 
     /* is it time to prepare the next stream? */
     if (si->m_prepareNextAtFrame > 0 && !si->m_prepareTriggered && si->m_framesSent >= si->m_prepareNextAtFrame)
@@ -537,6 +717,8 @@ inline void PAPlayer::ProcessStreams(double &delay, double &buffer)
       si->m_playNextTriggered = true;      
     }
   }
+
+  return active;
 }
 
 inline bool PAPlayer::ProcessStream(StreamInfo *si, double &delay, double &buffer)
@@ -591,7 +773,7 @@ inline bool PAPlayer::ProcessStream(StreamInfo *si, double &delay, double &buffe
   int status = si->m_decoder.GetStatus();
   if (status == STATUS_ENDED   ||
       status == STATUS_NO_FILE ||
-      si->m_decoder.ReadSamples(PACKET_SIZE) == RET_ERROR ||
+      si->m_decoder.ReadSamples(INPUT_SAMPLES) == RET_ERROR ||
       ((si->m_endOffset) && (si->m_framesSent / si->m_sampleRate >= (si->m_endOffset - si->m_startOffset) / 1000)))
   {
     CLog::Log(LOGINFO, "PAPlayer::ProcessStream - Stream Finished");
@@ -662,6 +844,12 @@ void PAPlayer::OnNothingToQueueNotify()
   m_isFinished = true;
 }
 
+void PAPlayer::OnPlayListChanged()
+{
+  /* the file being preloaded may no longer be the next one */
+  RestartPreload();
+}
+
 bool PAPlayer::IsPlaying() const
 {
   return m_isPlaying;
@@ -825,6 +1013,11 @@ void PAPlayer::SeekTime(int64_t iTime /*=0*/)
     ToFFRW(1);
 
   m_currentStream->m_seekFrame = (int)((float)m_currentStream->m_sampleRate * ((float)iTime + (float)m_currentStream->m_startOffset) / 1000.0f);
+  lock.Leave();
+
+  /* leave the source to the seek, the next file is requested again when playback gets to the preload point */
+  RestartPreload();
+
   m_callback.OnPlayBackSeek((int)iTime, seekOffset);
 }
 
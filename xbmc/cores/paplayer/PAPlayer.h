@@ -33,7 +33,7 @@
 #include "cores/AudioEngine/Interfaces/AEStream.h"
 
 class CFileItem;
-class PAPlayer : public IPlayer, public CThread
+class PAPlayer : public IPlayer, public CThread, public IRunnable
 {
 public:
   PAPlayer(IPlayerCallback& callback);
@@ -44,6 +44,7 @@ public:
   virtual bool OpenFile(const CFileItem& file, const CPlayerOptions &options);
   virtual bool QueueNextFile(const CFileItem &file);
   virtual void OnNothingToQueueNotify();
+  virtual void OnPlayListChanged();
   virtual bool CloseFile();
   virtual bool IsPlaying() const;
   virtual void Pause();
@@ -77,6 +78,7 @@ protected:
   virtual void OnStartup() {}
   virtual void Process();
   virtual void OnExit();
+  virtual void Run();
 
 private:
   typedef struct {
@@ -103,6 +105,7 @@ private:
 
     IAEStream*        m_stream;              /* the playback stream */
     float             m_volume;              /* the initial volume level to set the stream to on creation */
+    float             m_replayGain;          /* the replay gain of the stream */
 
     bool              m_isSlaved;            /* true if the stream has been slaved to another */
   } StreamInfo;
@@ -125,12 +128,27 @@ private:
   StreamList          m_streams;             /* playing streams */  
   StreamList          m_finishing;           /* finishing streams */
 
+  CCriticalSection    m_preloadLock;         /* lock for the preload queue */
+  std::list<CFileItem*> m_preloadQueue;      /* queued files waiting to be opened and pre-decoded */
+  int                 m_preloadGeneration;   /* incremented when the streams are closed or the preload is cancelled, invalidates running preloads */
+  bool                m_preloadBusy;         /* if the preload thread is working on a file */
+  CEvent              m_preloadEvent;        /* event for new files in the preload queue */
+  CThread*            m_preloadThread;       /* the thread opening and pre-decoding the queued files */
+  bool                m_preloadStop;         /* if the preload thread should exit */
+
   bool QueueNextFileEx(const CFileItem &file, bool fadeIn = true);
+  StreamInfo* OpenStream(const CFileItem &file, bool fadeIn, int generation = -1);
+  void FreeStream(StreamInfo *si);
+  void StopPreload();
+  bool CancelPreload();
+  void RestartPreload();
+  bool IsPreloadCancelled(int generation);
   void SoftStart(bool wait = false);
   void SoftStop(bool wait = false, bool close = true);
   void CloseAllStreams(bool fade = true);
-  void ProcessStreams(double &delay, double &buffer);
-  bool PrepareStream(StreamInfo *si);
+  bool ProcessStreams(double &delay, double &buffer);
+  bool PrepareStream(StreamInfo *si, int generation = -1);
+  void SlaveStream(StreamInfo *si); /* m_streamsLock must be held */
   bool ProcessStream(StreamInfo *si, double &delay, double &buffer);
   bool QueueData(StreamInfo *si);
   void UpdateCrossFadingTime(const CFileItem& file);
@@ -0,0 +1,100 @@
+/*
+ *      Copyright (C) 2012 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+ *  http://www.gnu.org/copyleft/gpl.html
+ *
+ */
+
+
+#include "DatabaseIdCache.h"
+#include "utils/log.h"
+
+CDatabaseIdCache::CDatabaseIdCache(const char *name, unsigned int maxSize)
+{
+  m_name = name;
+  m_maxSize = maxSize;
+  m_hits = 0;
+  m_misses = 0;
+}
+
+CDatabaseIdCache::~CDatabaseIdCache()
+{
+}
+
+bool CDatabaseIdCache::Get(const CStdString &key, int &id)
+{
+  LRUMap::iterator it = m_map.find(key);
+  if (it == m_map.end())
+  {
+    m_misses++;
+    return false;
+  }
+
+  // move to the front
+  m_list.splice(m_list.begin(), m_list, it->second);
+  id = it->second->second;
+  m_hits++;
+  return true;
+}
+
+void CDatabaseIdCache::Set(const CStdString &key, int id)
+{
+  if (id < 0)
+    return;
+
+  LRUMap::iterator it = m_map.find(key);
+  if (it != m_map.end())
+  {
+    it->second->second = id;
+    m_list.splice(m_list.begin(), m_list, it->second);
+    return;
+  }
+
+  m_list.push_front(std::make_pair(key, id));
+  m_map.insert(std::make_pair(key, m_list.begin()));
+
+  if (m_map.size() > m_maxSize)
+  {
+    m_map.erase(m_list.back().first);
+    m_list.pop_back();
+  }
+}
+
+void CDatabaseIdCache::Remove(int id)
+{
+  for (LRUList::iterator it = m_list.begin(); it != m_list.end(); )
+  {
+    if (it->second == id)
+    {
+      m_map.erase(it->first);
+      it = m_list.erase(it);
+    }
+    else
+      ++it;
+  }
+}
+
+void CDatabaseIdCache::Clear()
+{
+  if (m_hits + m_misses > 0)
+    CLog::Log(LOGDEBUG, "%s - %s: %u of %u lookups served from cache", __FUNCTION__, m_name, m_hits, m_hits + m_misses);
+
+  m_list.clear();
+  m_map.clear();
+  m_hits = 0;
+  m_misses = 0;
+}
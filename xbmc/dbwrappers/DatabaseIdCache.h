@@ -0,0 +1,82 @@
+#pragma once
+/*
+ *      Copyright (C) 2012 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+ *  http://www.gnu.org/copyleft/gpl.html
+ *
+ */
+
+
+#include "utils/StdString.h"
+
+#include <list>
+#include <map>
+
+/*!
+ \brief Bounded, most recently used cache mapping the name of a lookup table entry to its id.
+
+ Used by the library databases to avoid a select round trip each time an artist, genre,
+ path etc. is resolved to its id. The cache is write-through: callers insert ids as soon as
+ they are read or inserted, and must call Remove() or Clear() when rows are deleted.
+ */
+class CDatabaseIdCache
+{
+public:
+  /*!
+   \param name name of the cached table, only used for logging
+   \param maxSize maximum number of entries kept, least recently used ones are dropped first
+   */
+  CDatabaseIdCache(const char *name, unsigned int maxSize = 10000);
+  ~CDatabaseIdCache();
+
+  /*!
+   \brief Lookup the id of an entry
+   \param key the name of the entry
+   \param id [out] the id of the entry, if found
+   \return true if the entry was cached, false otherwise
+   */
+  bool Get(const CStdString &key, int &id);
+
+  /*!
+   \brief Add or update an entry
+   \param key the name of the entry
+   \param id the id of the entry
+   */
+  void Set(const CStdString &key, int id);
+
+  /*! \brief Drop the entry with the given id, if cached */
+  void Remove(int id);
+
+  /*! \brief Drop all entries, logging the hit rate since the last call */
+  void Clear();
+
+  bool Contains(const CStdString &key) const { return m_map.find(key) != m_map.end(); }
+  unsigned int Size() const { return m_map.size(); }
+  unsigned int GetHits() const { return m_hits; }
+  unsigned int GetMisses() const { return m_misses; }
+
+private:
+  typedef std::list< std::pair<CStdString, int> > LRUList;
+  typedef std::map<CStdString, LRUList::iterator> LRUMap;
+
+  const char  *m_name;
+  unsigned int m_maxSize;
+  LRUList      m_list;   // most recently used first
+  LRUMap       m_map;
+  unsigned int m_hits;
+  unsigned int m_misses;
+};
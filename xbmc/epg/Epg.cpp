@@ -48,7 +48,8 @@ CEpg::CEpg(int iEpgID, const CStdString &strName /* = "" */, const CStdString &s
     m_strName(strName),
     m_strScraperName(strScraperName),
     m_iPVRChannelId(-1),
-    m_iPVRChannelNumber(-1)
+    m_iPVRChannelNumber(-1),
+    m_iRevision(0)
 {
 }
 
@@ -61,7 +62,8 @@ CEpg::CEpg(CPVRChannel *channel, bool bLoadedFromDb /* = false */) :
     m_strName(channel->ChannelName()),
     m_strScraperName(channel->EPGScraper()),
     m_iPVRChannelId(channel->ChannelID()),
-    m_iPVRChannelNumber(channel->ChannelNumber())
+    m_iPVRChannelNumber(channel->ChannelNumber()),
+    m_iRevision(0)
 {
 }
 
@@ -74,7 +76,8 @@ CEpg::CEpg(void) :
     m_strName(StringUtils::EmptyString),
     m_strScraperName(StringUtils::EmptyString),
     m_iPVRChannelId(-1),
-    m_iPVRChannelNumber(-1)
+    m_iPVRChannelNumber(-1),
+    m_iRevision(0)
 {
 }
 
@@ -96,6 +99,7 @@ CEpg &CEpg::operator =(const CEpg &right)
   m_lastScanTime      = right.m_lastScanTime;
   m_iPVRChannelId     = right.m_iPVRChannelId;
   m_iPVRChannelNumber = right.m_iPVRChannelNumber;
+  ++m_iRevision;
 
   for (map<CDateTime, CEpgInfoTag *>::const_iterator it = right.m_tags.begin(); it != right.m_tags.end(); it++)
     m_tags.insert(make_pair(it->first, new CEpgInfoTag(*it->second)));
@@ -160,6 +164,7 @@ void CEpg::Clear(void)
   for (map<CDateTime, CEpgInfoTag *>::iterator it = m_tags.begin(); it != m_tags.end(); it++)
     delete it->second;
   m_tags.clear();
+  ++m_iRevision;
 }
 
 void CEpg::Cleanup(void)
@@ -185,6 +190,9 @@ void CEpg::Cleanup(const CDateTime &Time)
       bTagsChanged = true;
     }
   }
+
+  if (bTagsChanged)
+    ++m_iRevision;
 }
 
 bool CEpg::InfoTagNow(CEpgInfoTag &tag, bool bUpdateIfNeeded /* = true */)
@@ -292,14 +300,22 @@ const CEpgInfoTag *CEpg::GetTagBetween(const CDateTime &beginTime, const CDateTi
 
   CSingleLock lock(m_critSection);
 
-  for (map<CDateTime, CEpgInfoTag *>::const_iterator it = m_tags.begin(); it != m_tags.end(); it++)
+  /* tags don't overlap, so start and end times are both in map order. FixOverlappingEvents() can move the start
+     time of a tag away from its key, so correct the position by looking at the neighbours */
+  map<CDateTime, CEpgInfoTag *>::const_iterator it = m_tags.lower_bound(beginTime);
+  while (it != m_tags.begin())
   {
-    if (it->second->StartAsUTC() >= beginTime && it->second->EndAsUTC() <= endTime)
-    {
-      returnTag = it->second;
+    map<CDateTime, CEpgInfoTag *>::const_iterator previous = it;
+    if ((--previous)->second->StartAsUTC() < beginTime)
       break;
-    }
+    it = previous;
   }
+  while (it != m_tags.end() && it->second->StartAsUTC() < beginTime)
+    it++;
+
+  /* the first tag that starts after beginTime is also the first one to end */
+  if (it != m_tags.end() && it->second->EndAsUTC() <= endTime)
+    returnTag = it->second;
 
   return returnTag;
 }
@@ -310,15 +326,19 @@ const CEpgInfoTag *CEpg::GetTagAround(const CDateTime &time) const
 
   CSingleLock lock(m_critSection);
 
-  for (map<CDateTime, CEpgInfoTag *>::const_iterator it = m_tags.begin(); it != m_tags.end(); it++)
+  /* find the first tag that hasn't ended at the given time */
+  map<CDateTime, CEpgInfoTag *>::const_iterator it = m_tags.upper_bound(time);
+  while (it != m_tags.begin())
   {
-    if ((it->second->StartAsUTC() <= time) && (it->second->EndAsUTC() >= time))
-    {
-      returnTag = it->second;
+    map<CDateTime, CEpgInfoTag *>::const_iterator previous = it;
+    if ((--previous)->second->EndAsUTC() < time)
       break;
-    }
+    it = previous;
   }
 
+  if (it != m_tags.end() && it->second->StartAsUTC() <= time && it->second->EndAsUTC() >= time)
+    returnTag = it->second;
+
   return returnTag;
 }
 
@@ -336,6 +356,7 @@ void CEpg::AddEntry(const CEpgInfoTag &tag)
       newTag = new CEpgInfoTag(this, m_iPVRChannelNumber, m_iPVRChannelId, m_strName, channel ? channel->IconPath() : StringUtils::EmptyString);
       m_tags.insert(make_pair(tag.StartAsUTC(), newTag));
     }
+    ++m_iRevision;
   }
 
   if (newTag)
@@ -346,6 +367,7 @@ void CEpg::AddEntry(const CEpgInfoTag &tag)
     newTag->m_iPVRChannelID     = m_iPVRChannelId;
     newTag->m_strTableName      = m_strName;
     newTag->m_bChanged          = false;
+    newTag->m_iPersistedHash    = newTag->ContentHash();
   }
 }
 
@@ -376,9 +398,10 @@ bool CEpg::UpdateEntry(const CEpgInfoTag &tag, bool bUpdateDatabase /* = false *
   infoTag->m_iPVRChannelNumber = m_iPVRChannelNumber;
   infoTag->m_iPVRChannelID     = m_iPVRChannelId;
   infoTag->m_strTableName      = m_strName;
+  ++m_iRevision;
 
   if (bUpdateDatabase)
-    bReturn = infoTag->Persist();
+    bReturn = infoTag->Persist(false);
   else
     bReturn = true;
 
@@ -396,8 +419,11 @@ bool CEpg::Load(void)
     return bReturn;
   }
 
-  CSingleLock lock(m_critSection);
+  /* the tags are added without holding the table lock: the database waits
+     for its writer first, which takes it to confirm the tags it wrote */
   int iEntriesLoaded = database->Get(*this);
+
+  CSingleLock lock(m_critSection);
   if (iEntriesLoaded <= 0)
   {
     CLog::Log(LOGNOTICE, "Epg - %s - no database entries found for table '%s'.",
@@ -432,12 +458,11 @@ bool CEpg::UpdateEntries(const CEpg &epg, bool bStoreInDb /* = true */)
         CLog::Log(LOGERROR, "%s - could not open the database", __FUNCTION__);
         return bReturn;
       }
-      database->BeginTransaction();
     }
     CLog::Log(LOGDEBUG, "%s - %u entries in memory before merging", __FUNCTION__, m_tags.size());
-    /* copy over tags */
+    /* copy over tags. they're persisted after fixing, so tags that are moved are only written once */
     for (map<CDateTime, CEpgInfoTag *>::const_iterator it = epg.m_tags.begin(); it != epg.m_tags.end(); it++)
-      UpdateEntry(*it->second, bStoreInDb, false);
+      UpdateEntry(*it->second, false, false);
 
     CLog::Log(LOGDEBUG, "%s - %u entries in memory after merging and before fixing", __FUNCTION__, m_tags.size());
     FixOverlappingEvents(bStoreInDb);
@@ -446,10 +471,21 @@ bool CEpg::UpdateEntries(const CEpg &epg, bool bStoreInDb /* = true */)
     m_lastScanTime = CDateTime::GetCurrentDateTime().GetAsUTCDateTime();
 
     //m_bTagsChanged = true;
-    /* persist changes */
+    /* persist changes. unchanged tags are skipped and the writes are queued for the database writer */
     if (bStoreInDb)
     {
-      bReturn = database->CommitTransaction();
+      bReturn = true;
+      unsigned int iQueued(0);
+      for (map<CDateTime, CEpgInfoTag *>::const_iterator it = m_tags.begin(); it != m_tags.end(); it++)
+      {
+        if (!it->second->Changed())
+          continue;
+
+        bReturn &= it->second->Persist(false);
+        ++iQueued;
+      }
+      CLog::Log(LOGDEBUG, "%s - %u changed entries queued for table '%s'", __FUNCTION__, iQueued, m_strName.c_str());
+
       if (bReturn)
         Persist(true);
     }
@@ -588,6 +624,12 @@ int CEpg::Get(CFileItemList &results, const EpgSearchFilter &filter) const
   return results.Size() - iInitialSize;
 }
 
+unsigned int CEpg::Revision(void) const
+{
+  CSingleLock lock(m_critSection);
+  return m_iRevision;
+}
+
 bool CEpg::Persist(bool bUpdateLastScanTime /* = false */)
 {
   if (g_guiSettings.GetBool("epg.ignoredbforclient"))
@@ -601,16 +643,18 @@ bool CEpg::Persist(bool bUpdateLastScanTime /* = false */)
     return false;
   }
 
+  /* only the table itself is written here, so don't copy the tags */
   CEpg epgCopy;
   {
     CSingleLock lock(m_critSection);
-    epgCopy = *this;
+    epgCopy.m_iEpgID         = m_iEpgID;
+    epgCopy.m_strName        = m_strName;
+    epgCopy.m_strScraperName = m_strScraperName;
+    epgCopy.m_bChanged       = m_bChanged;
     m_bChanged     = false;
     m_bTagsChanged = false;
   }
 
-  database->BeginTransaction();
-
   if (epgCopy.m_iEpgID <= 0 || epgCopy.m_bChanged)
   {
     int iId = database->Persist(epgCopy);
@@ -629,9 +673,7 @@ bool CEpg::Persist(bool bUpdateLastScanTime /* = false */)
   bool bReturn(true);
 
   if (bUpdateLastScanTime)
-    bReturn = database->PersistLastEpgScanTime(epgCopy.m_iEpgID);
-
-  database->CommitTransaction();
+    bReturn = database->PersistLastEpgScanTime(epgCopy.m_iEpgID, true);
 
   return bReturn;
 }
@@ -681,6 +723,7 @@ bool CEpg::UpdateMetadata(const CEpg &epg, bool bUpdateDb /* = false */)
       it->second->SetPVRChannelID(m_iPVRChannelId);
       it->second->SetPVRChannelNumber(m_iPVRChannelNumber);
     }
+    ++m_iRevision;
   }
 
   if (bUpdateDb)
@@ -709,6 +752,7 @@ bool CEpg::FixOverlappingEvents(bool bUpdateDb /* = false */)
     }
   }
 
+  ++m_iRevision;
   for (map<CDateTime, CEpgInfoTag *>::iterator it = m_tags.begin(); it != m_tags.end(); it != m_tags.end() ? it++ : it)
   {
     if (!previousTag)
@@ -734,7 +778,7 @@ bool CEpg::FixOverlappingEvents(bool bUpdateDb /* = false */)
     {
       currentTag->SetStartFromUTC(previousTag->EndAsUTC());
       if (bUpdateDb)
-        bReturn &= currentTag->Persist();
+        bReturn &= currentTag->Persist(false);
 
       previousTag = it->second;
     }
@@ -754,8 +798,8 @@ bool CEpg::FixOverlappingEvents(bool bUpdateDb /* = false */)
 
       if (bUpdateDb)
       {
-        bReturn &= currentTag->Persist();
-        bReturn &= previousTag->Persist();
+        bReturn &= currentTag->Persist(false);
+        bReturn &= previousTag->Persist(false);
       }
 
       previousTag = it->second;
@@ -801,6 +845,17 @@ bool CEpg::UpdateFromScraper(time_t start, time_t end)
   return bGrabSuccess;
 }
 
+void CEpg::OnTagsPersisted(const map<int, unsigned int> &tags, bool bSuccess)
+{
+  CSingleLock lock(m_critSection);
+  for (map<CDateTime, CEpgInfoTag *>::iterator it = m_tags.begin(); it != m_tags.end(); it++)
+  {
+    map<int, unsigned int>::const_iterator written = tags.find(it->second->BroadcastId());
+    if (written != tags.end())
+      it->second->OnPersisted(written->second, bSuccess);
+  }
+}
+
 bool CEpg::PersistTags(void) const
 {
   bool bReturn = false;
@@ -826,7 +881,7 @@ bool CEpg::PersistTags(void) const
   {
     for (map<CDateTime, CEpgInfoTag *>::const_iterator it = m_tags.begin(); it != m_tags.end(); it++)
     {
-      if (!it->second->Persist())
+      if (!it->second->Persist(false))
       {
         CLog::Log(LOGERROR, "failed to persist epg tag %d", it->second->UniqueBroadcastID());
         bReturn = false;
@@ -989,6 +1044,7 @@ void CEpg::SetChannel(PVR::CPVRChannel *channel)
     it->second->m_iPVRChannelID     = m_iPVRChannelId;
     it->second->m_iPVRChannelNumber = m_iPVRChannelNumber;
   }
+  ++m_iRevision;
 }
 
 bool CEpg::HasPVRChannel(void) const
@@ -40,6 +40,7 @@ namespace EPG
   class CEpg : public Observable
   {
     friend class CEpgDatabase;
+    friend class CEpgSearchIndex;
 
   public:
     /*!
@@ -243,6 +244,11 @@ namespace EPG
      */
     virtual int Get(CFileItemList &results, const EpgSearchFilter &filter) const;
 
+    /*!
+     * @return The revision of the tags in this table. Changes each time a tag is added, changed or removed.
+     */
+    unsigned int Revision(void) const;
+
     /*!
      * @brief Persist this table in the database.
      * @param bUpdateLastScanTime True to update the last scan time in the db, false otherwise.
@@ -298,6 +304,13 @@ namespace EPG
 
     virtual size_t Size(void) const { return m_tags.size(); }
 
+    /*!
+     * @brief Called when queued writes of tags in this table were executed.
+     * @param tags The content hashes of the tags that were written, by database ID.
+     * @param bSuccess True if the tags were written successfully, false otherwise.
+     */
+    void OnTagsPersisted(const std::map<int, unsigned int> &tags, bool bSuccess);
+
   protected:
     CEpg(void);
 
@@ -362,6 +375,8 @@ namespace EPG
     int                        m_iPVRChannelId;   /*!< the channel this EPG belongs to */
     int                        m_iPVRChannelNumber; /*!< the channel number in the "all channels" group. set on create and not updated */
 
+    unsigned int               m_iRevision;       /*!< incremented each time the tags in this table change */
+
     CCriticalSection           m_critSection;     /*!< critical section for changes in this table */
   };
 }
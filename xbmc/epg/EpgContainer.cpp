@@ -21,6 +21,7 @@
 
 #include "Application.h"
 #include "threads/SingleLock.h"
+#include "threads/SystemClock.h"
 #include "settings/AdvancedSettings.h"
 #include "settings/GUISettings.h"
 #include "dialogs/GUIDialogExtendedProgressBar.h"
@@ -99,6 +100,7 @@ void CEpgContainer::Clear(bool bClearDb /* = false */)
     for (map<unsigned int, CEpg *>::iterator it = m_epgs.begin(); it != m_epgs.end(); it++)
       delete it->second;
     m_epgs.clear();
+    m_searchIndex.reset();
     m_iNextEpgUpdate  = 0;
     m_bIsInitialising = true;
   }
@@ -129,6 +131,7 @@ void CEpgContainer::Start(void)
   m_iNextEpgUpdate  = 0;
   m_iNextEpgActiveTagCheck = 0;
 
+  m_database.StartWriter();
   Create();
   SetPriority(-1);
   CLog::Log(LOGNOTICE, "%s - EPG thread started", __FUNCTION__);
@@ -137,6 +140,7 @@ void CEpgContainer::Start(void)
 bool CEpgContainer::Stop(void)
 {
   StopThread();
+  m_database.StopWriter();
   return true;
 }
 
@@ -176,6 +180,15 @@ void CEpgContainer::LoadFromDB(void)
   m_bLoaded = bLoaded;
 }
 
+void CEpgContainer::OnTagsPersisted(int iEpgId, const map<int, unsigned int> &tags, bool bSuccess)
+{
+  /* hold the lock, so the table can't be deleted in the meantime */
+  CSingleLock lock(m_critSection);
+  CEpg *epg = GetById(iEpgId);
+  if (epg)
+    epg->OnTagsPersisted(tags, bSuccess);
+}
+
 bool CEpgContainer::PersistTables(void)
 {
   return m_database.Persist(*this);
@@ -576,12 +589,28 @@ int CEpgContainer::GetEPGSearch(CFileItemList &results, const EpgSearchFilter &f
 {
   int iInitialSize = results.Size();
 
-  /* get filtered results from all tables */
+  /* get filtered results from a snapshot of all tables, so updates aren't blocked while searching */
+  boost::shared_ptr<CEpgSearchIndex> index = GetSearchIndex();
+  vector<EpgSearchResult> matches;
+  index->Search(matches, filter);
+
+  /* only the tags that matched are looked up again. ones that were removed in the meantime are skipped */
+  CSingleLock lock(m_critSection);
+  for (vector<EpgSearchResult>::const_iterator it = matches.begin(); it != matches.end(); it++)
   {
-    CSingleLock lock(m_critSection);
-    for (map<unsigned int, CEpg *>::iterator it = m_epgs.begin(); it != m_epgs.end(); it++)
-      it->second->Get(results, filter);
+    const CEpg *epg = GetById(it->iEpgID);
+    const CEpgInfoTag *tag = epg ? epg->GetTag(0, it->startTime) : NULL;
+    if (!tag)
+      continue;
+
+    CDateTime localStartTime;
+    localStartTime.SetFromUTCDateTime(tag->StartAsUTC());
+
+    CFileItemPtr entry(new CFileItem(*tag));
+    entry->SetLabel2(localStartTime.GetAsLocalizedDateTime(false, false));
+    results.Add(entry);
   }
+  lock.Leave();
 
   /* remove duplicate entries */
   if (filter.m_bPreventRepeats)
@@ -590,6 +619,35 @@ int CEpgContainer::GetEPGSearch(CFileItemList &results, const EpgSearchFilter &f
   return results.Size() - iInitialSize;
 }
 
+boost::shared_ptr<CEpgSearchIndex> CEpgContainer::GetSearchIndex(void)
+{
+  boost::shared_ptr<CEpgSearchIndex> index(new CEpgSearchIndex);
+  {
+    CSingleLock lock(m_critSection);
+
+    map<int, unsigned int> revisions;
+    for (map<unsigned int, CEpg *>::const_iterator it = m_epgs.begin(); it != m_epgs.end(); it++)
+      revisions.insert(make_pair(it->second->EpgID(), it->second->Revision()));
+
+    if (m_searchIndex && m_searchIndex->IsCurrent(revisions))
+      return m_searchIndex;
+
+    /* only the searchable fields of the tables that changed are copied while holding the lock. the indexes are
+       created afterwards, unchanged tables are shared with the previous index */
+    for (map<unsigned int, CEpg *>::const_iterator it = m_epgs.begin(); it != m_epgs.end(); it++)
+      index->AddTable(*it->second, m_searchIndex.get());
+  }
+
+  unsigned int iStart = XbmcThreads::SystemClockMillis();
+  index->Build();
+  CLog::Log(LOGDEBUG, "%s - indexed %u tags in %u ms", __FUNCTION__, (unsigned int) index->Size(), XbmcThreads::SystemClockMillis() - iStart);
+
+  CSingleLock lock(m_critSection);
+  m_searchIndex = index;
+
+  return index;
+}
+
 bool CEpgContainer::CheckPlayingEvents(void)
 {
   bool bReturn(false);
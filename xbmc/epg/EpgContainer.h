@@ -28,8 +28,10 @@
 
 #include "Epg.h"
 #include "EpgDatabase.h"
+#include "EpgSearchIndex.h"
 
 #include <map>
+#include "boost/shared_ptr.hpp"
 
 class CFileItemList;
 class CGUIDialogExtendedProgressBar;
@@ -158,6 +160,12 @@ namespace EPG
      */
     virtual bool CheckPlayingEvents(void);
 
+    /*!
+     * @brief Get the search index, and rebuild it first if any of the tables changed since it was built.
+     * @return The search index.
+     */
+    virtual boost::shared_ptr<CEpgSearchIndex> GetSearchIndex(void);
+
     /*!
      * @brief The next EPG ID to be given to a table when the db isn't being used.
      * @return The next ID.
@@ -266,6 +274,14 @@ namespace EPG
      */
     void LoadFromDB(void);
 
+    /*!
+     * @brief Called by the database writer when queued tag writes were executed.
+     * @param iEpgId The table the tags belong to.
+     * @param tags The content hashes of the tags that were written, by database ID.
+     * @param bSuccess True if the tags were written successfully, false otherwise.
+     */
+    void OnTagsPersisted(int iEpgId, const std::map<int, unsigned int> &tags, bool bSuccess);
+
     CEpgDatabase m_database;           /*!< the EPG database */
 
     /** @name Configuration */
@@ -287,6 +303,7 @@ namespace EPG
     time_t       m_iNextEpgActiveTagCheck; /*!< the time the EPG will be checked for active tag updates */
     unsigned int m_iNextEpgId;             /*!< the next epg ID that will be given to a new table when the db isn't being used */
     std::map<unsigned int, CEpg*> m_epgs;  /*!< the EPGs in this container */
+    boost::shared_ptr<CEpgSearchIndex> m_searchIndex; /*!< snapshot of all tables that searches are run against */
     //@}
 
     CGUIDialogExtendedProgressBar *m_progressDialog; /*!< the progress dialog that is visible when updating the first time */
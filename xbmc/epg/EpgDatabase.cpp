@@ -33,10 +33,175 @@ using namespace std;
 using namespace dbiplus;
 using namespace EPG;
 
+#define EPG_DB_WRITE_BATCH_SIZE 500 /* maximum amount of queries per transaction */
+#define EPG_DB_WRITE_INTERVAL   250 /* milliseconds between two transactions of the background writer */
+
+CEpgDatabase::CEpgDatabase(void) :
+    CThread("EPG database writer"),
+    m_iWriting(0),
+    m_bWriterRunning(false),
+    m_bFlush(false),
+    m_iLastBroadcastId(0)
+{
+}
+
+CEpgDatabase::~CEpgDatabase(void)
+{
+  StopThread();
+}
+
 bool CEpgDatabase::Open(void)
 {
   CSingleLock lock(m_critSection);
-  return CDatabase::Open(g_advancedSettings.m_databaseEpg);
+  if (!CDatabase::Open(g_advancedSettings.m_databaseEpg))
+    return false;
+
+  /* new tags get their ID before they're written, so queued writes can be matched to them */
+  CSingleLock writeLock(m_writeLock);
+  m_iLastBroadcastId = atoi(GetSingleValue("epgtags", "MAX(idBroadcast)").c_str());
+
+  return true;
+}
+
+void CEpgDatabase::StartWriter(void)
+{
+  CSingleLock lock(m_writeLock);
+  if (m_bWriterRunning)
+    return;
+
+  m_bWriterRunning = true;
+  m_bStop = false;
+  Create();
+}
+
+void CEpgDatabase::StopWriter(void)
+{
+  StopThread();
+
+  {
+    CSingleLock lock(m_writeLock);
+    m_bWriterRunning = false;
+  }
+
+  /* write what's left */
+  while (ExecuteWrites(EPG_DB_WRITE_BATCH_SIZE) > 0) {}
+}
+
+bool CEpgDatabase::Enqueue(const CEpgWrite &write)
+{
+  {
+    CSingleLock lock(m_writeLock);
+    if (!m_bWriterRunning)
+      return false;
+
+    m_writeQueue.push_back(write);
+  }
+  m_writeEvent.Set();
+
+  return true;
+}
+
+bool CEpgDatabase::QueueWrite(const CStdString &strQuery)
+{
+  if (strQuery.IsEmpty())
+    return false;
+
+  CEpgWrite write;
+  write.strQuery     = strQuery;
+  write.iEpgId       = -1;
+  write.iBroadcastId = -1;
+  write.iHash        = 0;
+  if (Enqueue(write))
+    return true;
+
+  CSingleLock lock(m_critSection);
+  return ExecuteQuery(strQuery);
+}
+
+void CEpgDatabase::WaitForWrites(void)
+{
+  CSingleLock lock(m_writeLock);
+  while (m_bWriterRunning && (!m_writeQueue.empty() || m_iWriting > 0))
+  {
+    m_bFlush = true;
+    m_flushEvent.Set();
+    m_writeEvent.Set();
+
+    CSingleExit exit(m_writeLock);
+    m_writtenEvent.WaitMSec(100);
+  }
+}
+
+unsigned int CEpgDatabase::ExecuteWrites(unsigned int iMaxQueries)
+{
+  vector<CEpgWrite> writes;
+  vector<bool> results;
+  {
+    /* hold the database lock while taking queries off the queue, so they're executed in the order they were queued */
+    CSingleLock lock(m_critSection);
+    {
+      CSingleLock writeLock(m_writeLock);
+      while (!m_writeQueue.empty() && writes.size() < iMaxQueries)
+      {
+        writes.push_back(m_writeQueue.front());
+        m_writeQueue.pop_front();
+      }
+      m_iWriting = writes.size();
+      if (m_writeQueue.empty())
+        m_bFlush = false;
+    }
+
+    if (writes.empty())
+      return 0;
+
+    BeginTransaction();
+    for (vector<CEpgWrite>::const_iterator it = writes.begin(); it != writes.end(); it++)
+      results.push_back(ExecuteQuery(it->strQuery));
+
+    if (!CommitTransaction())
+    {
+      CLog::Log(LOGERROR, "EpgDB - %s - failed to commit %u queries", __FUNCTION__, (unsigned int) writes.size());
+      results.assign(writes.size(), false);
+    }
+  }
+
+  /* tags keep their changed flag until their write is confirmed, so failed writes are retried on the next persist */
+  map<int, map<int, unsigned int> > written, failed;
+  for (unsigned int iPtr = 0; iPtr < writes.size(); iPtr++)
+  {
+    if (writes[iPtr].iBroadcastId > 0)
+      (results[iPtr] ? written : failed)[writes[iPtr].iEpgId][writes[iPtr].iBroadcastId] = writes[iPtr].iHash;
+  }
+  for (map<int, map<int, unsigned int> >::const_iterator it = written.begin(); it != written.end(); it++)
+    g_EpgContainer.OnTagsPersisted(it->first, it->second, true);
+  for (map<int, map<int, unsigned int> >::const_iterator it = failed.begin(); it != failed.end(); it++)
+    g_EpgContainer.OnTagsPersisted(it->first, it->second, false);
+
+  if (!failed.empty())
+    CLog::Log(LOGERROR, "EpgDB - %s - not all queued changes could be written", __FUNCTION__);
+
+  {
+    CSingleLock writeLock(m_writeLock);
+    m_iWriting = 0;
+  }
+  m_writtenEvent.Set();
+
+  return writes.size();
+}
+
+void CEpgDatabase::Process(void)
+{
+  while (!m_bStop)
+  {
+    m_writeEvent.WaitMSec(1000);
+
+    /* pause between batches, so a full guide update doesn't keep the database locked */
+    while (!m_bStop && ExecuteWrites(EPG_DB_WRITE_BATCH_SIZE) > 0)
+    {
+      if (!m_bFlush)
+        m_flushEvent.WaitMSec(EPG_DB_WRITE_INTERVAL);
+    }
+  }
 }
 
 bool CEpgDatabase::CreateTables(void)
@@ -158,6 +323,12 @@ bool CEpgDatabase::DeleteEpg(void)
   CSingleLock lock(m_critSection);
   CLog::Log(LOGDEBUG, "EpgDB - %s - deleting all EPG data from the database", __FUNCTION__);
 
+  /* queued changes would be removed anyway */
+  {
+    CSingleLock writeLock(m_writeLock);
+    m_writeQueue.clear();
+  }
+
   bReturn = DeleteValues("epg") || bReturn;
   bReturn = DeleteValues("epgtags") || bReturn;
   bReturn = DeleteValues("lastepgscan") || bReturn;
@@ -184,8 +355,7 @@ bool CEpgDatabase::Delete(const CEpg &table, const time_t start /* = 0 */, const
   if (end != 0)
     strWhereClause.append(FormatSQL(" AND iEndTime <= %u", end).c_str());
 
-  CSingleLock lock(m_critSection);
-  return DeleteValues("epgtags", strWhereClause);
+  return QueueWrite("DELETE FROM epgtags WHERE " + strWhereClause);
 }
 
 bool CEpgDatabase::DeleteOldEpgEntries(void)
@@ -197,6 +367,8 @@ bool CEpgDatabase::DeleteOldEpgEntries(void)
 
   CStdString strWhereClause = FormatSQL("iEndTime < %u", iCleanupTime);
 
+  WaitForWrites();
+
   CSingleLock lock(m_critSection);
   return DeleteValues("epgtags", strWhereClause);
 }
@@ -208,14 +380,13 @@ bool CEpgDatabase::Delete(const CEpgInfoTag &tag)
     return false;
 
   CStdString strWhereClause = FormatSQL("idBroadcast = %u", tag.BroadcastId());
-
-  CSingleLock lock(m_critSection);
-  return DeleteValues("epgtags", strWhereClause);
+  return QueueWrite("DELETE FROM epgtags WHERE " + strWhereClause);
 }
 
 int CEpgDatabase::Get(CEpgContainer &container)
 {
   int iReturn(-1);
+  WaitForWrites();
   CSingleLock lock(m_critSection);
 
   CStdString strQuery = FormatSQL("SELECT idEpg, sName, sScraperName FROM epg;");
@@ -261,6 +432,7 @@ int CEpgDatabase::Get(CEpgContainer &container)
 int CEpgDatabase::Get(CEpg &epg)
 {
   int iReturn(-1);
+  WaitForWrites();
   CSingleLock lock(m_critSection);
 
   CStdString strQuery = FormatSQL("SELECT * FROM epgtags WHERE idEpg = %u;", epg.EpgID());
@@ -342,8 +514,11 @@ bool CEpgDatabase::PersistLastEpgScanTime(int iEpgId /* = 0 */, bool bQueueWrite
   CStdString strQuery = FormatSQL("REPLACE INTO lastepgscan(idEpg, sLastScan) VALUES (%u, '%s');",
       iEpgId, CDateTime::GetCurrentDateTime().GetAsUTCDateTime().GetAsDBDateTime().c_str());
 
+  if (bQueueWrite)
+    return QueueWrite(strQuery);
+
   CSingleLock lock(m_critSection);
-  return bQueueWrite ? QueueInsertQuery(strQuery) : ExecuteQuery(strQuery);
+  return ExecuteQuery(strQuery);
 }
 
 bool CEpgDatabase::Persist(const CEpgContainer &epg)
@@ -355,7 +530,7 @@ bool CEpgDatabase::Persist(const CEpgContainer &epg)
       Persist(*epg, true);
   }
 
-  return CommitInsertQueries();
+  return true;
 }
 
 int CEpgDatabase::Persist(const CEpg &epg, bool bQueueWrite /* = false */)
@@ -370,14 +545,14 @@ int CEpgDatabase::Persist(const CEpg &epg, bool bQueueWrite /* = false */)
     strQuery = FormatSQL("INSERT INTO epg (sName, sScraperName) "
         "VALUES ('%s', '%s');", epg.Name().c_str(), epg.ScraperName().c_str());
 
-  CSingleLock lock(m_critSection);
   if (bQueueWrite)
   {
-    if (QueueInsertQuery(strQuery))
+    if (QueueWrite(strQuery))
       iReturn = epg.EpgID() <= 0 ? 0 : epg.EpgID();
   }
   else
   {
+    CSingleLock lock(m_critSection);
     if (ExecuteQuery(strQuery))
       iReturn = epg.EpgID() <= 0 ? (int) m_pDS->lastinsertid() : epg.EpgID();
   }
@@ -385,7 +560,7 @@ int CEpgDatabase::Persist(const CEpg &epg, bool bQueueWrite /* = false */)
   return iReturn;
 }
 
-int CEpgDatabase::Persist(const CEpgInfoTag &tag, bool bSingleUpdate /* = true */)
+int CEpgDatabase::Persist(const CEpgInfoTag &tag, unsigned int iHash, bool bSingleUpdate, bool &bQueued)
 {
   int iReturn(-1);
 
@@ -401,48 +576,49 @@ int CEpgDatabase::Persist(const CEpgInfoTag &tag, bool bSingleUpdate /* = true *
   tag.FirstAiredAsUTC().GetAsTime(iFirstAired);
 
   int iBroadcastId = tag.BroadcastId();
-  CSingleLock lock(m_critSection);
   CStdString strQuery;
   
   /* Only store the genre string when needed */
   CStdString strGenre = (tag.GenreType() == EPG_GENRE_USE_STRING) ? StringUtils::Join(tag.Genre(), g_advancedSettings.m_videoItemSeparator) : "";
 
-  if (iBroadcastId < 0)
+  /* tags that weren't persisted before get their ID here, so a queued write can be matched to them */
+  if (iBroadcastId <= 0)
   {
-    strQuery = FormatSQL("INSERT INTO epgtags (idEpg, iStartTime, "
-        "iEndTime, sTitle, sPlotOutline, sPlot, iGenreType, iGenreSubType, sGenre, "
-        "iFirstAired, iParentalRating, iStarRating, bNotify, iSeriesId, "
-        "iEpisodeId, iEpisodePart, sEpisodeName, iBroadcastUid) "
-        "VALUES (%u, %u, %u, '%s', '%s', '%s', %i, %i, '%s', %u, %i, %i, %i, %i, %i, %i, '%s', %i);",
-        tag.EpgID(), iStartTime, iEndTime,
-        tag.Title(true).c_str(), tag.PlotOutline(true).c_str(), tag.Plot(true).c_str(), tag.GenreType(), tag.GenreSubType(), strGenre.c_str(),
-        iFirstAired, tag.ParentalRating(), tag.StarRating(), tag.Notify(),
-        tag.SeriesNum(), tag.EpisodeNum(), tag.EpisodePart(), tag.EpisodeName().c_str(),
-        tag.UniqueBroadcastID());
+    CSingleLock lock(m_writeLock);
+    iBroadcastId = ++m_iLastBroadcastId;
   }
-  else
+
+  strQuery = FormatSQL("REPLACE INTO epgtags (idEpg, iStartTime, "
+      "iEndTime, sTitle, sPlotOutline, sPlot, iGenreType, iGenreSubType, sGenre, "
+      "iFirstAired, iParentalRating, iStarRating, bNotify, iSeriesId, "
+      "iEpisodeId, iEpisodePart, sEpisodeName, iBroadcastUid, idBroadcast) "
+      "VALUES (%u, %u, %u, '%s', '%s', '%s', %i, %i, '%s', %u, %i, %i, %i, %i, %i, %i, '%s', %i, %i);",
+      tag.EpgID(), iStartTime, iEndTime,
+      tag.Title(true).c_str(), tag.PlotOutline(true).c_str(), tag.Plot(true).c_str(), tag.GenreType(), tag.GenreSubType(), strGenre.c_str(),
+      iFirstAired, tag.ParentalRating(), tag.StarRating(), tag.Notify(),
+      tag.SeriesNum(), tag.EpisodeNum(), tag.EpisodePart(), tag.EpisodeName().c_str(),
+      tag.UniqueBroadcastID(), iBroadcastId);
+
+  bQueued = false;
+  if (!bSingleUpdate)
   {
-    strQuery = FormatSQL("REPLACE INTO epgtags (idEpg, iStartTime, "
-        "iEndTime, sTitle, sPlotOutline, sPlot, iGenreType, iGenreSubType, sGenre, "
-        "iFirstAired, iParentalRating, iStarRating, bNotify, iSeriesId, "
-        "iEpisodeId, iEpisodePart, sEpisodeName, iBroadcastUid, idBroadcast) "
-        "VALUES (%u, %u, %u, '%s', '%s', '%s', %i, %i, '%s', %u, %i, %i, %i, %i, %i, %i, '%s', %i, %i);",
-        tag.EpgID(), iStartTime, iEndTime,
-        tag.Title(true).c_str(), tag.PlotOutline(true).c_str(), tag.Plot(true).c_str(), tag.GenreType(), tag.GenreSubType(), strGenre.c_str(),
-        iFirstAired, tag.ParentalRating(), tag.StarRating(), tag.Notify(),
-        tag.SeriesNum(), tag.EpisodeNum(), tag.EpisodePart(), tag.EpisodeName().c_str(),
-        tag.UniqueBroadcastID(), iBroadcastId);
+    CEpgWrite write;
+    write.strQuery     = strQuery;
+    write.iEpgId       = tag.EpgID();
+    write.iBroadcastId = iBroadcastId;
+    write.iHash        = iHash;
+    bQueued = Enqueue(write);
   }
 
-  if (bSingleUpdate)
+  if (bQueued)
   {
-    if (ExecuteQuery(strQuery))
-      iReturn = (int) m_pDS->lastinsertid();
+    iReturn = iBroadcastId;
   }
   else
   {
-    QueueInsertQuery(strQuery);
-    iReturn = 0;
+    CSingleLock lock(m_critSection);
+    if (ExecuteQuery(strQuery))
+      iReturn = iBroadcastId;
   }
 
   return iReturn;
@@ -23,6 +23,10 @@
 #include "dbwrappers/Database.h"
 #include "XBDateTime.h"
 #include "threads/CriticalSection.h"
+#include "threads/Event.h"
+#include "threads/Thread.h"
+
+#include <deque>
 
 namespace EPG
 {
@@ -32,18 +36,18 @@ namespace EPG
 
   /** The EPG database */
 
-  class CEpgDatabase : public CDatabase
+  class CEpgDatabase : public CDatabase, private CThread
   {
   public:
     /*!
      * @brief Create a new instance of the EPG database.
      */
-    CEpgDatabase(void) {};
+    CEpgDatabase(void);
 
     /*!
      * @brief Destroy this instance.
      */
-    virtual ~CEpgDatabase(void) {};
+    virtual ~CEpgDatabase(void);
 
     /*!
      * @brief Open the database.
@@ -51,6 +55,29 @@ namespace EPG
      */
     virtual bool Open(void);
 
+    /*!
+     * @brief Start the background writer. Writes are only queued while it's running, and executed immediately otherwise.
+     */
+    void StartWriter(void);
+
+    /*!
+     * @brief Stop the background writer and write all queued changes.
+     */
+    void StopWriter(void);
+
+    /*!
+     * @brief Queue a query that changes the database. Queued queries are executed in order by the background writer,
+     *        in transactions of up to EPG_DB_WRITE_BATCH_SIZE queries.
+     * @param strQuery The query to queue.
+     * @return True if the query was queued or, when the writer isn't running, executed successfully. False otherwise.
+     */
+    bool QueueWrite(const CStdString &strQuery);
+
+    /*!
+     * @brief Wait until the background writer wrote all queued changes.
+     */
+    void WaitForWrites(void);
+
     /*!
      * @brief Get the minimal database version that is required to operate correctly.
      * @return The minimal database version.
@@ -73,11 +100,11 @@ namespace EPG
     virtual bool DeleteEpg(void);
 
     /*!
-     * @brief Erase all EPG entries for a table.
+     * @brief Erase all EPG entries for a table. The query is queued.
      * @param table The table to remove the EPG entries for.
      * @param start Remove entries after this time if set.
      * @param end Remove entries before this time if set.
-     * @return True if the entries were removed successfully, false otherwise.
+     * @return True if the query was queued successfully, false otherwise.
      */
     virtual bool Delete(const CEpg &table, const time_t start = 0, const time_t end = 0);
 
@@ -88,9 +115,9 @@ namespace EPG
     virtual bool DeleteOldEpgEntries(void);
 
     /*!
-     * @brief Remove a single EPG entry.
+     * @brief Remove a single EPG entry. The query is queued.
      * @param tag The entry to remove.
-     * @return True if it was removed successfully, false otherwise.
+     * @return True if it was queued successfully, false otherwise.
      */
     virtual bool Delete(const CEpgInfoTag &tag);
 
@@ -135,12 +162,14 @@ namespace EPG
     virtual int Persist(const CEpg &epg, bool bQueueWrite = false);
 
     /*!
-     * @brief Persist an infotag.
+     * @brief Persist an infotag. Tags that weren't persisted before get their database ID assigned here.
      * @param tag The tag to persist.
-     * @param bSingleUpdate If true, this is a single update and the query will be executed immediately.
-     * @return The database ID of this entry or 0 if bSingleUpdate is false and the query was queued.
+     * @param iHash The content hash of the tag, reported back to the tag's table when a queued write is done.
+     * @param bSingleUpdate If true, this is a single update and the query will be executed immediately. Otherwise it's queued.
+     * @param bQueued Set to true if the query was queued, false if it was executed.
+     * @return The database ID of this entry or -1 on failure.
      */
-    virtual int Persist(const CEpgInfoTag &tag, bool bSingleUpdate = true);
+    virtual int Persist(const CEpgInfoTag &tag, unsigned int iHash, bool bSingleUpdate, bool &bQueued);
 
     //@}
 
@@ -159,5 +188,43 @@ namespace EPG
     virtual bool UpdateOldVersion(int version);
 
     CCriticalSection m_critSection;
+
+  private:
+    struct CEpgWrite
+    {
+      CStdString   strQuery;
+      int          iEpgId;       /*!< the table of the tag that is written, or -1 */
+      int          iBroadcastId; /*!< the tag that is written, or -1 */
+      unsigned int iHash;        /*!< the content hash of the tag that is written */
+    };
+
+    /*!
+     * @brief Add a write to the queue.
+     * @param write The write.
+     * @return True if it was queued, false if the background writer isn't running.
+     */
+    bool Enqueue(const CEpgWrite &write);
+
+    /*!
+     * @brief Execute queued queries in a single transaction, and report the tags that were written to their tables.
+     * @param iMaxQueries The maximum amount of queries to execute.
+     * @return The amount of queries that were executed.
+     */
+    unsigned int ExecuteWrites(unsigned int iMaxQueries);
+
+    /*!
+     * @brief The background writer. Executes queued queries in batches and pauses between batches, so other users of the database aren't blocked for long.
+     */
+    virtual void Process(void);
+
+    std::deque<CEpgWrite> m_writeQueue;       /*!< queries that are waiting to be executed */
+    unsigned int          m_iWriting;         /*!< queries taken off the queue that are being executed */
+    bool                  m_bWriterRunning;   /*!< true while writes are queued */
+    bool                  m_bFlush;           /*!< don't pause between batches until the queue is empty */
+    int                   m_iLastBroadcastId; /*!< the last database ID given to a tag */
+    CCriticalSection      m_writeLock;        /*!< protects the members above */
+    CEvent                m_writeEvent;       /*!< set when queries are queued */
+    CEvent                m_flushEvent;       /*!< set when a flush is requested */
+    CEvent                m_writtenEvent;     /*!< set after every transaction of the background writer */
   };
 }
@@ -28,7 +28,9 @@
 #include "pvr/timers/PVRTimers.h"
 #include "pvr/PVRManager.h"
 #include "settings/AdvancedSettings.h"
+#include "utils/Crc32.h"
 #include "utils/log.h"
+#include "utils/StringUtils.h"
 #include "addons/include/xbmc_pvr_types.h"
 
 using namespace std;
@@ -38,6 +40,8 @@ using namespace PVR;
 CEpgInfoTag::CEpgInfoTag(CEpg *epg /* = NULL */, int iPVRChannelNumber /* = -1 */, int iPVRChannelID /* = -1 */, const CStdString &strTableName /* = StringUtils::EmptyString */, const CStdString &strIconPath /* = StringUtils::EmptyString */) :
     m_bNotify(false),
     m_bChanged(false),
+    m_iPersistedHash(0),
+    m_iQueuedHash(0),
     m_iBroadcastId(-1),
     m_iGenreType(0),
     m_iGenreSubType(0),
@@ -64,6 +68,8 @@ CEpgInfoTag::CEpgInfoTag(CEpg *epg /* = NULL */, int iPVRChannelNumber /* = -1 *
 CEpgInfoTag::CEpgInfoTag(const EPG_TAG &data) :
     m_bNotify(false),
     m_bChanged(false),
+    m_iPersistedHash(0),
+    m_iQueuedHash(0),
     m_iBroadcastId(-1),
     m_iGenreType(0),
     m_iGenreSubType(0),
@@ -90,6 +96,8 @@ CEpgInfoTag::CEpgInfoTag(const EPG_TAG &data) :
 CEpgInfoTag::CEpgInfoTag(const CEpgInfoTag &tag) :
     m_bNotify(tag.m_bNotify),
     m_bChanged(tag.m_bChanged),
+    m_iPersistedHash(tag.m_iPersistedHash),
+    m_iQueuedHash(0),
     m_iBroadcastId(tag.m_iBroadcastId),
     m_iGenreType(tag.m_iGenreType),
     m_iGenreSubType(tag.m_iGenreSubType),
@@ -168,6 +176,8 @@ CEpgInfoTag &CEpgInfoTag::operator =(const CEpgInfoTag &other)
 
   m_bNotify            = other.m_bNotify;
   m_bChanged           = other.m_bChanged;
+  m_iPersistedHash     = other.m_iPersistedHash;
+  m_iQueuedHash        = 0; /* queued writes are only confirmed to the original */
   m_iBroadcastId       = other.m_iBroadcastId;
   m_iGenreType         = other.m_iGenreType;
   m_iGenreSubType      = other.m_iGenreSubType;
@@ -941,6 +951,20 @@ bool CEpgInfoTag::Persist(bool bSingleUpdate /* = true */)
   CSingleLock lock(m_critSection);
   if (!m_bChanged)
     return true;
+
+  /* changes that were undone since the last write, like start times that were moved when fixing overlapping
+     events and moved back by an update, don't have to be written again */
+  unsigned int iHash = ContentHash();
+  if (m_iPersistedHash != 0 && iHash == m_iPersistedHash)
+  {
+    m_bChanged = false;
+    return true;
+  }
+
+  /* already waiting for the database writer */
+  if (iHash == m_iQueuedHash)
+    return true;
+
   CLog::Log(LOGDEBUG, "Epg - %s - Infotag '%s' %s, persisting...", __FUNCTION__, m_strTitle.c_str(), m_iBroadcastId > 0 ? "has changes" : "is new");
   CEpgDatabase *database = g_EpgContainer.GetDatabase();
   if (!database || (bSingleUpdate && !database->IsOpen()))
@@ -949,21 +973,69 @@ bool CEpgInfoTag::Persist(bool bSingleUpdate /* = true */)
     return bReturn;
   }
 
-  int iId = database->Persist(*this, bSingleUpdate);
-  if (iId >= 0)
+  bool bQueued(false);
+  int iId = database->Persist(*this, iHash, bSingleUpdate, bQueued);
+  if (iId > 0)
   {
     bReturn = true;
+    m_iBroadcastId = iId;
 
-    if (iId > 0)
+    if (bQueued)
     {
-      m_iBroadcastId = iId;
-      m_bChanged = false;
+      /* the changed flag is cleared once the database writer confirms the write */
+      m_iQueuedHash = iHash;
+    }
+    else
+    {
+      m_bChanged       = false;
+      m_iPersistedHash = iHash;
+      m_iQueuedHash    = 0;
     }
   }
 
   return bReturn;
 }
 
+void CEpgInfoTag::OnPersisted(unsigned int iHash, bool bSuccess)
+{
+  CSingleLock lock(m_critSection);
+
+  /* a newer write of this tag is queued or was already executed */
+  if (iHash != m_iQueuedHash)
+    return;
+
+  m_iQueuedHash = 0;
+  if (bSuccess)
+  {
+    m_iPersistedHash = iHash;
+    m_bChanged       = ContentHash() != iHash;
+  }
+}
+
+unsigned int CEpgInfoTag::ContentHash(void) const
+{
+  CSingleLock lock(m_critSection);
+
+  time_t iStartTime, iEndTime, iFirstAired;
+  m_startTime.GetAsTime(iStartTime);
+  m_endTime.GetAsTime(iEndTime);
+  m_firstAired.GetAsTime(iFirstAired);
+
+  CStdString strContent, strDetails;
+  strContent.Format("%d|%u|%u|%s|%s|%s|%i|%i|%s|",
+      EpgID(), (unsigned int) iStartTime, (unsigned int) iEndTime,
+      m_strTitle.c_str(), m_strPlotOutline.c_str(), m_strPlot.c_str(), m_iGenreType, m_iGenreSubType,
+      m_iGenreType == EPG_GENRE_USE_STRING ? StringUtils::Join(m_genre, g_advancedSettings.m_videoItemSeparator).c_str() : "");
+  strDetails.Format("%u|%i|%i|%i|%i|%i|%i|%s|%i",
+      (unsigned int) iFirstAired, m_iParentalRating, m_iStarRating, m_bNotify ? 1 : 0,
+      m_iSeriesNumber, m_iEpisodeNumber, m_iEpisodePart, m_strEpisodeName.c_str(), m_iUniqueBroadcastID);
+  strContent += strDetails;
+
+  Crc32 crc;
+  crc.Compute(strContent);
+  return (unsigned int) crc;
+}
+
 void CEpgInfoTag::UpdatePath(void)
 {
   CStdString path;
@@ -40,6 +40,7 @@ namespace EPG
   {
     friend class CEpg;
     friend class CEpgDatabase;
+    friend class CEpgSearchIndex;
     friend class PVR::CPVRTimerInfoTag;
 
   public:
@@ -412,6 +413,12 @@ namespace EPG
      */
     virtual bool Persist(bool bSingleUpdate = true);
 
+    /*!
+     * @brief Get a hash of the information in this tag that is stored in the database.
+     * @return The hash.
+     */
+    unsigned int ContentHash(void) const;
+
     /*!
      * @brief Update the information in this tag with the info in the given tag.
      * @param tag The new info.
@@ -427,6 +434,13 @@ namespace EPG
     virtual bool Update(const CEpgInfoTag &tag, bool bUpdateBroadcastId = true);
 
   protected:
+    /*!
+     * @brief Called when a queued write of this tag was executed.
+     * @param iHash The content hash of the tag that was written.
+     * @param bSuccess True if it was written successfully, false otherwise.
+     */
+    void OnPersisted(unsigned int iHash, bool bSuccess);
+
     /*!
      * @brief Hook that is called when the start date changed.
      */
@@ -439,6 +453,8 @@ namespace EPG
 
     bool                   m_bNotify;            /*!< notify on start */
     bool                   m_bChanged;           /*!< keep track of changes to this entry */
+    unsigned int           m_iPersistedHash;     /*!< ContentHash() when this entry was last read from or written to the database */
+    unsigned int           m_iQueuedHash;        /*!< ContentHash() of the write of this entry that is waiting for the database writer, or 0 */
 
     int                    m_iBroadcastId;       /*!< database ID */
     int                    m_iGenreType;         /*!< genre type */
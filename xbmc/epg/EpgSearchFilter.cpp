@@ -28,6 +28,8 @@
 #include "EpgSearchFilter.h"
 #include "EpgContainer.h"
 
+#include <map>
+
 #include "pvr/PVRManager.h"
 #include "pvr/channels/PVRChannelGroupsContainer.h"
 #include "pvr/recordings/PVRRecordings.h"
@@ -62,35 +64,53 @@ void EpgSearchFilter::Reset()
 }
 
 bool EpgSearchFilter::MatchGenre(const CEpgInfoTag &tag) const
+{
+  return MatchGenre(tag.GenreType());
+}
+
+bool EpgSearchFilter::MatchGenre(int iGenreType) const
 {
   bool bReturn(true);
 
   if (m_iGenreType != EPG_SEARCH_UNSET)
   {
-    bool bIsUnknownGenre(tag.GenreType() > EPG_EVENT_CONTENTMASK_USERDEFINED ||
-        tag.GenreType() < EPG_EVENT_CONTENTMASK_MOVIEDRAMA);
-    bReturn = ((m_bIncludeUnknownGenres && bIsUnknownGenre) || tag.GenreType() == m_iGenreType);
+    bool bIsUnknownGenre(iGenreType > EPG_EVENT_CONTENTMASK_USERDEFINED ||
+        iGenreType < EPG_EVENT_CONTENTMASK_MOVIEDRAMA);
+    bReturn = ((m_bIncludeUnknownGenres && bIsUnknownGenre) || iGenreType == m_iGenreType);
   }
 
   return bReturn;
 }
 
 bool EpgSearchFilter::MatchDuration(const CEpgInfoTag &tag) const
+{
+  return MatchDuration(tag.GetDuration());
+}
+
+bool EpgSearchFilter::MatchDuration(int iDuration) const
 {
   bool bReturn(true);
 
   if (m_iMinimumDuration != EPG_SEARCH_UNSET)
-    bReturn = (tag.GetDuration() > m_iMinimumDuration * 60);
+    bReturn = (iDuration > m_iMinimumDuration * 60);
 
   if (bReturn && m_iMaximumDuration != EPG_SEARCH_UNSET)
-    bReturn = (tag.GetDuration() < m_iMaximumDuration * 60);
+    bReturn = (iDuration < m_iMaximumDuration * 60);
 
   return bReturn;
 }
 
 bool EpgSearchFilter::MatchStartAndEndTimes(const CEpgInfoTag &tag) const
 {
-  return (tag.StartAsLocalTime() >= m_startDateTime && tag.EndAsLocalTime() <= m_endDateTime);
+  return MatchStartAndEndTimes(tag.StartAsUTC(), tag.EndAsUTC());
+}
+
+bool EpgSearchFilter::MatchStartAndEndTimes(const CDateTime &startUTC, const CDateTime &endUTC) const
+{
+  CDateTime start, end;
+  start.SetFromUTCDateTime(startUTC);
+  end.SetFromUTCDateTime(endUTC);
+  return (start >= m_startDateTime && end <= m_endDateTime);
 }
 
 bool EpgSearchFilter::MatchSearchTerm(const CEpgInfoTag &tag) const
@@ -119,36 +139,77 @@ bool EpgSearchFilter::FilterEntry(const CEpgInfoTag &tag) const
        (!m_bFTAOnly || !tag.ChannelTag()->IsEncrypted())));
 }
 
-int EpgSearchFilter::RemoveDuplicates(CFileItemList &results)
+/* FNV-1a over the fields that identify a repeated broadcast */
+static uint64_t ContentHash(const CEpgInfoTag &tag)
 {
-  unsigned int iSize = results.Size();
+  CStdString strFields[3] = { tag.Title(), tag.Plot(), tag.PlotOutline() };
 
-  for (unsigned int iResultPtr = 0; iResultPtr < iSize; iResultPtr++)
+  uint64_t iHash = 14695981039346656037ULL;
+  for (unsigned int iFieldPtr = 0; iFieldPtr < 3; iFieldPtr++)
   {
-    const CEpgInfoTag *epgentry_1 = results.Get(iResultPtr)->GetEPGInfoTag();
-    for (unsigned int iTagPtr = 0; iTagPtr < iSize; iTagPtr++)
+    const CStdString &strField = strFields[iFieldPtr];
+    for (size_t iCharPtr = 0; iCharPtr < strField.length(); iCharPtr++)
     {
-      const CEpgInfoTag *epgentry_2 = results.Get(iTagPtr)->GetEPGInfoTag();
-      if (iResultPtr == iTagPtr)
-        continue;
+      iHash ^= (unsigned char) strField[iCharPtr];
+      iHash *= 1099511628211ULL;
+    }
+    /* separate the fields, so "ab" + "c" doesn't hash like "a" + "bc" */
+    iHash ^= 0xff;
+    iHash *= 1099511628211ULL;
+  }
 
-      if (epgentry_1->Title()       != epgentry_2->Title() ||
-          epgentry_1->Plot()        != epgentry_2->Plot() ||
-          epgentry_1->PlotOutline() != epgentry_2->PlotOutline())
-        continue;
+  return iHash;
+}
 
-      results.Remove(iTagPtr);
-      iResultPtr--;
-      iTagPtr--;
-      iSize--;
+int EpgSearchFilter::RemoveDuplicates(CFileItemList &results)
+{
+  /* keep the first of each set of entries with the same title and plot. only entries with the same hash are compared */
+  multimap<uint64_t, const CEpgInfoTag *> seen;
+  vector<CFileItemPtr> unique;
+  unique.reserve(results.Size());
+
+  for (int iResultPtr = 0; iResultPtr < results.Size(); iResultPtr++)
+  {
+    CFileItemPtr item = results.Get(iResultPtr);
+    const CEpgInfoTag *epgentry = item->GetEPGInfoTag();
+    uint64_t iHash = ContentHash(*epgentry);
+
+    bool bDuplicate(false);
+    pair<multimap<uint64_t, const CEpgInfoTag *>::const_iterator, multimap<uint64_t, const CEpgInfoTag *>::const_iterator> range = seen.equal_range(iHash);
+    for (multimap<uint64_t, const CEpgInfoTag *>::const_iterator it = range.first; it != range.second; it++)
+    {
+      if (it->second->Title()       == epgentry->Title() &&
+          it->second->Plot()        == epgentry->Plot() &&
+          it->second->PlotOutline() == epgentry->PlotOutline())
+      {
+        bDuplicate = true;
+        break;
+      }
+    }
+
+    if (!bDuplicate)
+    {
+      seen.insert(make_pair(iHash, epgentry));
+      unique.push_back(item);
     }
   }
 
-  return iSize;
-}
+  if (unique.size() != (size_t) results.Size())
+  {
+    results.ClearItems();
+    for (vector<CFileItemPtr>::const_iterator it = unique.begin(); it != unique.end(); it++)
+      results.Add(*it);
+  }
 
+  return results.Size();
+}
 
 bool EpgSearchFilter::MatchChannelNumber(const CEpgInfoTag &tag) const
+{
+  return MatchChannelNumber(*tag.ChannelTag());
+}
+
+bool EpgSearchFilter::MatchChannelNumber(const CPVRChannel &channel) const
 {
   bool bReturn(true);
 
@@ -158,20 +219,25 @@ bool EpgSearchFilter::MatchChannelNumber(const CEpgInfoTag &tag) const
     if (!group)
       group = CPVRManager::Get().ChannelGroups()->GetGroupAllTV();
 
-    bReturn = (m_iChannelNumber == (int) group->GetChannelNumber(*tag.ChannelTag()));
+    bReturn = (m_iChannelNumber == (int) group->GetChannelNumber(channel));
   }
 
   return bReturn;
 }
 
 bool EpgSearchFilter::MatchChannelGroup(const CEpgInfoTag &tag) const
+{
+  return MatchChannelGroup(*tag.ChannelTag());
+}
+
+bool EpgSearchFilter::MatchChannelGroup(const CPVRChannel &channel) const
 {
   bool bReturn(true);
 
   if (m_iChannelGroup != EPG_SEARCH_UNSET && g_PVRManager.IsStarted())
   {
     const CPVRChannelGroup *group = g_PVRChannelGroups->GetByIdFromAll(m_iChannelGroup);
-    bReturn = (group && group->IsGroupMember(*tag.ChannelTag()));
+    bReturn = (group && group->IsGroupMember(channel));
   }
 
   return bReturn;
@@ -25,6 +25,11 @@
 
 class CFileItemList;
 
+namespace PVR
+{
+  class CPVRChannel;
+}
+
 namespace EPG
 {
   class CEpgInfoTag;
@@ -57,6 +62,13 @@ namespace EPG
     virtual bool MatchChannelNumber(const CEpgInfoTag &tag) const;
     virtual bool MatchChannelGroup(const CEpgInfoTag &tag) const;
 
+    /* the same checks on the values of a tag */
+    bool MatchGenre(int iGenreType) const;
+    bool MatchDuration(int iDuration) const;
+    bool MatchStartAndEndTimes(const CDateTime &startUTC, const CDateTime &endUTC) const;
+    bool MatchChannelNumber(const PVR::CPVRChannel &channel) const;
+    bool MatchChannelGroup(const PVR::CPVRChannel &channel) const;
+
     static int RemoveDuplicates(CFileItemList &results);
 
     CStdString    m_strSearchTerm;            /*!< The term to search for */
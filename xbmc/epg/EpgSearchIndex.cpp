@@ -0,0 +1,339 @@
+/*
+ *      Copyright (C) 2012 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+ *  http://www.gnu.org/copyleft/gpl.html
+ *
+ */
+
+
+#include "EpgSearchIndex.h"
+#include "Epg.h"
+#include "EpgSearchFilter.h"
+#include "guilib/LocalizeStrings.h"
+#include "threads/SingleLock.h"
+#include "pvr/PVRManager.h"
+#include "pvr/channels/PVRChannel.h"
+#include "pvr/channels/PVRChannelGroupsContainer.h"
+#include "utils/TextSearch.h"
+
+#include <algorithm>
+#include <ctype.h>
+
+using namespace std;
+using namespace EPG;
+using namespace PVR;
+
+namespace
+{
+  /* orders tags by start time */
+  struct StartTimeLess
+  {
+    template<class T>
+    bool operator()(const T &left, const CDateTime &right) const { return left.startTime < right; }
+    template<class T>
+    bool operator()(const CDateTime &left, const T &right) const { return left < right.startTime; }
+    template<class T>
+    bool operator()(const T &left, const T &right) const { return left.startTime < right.startTime; }
+  };
+
+  /* ascii punctuation and whitespace separate words. multibyte utf-8 sequences are kept intact */
+  inline bool IsWordChar(char c)
+  {
+    return (c & 0x80) != 0 || isalnum((unsigned char) c);
+  }
+
+  void SortUnique(vector<unsigned int> &positions)
+  {
+    sort(positions.begin(), positions.end());
+    positions.erase(unique(positions.begin(), positions.end()), positions.end());
+  }
+}
+
+CEpgSearchIndex::CEpgSearchIndex(void)
+{
+}
+
+void CEpgSearchIndex::AddTable(const CEpg &epg, const CEpgSearchIndex *previous)
+{
+  CSingleLock lock(epg.m_critSection);
+  m_revisions.insert(make_pair(epg.m_iEpgID, epg.m_iRevision));
+
+  if (previous)
+  {
+    map<int, unsigned int>::const_iterator it = previous->m_revisions.find(epg.m_iEpgID);
+    if (it != previous->m_revisions.end() && it->second == epg.m_iRevision)
+    {
+      for (vector<CTablePtr>::const_iterator table = previous->m_tables.begin(); table != previous->m_tables.end(); table++)
+      {
+        if ((*table)->m_iEpgID == epg.m_iEpgID)
+        {
+          m_tables.push_back(*table);
+          return;
+        }
+      }
+    }
+  }
+
+  m_tables.push_back(CTablePtr(new CTable(epg)));
+}
+
+void CEpgSearchIndex::Build(void)
+{
+  for (vector<CTablePtr>::const_iterator it = m_tables.begin(); it != m_tables.end(); it++)
+  {
+    if (!(*it)->m_bBuilt)
+      (*it)->Build();
+  }
+}
+
+size_t CEpgSearchIndex::Size(void) const
+{
+  size_t iSize(0);
+  for (vector<CTablePtr>::const_iterator it = m_tables.begin(); it != m_tables.end(); it++)
+    iSize += (*it)->m_tags.size();
+  return iSize;
+}
+
+int CEpgSearchIndex::Search(vector<EpgSearchResult> &results, const EpgSearchFilter &filter) const
+{
+  int iInitialSize = results.size();
+
+  /* the placeholders of locked channels and empty titles aren't indexed, as they depend on the lock state */
+  CTextSearch search(filter.m_strSearchTerm, filter.m_bIsCaseSensitive, SEARCH_DEFAULT_OR);
+  bool bUseWords = !filter.m_strSearchTerm.IsEmpty() &&
+      !search.Search(g_localizeStrings.Get(19266)) &&
+      !search.Search(g_localizeStrings.Get(19055));
+
+  for (vector<CTablePtr>::const_iterator it = m_tables.begin(); it != m_tables.end(); it++)
+    (*it)->Search(results, filter, search, bUseWords);
+
+  return results.size() - iInitialSize;
+}
+
+CEpgSearchIndex::CTable::CTable(const CEpg &epg) :
+    m_iEpgID(epg.m_iEpgID),
+    m_iChannelID(epg.m_iPVRChannelId),
+    m_iRevision(epg.m_iRevision),
+    m_bBuilt(false)
+{
+  /* the caller holds the table lock */
+  m_tags.reserve(epg.m_tags.size());
+  for (map<CDateTime, CEpgInfoTag *>::const_iterator it = epg.m_tags.begin(); it != epg.m_tags.end(); it++)
+  {
+    const CEpgInfoTag &tag = *it->second;
+    CSingleLock tagLock(tag.m_critSection);
+    STag entry;
+    entry.startTime      = tag.StartAsUTC();
+    entry.endTime        = tag.EndAsUTC();
+    entry.iDuration      = tag.GetDuration();
+    entry.iGenreType     = tag.GenreType();
+    entry.strTitle       = tag.m_strTitle;
+    entry.strPlotOutline = tag.m_strPlotOutline;
+    m_tags.push_back(entry);
+  }
+  /* FixOverlappingEvents() can move the start time of a tag away from its key */
+  stable_sort(m_tags.begin(), m_tags.end(), StartTimeLess());
+}
+
+void CEpgSearchIndex::CTable::Build(void)
+{
+  for (unsigned int iTag = 0; iTag < m_tags.size(); iTag++)
+  {
+    const STag &tag = m_tags[iTag];
+    m_genres[tag.iGenreType].push_back(iTag);
+    AddWords(tag.strTitle, iTag);
+    AddWords(tag.strPlotOutline, iTag);
+  }
+
+  for (map<CStdString, vector<unsigned int> >::iterator it = m_words.begin(); it != m_words.end(); it++)
+    SortUnique(it->second);
+
+  m_bBuilt = true;
+}
+
+void CEpgSearchIndex::CTable::AddWords(const CStdString &strText, unsigned int iTag)
+{
+  CStdString strLower(strText);
+  strLower.ToLower();
+
+  size_t iStart = 0;
+  while (iStart < strLower.length())
+  {
+    while (iStart < strLower.length() && !IsWordChar(strLower[iStart]))
+      iStart++;
+
+    size_t iEnd = iStart;
+    while (iEnd < strLower.length() && IsWordChar(strLower[iEnd]))
+      iEnd++;
+
+    if (iEnd > iStart)
+      m_words[strLower.substr(iStart, iEnd - iStart)].push_back(iTag);
+
+    iStart = iEnd;
+  }
+}
+
+bool CEpgSearchIndex::CTable::GetTermCandidates(const CStdString &strTerm, vector<unsigned int> &candidates) const
+{
+  /* a term can span several words. every match contains its longest word as (part of) an indexed word */
+  CStdString strLower(strTerm);
+  strLower.ToLower();
+
+  CStdString strLongest;
+  size_t iStart = 0;
+  while (iStart < strLower.length())
+  {
+    while (iStart < strLower.length() && !IsWordChar(strLower[iStart]))
+      iStart++;
+
+    size_t iEnd = iStart;
+    while (iEnd < strLower.length() && IsWordChar(strLower[iEnd]))
+      iEnd++;
+
+    if (iEnd - iStart > strLongest.length())
+      strLongest = strLower.substr(iStart, iEnd - iStart);
+
+    iStart = iEnd;
+  }
+
+  if (strLongest.IsEmpty())
+    return false;
+
+  for (map<CStdString, vector<unsigned int> >::const_iterator it = m_words.begin(); it != m_words.end(); it++)
+  {
+    if (it->first.find(strLongest) != string::npos)
+      candidates.insert(candidates.end(), it->second.begin(), it->second.end());
+  }
+
+  return true;
+}
+
+bool CEpgSearchIndex::CTable::GetWordCandidates(const CTextSearch &search, vector<unsigned int> &candidates) const
+{
+  const vector<CStdString> &andTerms = search.GetAndTerms();
+  const vector<CStdString> &orTerms  = search.GetOrTerms();
+
+  if (!andTerms.empty())
+  {
+    /* every match contains all AND terms, so the smallest candidate list of any of them will do */
+    bool bFound(false);
+    for (unsigned int iTermPtr = 0; iTermPtr < andTerms.size(); iTermPtr++)
+    {
+      vector<unsigned int> termCandidates;
+      if (!GetTermCandidates(andTerms[iTermPtr], termCandidates))
+        continue;
+
+      SortUnique(termCandidates);
+      if (!bFound || termCandidates.size() < candidates.size())
+        candidates.swap(termCandidates);
+      bFound = true;
+    }
+    return bFound;
+  }
+
+  if (!orTerms.empty())
+  {
+    /* every match contains at least one OR term */
+    for (unsigned int iTermPtr = 0; iTermPtr < orTerms.size(); iTermPtr++)
+    {
+      if (!GetTermCandidates(orTerms[iTermPtr], candidates))
+      {
+        candidates.clear();
+        return false;
+      }
+    }
+    SortUnique(candidates);
+    return true;
+  }
+
+  return false;
+}
+
+void CEpgSearchIndex::CTable::Search(vector<EpgSearchResult> &results, const EpgSearchFilter &filter, const CTextSearch &search, bool bUseWords) const
+{
+  if (m_iEpgID <= 0 || m_tags.empty() || m_tags.back().endTime < CDateTime::GetCurrentDateTime().GetAsUTCDateTime())
+    return;
+
+  /* evaluate the channel filters once per table instead of once per tag */
+  const CPVRChannel *channel = (m_iChannelID != -1 && g_PVRManager.IsStarted()) ? g_PVRChannelGroups->GetByChannelIDFromAll(m_iChannelID) : NULL;
+  if (channel &&
+      (!filter.MatchChannelNumber(*channel) ||
+       !filter.MatchChannelGroup(*channel) ||
+       (filter.m_bFTAOnly && channel->IsEncrypted())))
+    return;
+  bool bLocked = channel && g_PVRManager.IsParentalLocked(*channel);
+
+  /* pick the most selective index to get the candidates from */
+  vector<unsigned int> candidates;
+  const vector<unsigned int> *selected = NULL;
+  size_t iSelectedSize = m_tags.size();
+
+  bool bSearchTerm(!filter.m_strSearchTerm.IsEmpty());
+  if (bUseWords && !bLocked && GetWordCandidates(search, candidates) && candidates.size() < iSelectedSize)
+  {
+    selected      = &candidates;
+    iSelectedSize = candidates.size();
+  }
+
+  if (filter.m_iGenreType != EPG_SEARCH_UNSET && !filter.m_bIncludeUnknownGenres)
+  {
+    map<int, vector<unsigned int> >::const_iterator it = m_genres.find(filter.m_iGenreType);
+    if (it == m_genres.end())
+      return;
+    if (it->second.size() < iSelectedSize)
+    {
+      selected      = &it->second;
+      iSelectedSize = it->second.size();
+    }
+  }
+
+  size_t iFirst(0), iLast(iSelectedSize);
+  if (!selected && filter.m_startDateTime.IsValid() && filter.m_endDateTime.IsValid())
+  {
+    /* widened by a day, so local time conversions can't drop any matches */
+    CDateTimeSpan margin(1, 0, 0, 0);
+    iFirst = lower_bound(m_tags.begin(), m_tags.end(), filter.m_startDateTime.GetAsUTCDateTime() - margin, StartTimeLess()) - m_tags.begin();
+    iLast  = upper_bound(m_tags.begin() + iFirst, m_tags.end(), filter.m_endDateTime.GetAsUTCDateTime() + margin, StartTimeLess()) - m_tags.begin();
+  }
+
+  for (size_t iPtr = iFirst; iPtr < iLast; iPtr++)
+  {
+    const STag &tag = m_tags[selected ? (*selected)[iPtr] : iPtr];
+    if (!filter.MatchGenre(tag.iGenreType) ||
+        !filter.MatchDuration(tag.iDuration) ||
+        !filter.MatchStartAndEndTimes(tag.startTime, tag.endTime))
+      continue;
+
+    if (bSearchTerm)
+    {
+      /* match what CEpgInfoTag::Title() and PlotOutline() return */
+      if (bLocked)
+      {
+        if (!search.Search(g_localizeStrings.Get(19266)))
+          continue;
+      }
+      else if (!search.Search(tag.strTitle.IsEmpty() ? g_localizeStrings.Get(19055) : tag.strTitle) &&
+               !search.Search(tag.strPlotOutline))
+        continue;
+    }
+
+    EpgSearchResult result;
+    result.iEpgID    = m_iEpgID;
+    result.startTime = tag.startTime;
+    results.push_back(result);
+  }
+}
@@ -0,0 +1,134 @@
+#pragma once
+
+/*
+ *      Copyright (C) 2012 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+ *  http://www.gnu.org/copyleft/gpl.html
+ *
+ */
+
+
+#include "XBDateTime.h"
+#include "utils/StdString.h"
+
+#include <map>
+#include <vector>
+#include <boost/shared_ptr.hpp>
+
+class CTextSearch;
+
+namespace PVR
+{
+  class CPVRChannel;
+}
+
+namespace EPG
+{
+  class CEpg;
+  struct EpgSearchFilter;
+
+  /** A tag that matched a search. The tag itself has to be looked up in its table */
+
+  struct EpgSearchResult
+  {
+    int       iEpgID;    /*!< the id of the table of the tag */
+    CDateTime startTime; /*!< the start time in UTC of the tag */
+  };
+
+  /** Read-only snapshot of all EPG tables, indexed for searching */
+
+  class CEpgSearchIndex
+  {
+  public:
+    CEpgSearchIndex(void);
+    virtual ~CEpgSearchIndex(void) {}
+
+    /*!
+     * @brief Add a table to this index. Call Build() after all tables have been added.
+     *
+     * Only the fields a search filter looks at are copied, so this is cheap enough to be done while holding the
+     * container lock. If the table didn't change since it was added to the previous index, its indexes are shared
+     * with that one.
+     *
+     * @param epg The table to add.
+     * @param previous The previous index or NULL if there is none.
+     */
+    void AddTable(const CEpg &epg, const CEpgSearchIndex *previous);
+
+    /*!
+     * @brief Create the time, genre and word indexes of the tables that were added since the last call.
+     */
+    void Build(void);
+
+    /*!
+     * @brief Check whether this index was built from the given table revisions.
+     * @param revisions The current revision of each table, by table id.
+     * @return True if this index is still up to date, false otherwise.
+     */
+    bool IsCurrent(const std::map<int, unsigned int> &revisions) const { return m_revisions == revisions; }
+
+    /*!
+     * @brief Get all tags that match a filter.
+     * @param results The matching tags, ordered by table and start time.
+     * @param filter The filter to apply.
+     * @return The amount of tags that were added.
+     */
+    int Search(std::vector<EpgSearchResult> &results, const EpgSearchFilter &filter) const;
+
+    /*!
+     * @return The amount of tags in this index.
+     */
+    size_t Size(void) const;
+
+  private:
+    struct STag
+    {
+      CDateTime  startTime;      /*!< the start time in UTC */
+      CDateTime  endTime;        /*!< the end time in UTC */
+      int        iDuration;      /*!< the duration in seconds, as reported by CEpgInfoTag::GetDuration() */
+      int        iGenreType;     /*!< the genre type */
+      CStdString strTitle;       /*!< the title, without the parental lock placeholder */
+      CStdString strPlotOutline; /*!< the plot outline, without the parental lock applied */
+    };
+
+    class CTable
+    {
+    public:
+      CTable(const CEpg &epg);
+
+      void Build(void);
+      void Search(std::vector<EpgSearchResult> &results, const EpgSearchFilter &filter, const CTextSearch &search, bool bUseWords) const;
+
+      int                                              m_iEpgID;       /*!< the id of this table */
+      int                                              m_iChannelID;   /*!< the id of the channel of this table or -1 if it has none */
+      unsigned int                                     m_iRevision;    /*!< the revision of this table when it was copied */
+      bool                                             m_bBuilt;       /*!< true once the indexes were created */
+      std::vector<STag>                                m_tags;         /*!< all tags, ordered by start time */
+      std::map<int, std::vector<unsigned int> >        m_genres;       /*!< positions in m_tags, by genre type */
+      std::map<CStdString, std::vector<unsigned int> > m_words;        /*!< positions in m_tags, by lower case word in the title or plot outline */
+
+    private:
+      void AddWords(const CStdString &strText, unsigned int iTag);
+      bool GetWordCandidates(const CTextSearch &search, std::vector<unsigned int> &candidates) const;
+      bool GetTermCandidates(const CStdString &strTerm, std::vector<unsigned int> &candidates) const;
+    };
+    typedef boost::shared_ptr<CTable> CTablePtr;
+
+    std::vector<CTablePtr>      m_tables;    /*!< the tables in this index */
+    std::map<int, unsigned int> m_revisions; /*!< the revision of each table when it was added */
+  };
+}
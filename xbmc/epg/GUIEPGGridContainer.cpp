@@ -91,7 +91,6 @@ CGUIEPGGridContainer::CGUIEPGGridContainer(int parentID, int controlID, float po
   m_cacheChannelItems     = preloadItems;
   m_cacheRulerItems       = preloadItems;
   m_cacheProgrammeItems   = preloadItems;
-  m_gridIndex             = NULL;
 }
 
 CGUIEPGGridContainer::~CGUIEPGGridContainer(void)
@@ -712,13 +711,27 @@ bool CGUIEPGGridContainer::OnMessage(CGUIMessage& message)
       for (int i = 0; i < items->Size(); i++)
         m_programmeItems.push_back(items->Get(i));
 
-      ClearGridIndex();
-      m_gridIndex = (struct GridItemsPtr **) calloc(1,m_channelItems.size()*sizeof(struct GridItemsPtr));
-      if (m_gridIndex != NULL)
+      /* Create the programme intervals of each channel, so the local start and end times are only calculated once */
+      m_channelEntries.resize(m_epgItemsPtr.size());
+      for (unsigned int row = 0; row < m_epgItemsPtr.size(); row++)
       {
-        for (unsigned int i = 0; i < m_channelItems.size(); i++)
+        int channelnum = -1;
+        for (long i = m_epgItemsPtr[row].start; i <= m_epgItemsPtr[row].stop; i++)
         {
-          m_gridIndex[i] = (struct GridItemsPtr*) calloc(1,MAXBLOCKS*sizeof(struct GridItemsPtr));
+          const CEpgInfoTag* tag = ((CFileItem *)m_programmeItems[i].get())->GetEPGInfoTag();
+          if (!tag)
+            continue;
+
+          if (channelnum == -1)
+            channelnum = tag->PVRChannelNumber();
+          else if (tag->PVRChannelNumber() != channelnum)
+            break;
+
+          GridEntry entry;
+          tag->StartAsLocalTime().GetAsTime(entry.start);
+          tag->EndAsLocalTime().GetAsTime(entry.end);
+          entry.item = i;
+          m_channelEntries[row].push_back(entry);
         }
       }
 
@@ -758,11 +771,12 @@ bool CGUIEPGGridContainer::OnMessage(CGUIMessage& message)
 
 void CGUIEPGGridContainer::UpdateItems()
 {
-  CDateTimeSpan blockDuration, gridDuration;
+  CDateTimeSpan gridDuration;
 
   /* check for invalid start and end time */
   if (m_gridStart >= m_gridEnd)
   {
+    m_gridIndex.assign(m_channelItems.size(), std::vector<GridItemsPtr>(m_blocksPerPage + 1));
     CLog::Log(LOGERROR, "CGUIEPGGridContainer - %s - invalid start and end time set", __FUNCTION__);
     CGUIMessage msg(GUI_MSG_LABEL_RESET, GetID(), GetParentID()); // message the window
     SendWindowMessage(msg);
@@ -775,6 +789,9 @@ void CGUIEPGGridContainer::UpdateItems()
   if (m_blocks >= MAXBLOCKS)
     m_blocks = MAXBLOCKS;
 
+  /* one extra block per channel, so the end of the last programme can be found by looking one block ahead */
+  m_gridIndex.assign(m_channelItems.size(), std::vector<GridItemsPtr>(max(m_blocks, m_blocksPerPage) + 1));
+
   /* if less than one page, can't display grid */
   if (m_blocks < m_blocksPerPage)
   {
@@ -784,51 +801,27 @@ void CGUIEPGGridContainer::UpdateItems()
     return;
   }
 
-  blockDuration.SetDateTimeSpan(0, 0, MINSPERBLOCK, 0);
-
   long tick(XbmcThreads::SystemClockMillis());
 
+  time_t gridStart;
+  time_t gridEnd;
+  m_gridStart.GetAsTime(gridStart);
+  m_gridEnd.GetAsTime(gridEnd);
+
   for (unsigned int row = 0; row < m_channelItems.size(); ++row)
   {
-    CDateTime gridCursor  = m_gridStart; //reset cursor for new channel
-    unsigned long progIdx = m_epgItemsPtr[row].start;
-    unsigned long lastIdx = m_epgItemsPtr[row].stop;
-    int channelnum        = ((CFileItem *)m_programmeItems[progIdx].get())->GetEPGInfoTag()->PVRChannelNumber();
-
-    /** FOR EACH BLOCK **********************************************************************/
+    /** FOR EACH PROGRAMME IN THE GRID ******************************************************/
 
-    for (int block = 0; block < m_blocks; block++)
+    const std::vector<GridEntry> &entries = m_channelEntries[row];
+    int block = 0;
+    for (size_t i = GetEntryAt(row, gridStart); i < entries.size() && block < m_blocks; i++)
     {
-      while (progIdx <= lastIdx)
-      {
-        CGUIListItemPtr item = m_programmeItems[progIdx];
-        const CEpgInfoTag* tag = ((CFileItem *)item.get())->GetEPGInfoTag();
-        if (tag == NULL)
-          progIdx++;
-
-        if (tag->PVRChannelNumber() != channelnum)
-          break;
-
-        if (m_gridEnd <= tag->StartAsLocalTime())
-        {
-          break;
-        }
-        else if (gridCursor >= tag->EndAsLocalTime())
-        {
-          progIdx++;
-        }
-        else if (gridCursor < tag->EndAsLocalTime())
-        {
-          m_gridIndex[row][block].item = item;
-          break;
-        }
-        else
-        {
-          progIdx++;
-        }
-      }
+      if (entries[i].start >= gridEnd)
+        break;
 
-      gridCursor += blockDuration;
+      /* every block that starts before the end of this programme belongs to it. gaps are filled by the next programme */
+      while (block < m_blocks && gridStart + (time_t) block * MINSPERBLOCK * 60 < entries[i].end)
+        m_gridIndex[row][block++].item = m_programmeItems[entries[i].item];
     }
 
     /** FOR EACH BLOCK **********************************************************************/
@@ -969,7 +962,7 @@ bool CGUIEPGGridContainer::MoveChannel(bool direction)
 
 bool CGUIEPGGridContainer::MoveProgrammes(bool direction)
 {
-  if (!m_gridIndex || !m_item)
+  if (m_gridIndex.empty() || !m_item)
     return false;
 
   if (direction)
@@ -1307,7 +1300,7 @@ bool CGUIEPGGridContainer::OnMouseWheel(char wheel, const CPoint &point)
 
 int CGUIEPGGridContainer::GetSelectedItem() const
 {
-  if (!m_gridIndex || !m_epgItemsPtr.size())
+  if (m_gridIndex.empty() || !m_epgItemsPtr.size())
     return 0;
 
   CGUIListItemPtr currentItem = m_gridIndex[m_channelCursor + m_channelOffset][m_blockCursor + m_blockOffset].item;
@@ -1593,19 +1586,36 @@ CStdString CGUIEPGGridContainer::GetDescription() const
 
 void CGUIEPGGridContainer::ClearGridIndex(void)
 {
-  if (m_gridIndex)
+  for (unsigned int i = 0; i < m_gridIndex.size(); i++)
   {
-    for (unsigned int i = 0; i < m_channelItems.size(); i++)
+    for (unsigned int block = 0; block < m_gridIndex[i].size(); block++)
     {
-      for (int block = 0; block < m_blocks; block++)
-      {
-        if (m_gridIndex[i][block].item)
-          m_gridIndex[i][block].item.get()->ClearProperties();
-      }
-      free(m_gridIndex[i]);
+      if (m_gridIndex[i][block].item)
+        m_gridIndex[i][block].item.get()->ClearProperties();
     }
-    free(m_gridIndex);
   }
+  m_gridIndex.clear();
+}
+
+size_t CGUIEPGGridContainer::GetEntryAt(int channel, time_t time) const
+{
+  /* programmes don't overlap, so their end times are sorted too */
+  const std::vector<GridEntry> &entries = m_channelEntries[channel];
+  size_t first = 0;
+  size_t count = entries.size();
+  while (count > 0)
+  {
+    size_t step = count / 2;
+    if (entries[first + step].end <= time)
+    {
+      first += step + 1;
+      count -= step + 1;
+    }
+    else
+      count = step;
+  }
+
+  return first;
 }
 
 void CGUIEPGGridContainer::Reset()
@@ -1617,10 +1627,10 @@ void CGUIEPGGridContainer::Reset()
   m_programmeItems.clear();
   m_rulerItems.clear();
   m_epgItemsPtr.clear();
+  m_channelEntries.clear();
 
   m_lastItem    = NULL;
   m_lastChannel = NULL;
-  m_gridIndex   = NULL;
 }
 
 void CGUIEPGGridContainer::GoToBegin()
@@ -38,6 +38,8 @@ namespace EPG
 
   struct GridItemsPtr
   {
+    GridItemsPtr() : width(0), height(0) {}
+
     CGUIListItemPtr item;
     float width;
     float height;
@@ -111,6 +113,7 @@ namespace EPG
     void CalculateLayout();
     void Reset();
     void ClearGridIndex(void);
+    size_t GetEntryAt(int channel, time_t time) const;
 
     GridItemsPtr *GetItem(const int &channel);
     GridItemsPtr *GetNextItem(const int &channel);
@@ -143,6 +146,14 @@ namespace EPG
       long stop;
     };
     std::vector< ItemsPtr > m_epgItemsPtr;
+
+    struct GridEntry
+    {
+      time_t start; //! start time of the programme (local time)
+      time_t end;   //! end time of the programme (local time)
+      int    item;  //! index of the programme in m_programmeItems
+    };
+    std::vector< std::vector<GridEntry> > m_channelEntries; //! the programmes of each channel, sorted by start time
     std::vector< CGUIListItemPtr > m_channelItems;
     std::vector< CGUIListItemPtr > m_rulerItems;
     std::vector< CGUIListItemPtr > m_programmeItems;
@@ -206,7 +217,7 @@ namespace EPG
     CDateTime m_gridStart;
     CDateTime m_gridEnd;
 
-    struct GridItemsPtr **m_gridIndex;
+    std::vector< std::vector<GridItemsPtr> > m_gridIndex;
     GridItemsPtr *m_item;
     CGUIListItem *m_lastItem;
     CGUIListItem *m_lastChannel;
@@ -44,6 +44,7 @@
 #include "SpecialProtocol.h"
 #include "utils/CharsetConverter.h"
 #include "utils/log.h"
+#include "threads/SystemClock.h"
 
 using namespace XFILE;
 using namespace XCURL;
@@ -51,8 +52,22 @@ using namespace XCURL;
 #define XMIN(a,b) ((a)<(b)?(a):(b))
 #define FITS_INT(a) (((a) <= INT_MAX) && ((a) >= INT_MIN))
 
+// upper bound for the adaptive read-ahead, the ring buffer is three times this
+#define MAX_READAHEAD_SIZE (2 * 1024 * 1024)
+
 #define dllselect select
 
+// holds one of the per host request slots of the session pool for as long as it's in scope,
+// for requests performed in one go. streams hold theirs in their read state
+class CCurlHostSlot
+{
+public:
+  CCurlHostSlot(const CStdString &hostname) : m_hostname(hostname) { g_curlInterface.AcquireHostSlot(m_hostname); }
+  ~CCurlHostSlot() { g_curlInterface.ReleaseHostSlot(m_hostname); }
+private:
+  CStdString m_hostname;
+};
+
 // curl calls this routine to debug
 extern "C" int debug_callback(CURL_HANDLE *handle, curl_infotype info, char *output, size_t size, void *data)
 {
@@ -141,6 +156,7 @@ size_t CCurlFile::CReadState::HeaderCallback(void *ptr, size_t size, size_t nmem
 size_t CCurlFile::CReadState::WriteCallback(char *buffer, size_t size, size_t nitems)
 {
   unsigned int amount = size * nitems;
+  m_bytesReceived += amount;
 //  CLog::Log(LOGDEBUG, "CCurlFile::WriteCallback (%p) with %i bytes, readsize = %i, writesize = %i", this, amount, m_buffer.getMaxReadSize(), m_buffer.getMaxWriteSize() - m_overflowSize);
   if (m_overflowSize)
   {
@@ -199,6 +215,12 @@ CCurlFile::CReadState::CReadState()
   m_cancelled = false;
   m_bFirstLoop = true;
   m_headerdone = false;
+  m_connectTime = 0;
+  m_transferTime = 0;
+  m_bytesReceived = 0;
+  m_sampledTime = 0;
+  m_sampledBytes = 0;
+  m_connectPos = 0;
 }
 
 CCurlFile::CReadState::~CReadState()
@@ -209,7 +231,7 @@ CCurlFile::CReadState::~CReadState()
     g_curlInterface.easy_release(&m_easyHandle, &m_multiHandle);
 }
 
-bool CCurlFile::CReadState::Seek(int64_t pos)
+bool CCurlFile::CReadState::Seek(int64_t pos, unsigned int readThrough)
 {
   if(pos == m_filePos)
     return true;
@@ -246,9 +268,35 @@ bool CCurlFile::CReadState::Seek(int64_t pos)
     m_filePos = pos;
     return true;
   }
+
+  // small forward gaps are cheaper to read through than to re-request
+  if(pos > m_filePos && pos - m_filePos <= readThrough)
+  {
+    while(m_filePos < pos)
+    {
+      unsigned int want = (unsigned int)XMIN(pos - m_filePos, (int64_t)m_bufferSize);
+      if(!FillBuffer(want))
+        return false;
+
+      unsigned int len = XMIN((unsigned int)m_buffer.getMaxReadSize(), want);
+      if(len == 0 || !m_buffer.SkipBytes(len))
+        return false;
+      m_filePos += len;
+    }
+    return true;
+  }
   return false;
 }
 
+void CCurlFile::CReadState::AcquireHostSlot(const CStdString& hostname)
+{
+  if (!m_slotHost.IsEmpty())
+    return;
+
+  g_curlInterface.AcquireHostSlot(hostname);
+  m_slotHost = hostname;
+}
+
 long CCurlFile::CReadState::Connect(unsigned int size)
 {
   g_curlInterface.easy_setopt(m_easyHandle, CURLOPT_RESUME_FROM_LARGE, m_filePos);
@@ -259,6 +307,11 @@ long CCurlFile::CReadState::Connect(unsigned int size)
   m_buffer.Create(size * 3);
   m_headerdone = false;
 
+  m_bytesReceived = 0;
+  m_transferTime = 0;
+  m_connectPos = m_filePos;
+  unsigned int start = XbmcThreads::SystemClockMillis();
+
   // read some data in to try and obtain the length
   // maybe there's a better way to get this info??
   m_stillRunning = 1;
@@ -267,6 +320,10 @@ long CCurlFile::CReadState::Connect(unsigned int size)
     CLog::Log(LOGERROR, "CCurlFile::CReadState::Open, didn't get any data from stream.");
     return -1;
   }
+  m_connectTime = XbmcThreads::SystemClockMillis() - start;
+  // the wait for the first byte is latency, not transfer
+  m_sampledTime = m_transferTime;
+  m_sampledBytes = m_bytesReceived;
 
   double length;
   if (CURLE_OK == g_curlInterface.easy_getinfo(m_easyHandle, CURLINFO_CONTENT_LENGTH_DOWNLOAD, &length))
@@ -295,6 +352,44 @@ void CCurlFile::CReadState::Disconnect()
   m_filePos = 0;
   m_fileSize = 0;
   m_bufferSize = 0;
+
+  if (!m_slotHost.IsEmpty())
+  {
+    g_curlInterface.ReleaseHostSlot(m_slotHost);
+    m_slotHost.Empty();
+  }
+}
+
+void CCurlFile::CReadState::SampleTransfer(CReadAheadEstimator& estimator)
+{
+  estimator.AddTransfer(m_bytesReceived - m_sampledBytes, m_transferTime - m_sampledTime);
+  m_sampledBytes = m_bytesReceived;
+  m_sampledTime = m_transferTime;
+}
+
+void CCurlFile::CReadState::SetReadAhead(unsigned int size)
+{
+  if (size <= m_bufferSize)
+    return;
+
+  // keep what is buffered, the overflow buffer is drained into the new space on the next fill
+  CRingBuffer buffered;
+  unsigned int len = m_buffer.getMaxReadSize();
+  if (len && (!buffered.Create(len) || !buffered.Copy(m_buffer)))
+  {
+    CLog::Log(LOGWARNING, "%s - Failed to grow read-ahead to %u bytes", __FUNCTION__, size);
+    return;
+  }
+  m_buffer.Destroy();
+  if (m_buffer.Create(size * 3))
+    m_bufferSize = size;
+  else
+  {
+    CLog::Log(LOGWARNING, "%s - Failed to grow read-ahead to %u bytes", __FUNCTION__, size);
+    m_buffer.Create(m_bufferSize * 3);
+  }
+  if (len)
+    m_buffer.Copy(buffered);
 }
 
 
@@ -303,10 +398,12 @@ CCurlFile::~CCurlFile()
   if (m_opened)
     Close();
   delete m_state;
+  delete m_oldState;
   g_curlInterface.Unload();
 }
 
 CCurlFile::CCurlFile()
+ : m_readAhead(32768, MAX_READAHEAD_SIZE)
 {
   g_curlInterface.Load(); // loads the curl dll and resolves exports etc.
   m_curlAliasList = NULL;
@@ -327,6 +424,7 @@ CCurlFile::CCurlFile()
   m_password = "";
   m_httpauth = "";
   m_state = new CReadState();
+  m_oldState = NULL;
   m_skipshout = false;
 }
 
@@ -334,11 +432,14 @@ CCurlFile::CCurlFile()
 void CCurlFile::SetBufferSize(unsigned int size)
 {
   m_bufferSize = size;
+  m_readAhead.SetMinimum(size);
 }
 
 void CCurlFile::Close()
 {
   m_state->Disconnect();
+  delete m_oldState;
+  m_oldState = NULL;
 
   m_url.Empty();
   m_referer.Empty();
@@ -361,6 +462,10 @@ void CCurlFile::SetCommonOptions(CReadState* state)
 
   g_curlInterface.easy_reset(h);
 
+  // reuse cached dns lookups and ssl sessions from other handles
+  if (g_curlInterface.GetShare())
+    g_curlInterface.easy_setopt(h, CURLOPT_SHARE, g_curlInterface.GetShare());
+
   g_curlInterface.easy_setopt(h, CURLOPT_DEBUGFUNCTION, debug_callback);
 
   if( g_advancedSettings.m_logLevel >= LOG_LEVEL_DEBUG )
@@ -838,10 +943,14 @@ bool CCurlFile::Open(const CURL& url)
   SetCommonOptions(m_state);
   SetRequestHeaders(m_state);
 
-  long response = m_state->Connect(m_bufferSize);
+  // the slot is held for the whole transfer, until the state disconnects
+  m_state->AcquireHostSlot(url2.GetHostName());
+  long response = m_state->Connect(m_readAhead.GetReadAheadSize());
   if( response < 0 || response >= 400)
     return false;
 
+  m_readAhead.AddLatency(m_state->m_connectTime);
+
   SetCorrectHeaders(m_state);
 
   // since we can't know the stream size up front if we're gzipped/deflated
@@ -941,6 +1050,7 @@ bool CCurlFile::Exists(const CURL& url)
 
   ASSERT(m_state->m_easyHandle == NULL);
   g_curlInterface.easy_aquire(url2.GetProtocol(), url2.GetHostName(), &m_state->m_easyHandle, NULL);
+  CCurlHostSlot slot(url2.GetHostName());
 
   SetCommonOptions(m_state);
   SetRequestHeaders(m_state);
@@ -988,16 +1098,33 @@ int64_t CCurlFile::Seek(int64_t iFilePosition, int iWhence)
   // We can't seek beyond EOF
   if (m_state->m_fileSize && nextPos > m_state->m_fileSize) return -1;
 
-  if(m_state->Seek(nextPos))
+  unsigned int readThrough = m_readAhead.GetReadThroughSize();
+  if(m_state->Seek(nextPos, readThrough))
+    return nextPos;
+
+  // the previous session may still be positioned close to where we want to go
+  if(m_oldState && m_oldState->Seek(nextPos, readThrough))
+  {
+    CReadState* state = m_state;
+    m_state = m_oldState;
+    m_oldState = state;
     return nextPos;
+  }
 
   if(!m_seekable)
     return -1;
 
+  m_state->SampleTransfer(m_readAhead);
+
   CReadState* oldstate = NULL;
   if(m_multisession)
   {
     CURL url(m_url);
+    // the current session replaces the one kept from before, close that
+    // first so this file doesn't hold three of the host's request slots
+    delete m_oldState;
+    m_oldState = NULL;
+
     oldstate = m_state;
     m_state = new CReadState();
 
@@ -1016,7 +1143,8 @@ int64_t CCurlFile::Seek(int64_t iFilePosition, int iWhence)
   if (oldstate)
     m_state->m_fileSize = oldstate->m_fileSize;
 
-  long response = m_state->Connect(m_bufferSize);
+  m_state->AcquireHostSlot(CURL(m_url).GetHostName());
+  long response = m_state->Connect(m_readAhead.GetReadAheadSize());
   if(response < 0 && (m_state->m_fileSize == 0 || m_state->m_fileSize != m_state->m_filePos))
   {
     m_seekable = false;
@@ -1029,7 +1157,12 @@ int64_t CCurlFile::Seek(int64_t iFilePosition, int iWhence)
   }
 
   SetCorrectHeaders(m_state);
-  delete oldstate;
+  m_readAhead.AddLatency(m_state->m_connectTime);
+
+  // keep the old session around, demuxers tend to jump back and forth
+  // between a few positions while probing
+  if(oldstate)
+    m_oldState = oldstate;
 
   return m_state->m_filePos;
 }
@@ -1066,6 +1199,7 @@ int CCurlFile::Stat(const CURL& url, struct __stat64* buffer)
 
   ASSERT(m_state->m_easyHandle == NULL);
   g_curlInterface.easy_aquire(url2.GetProtocol(), url2.GetHostName(), &m_state->m_easyHandle, NULL);
+  CCurlHostSlot slot(url2.GetHostName());
 
   SetCommonOptions(m_state);
   SetRequestHeaders(m_state);
@@ -1156,12 +1290,40 @@ int CCurlFile::Stat(const CURL& url, struct __stat64* buffer)
   return 0;
 }
 
+unsigned int CCurlFile::Read(void* lpBuf, int64_t uiBufSize)
+{
+  unsigned int read = m_state->Read(lpBuf, uiBufSize);
+
+  // a sequential reader never gets to Seek, so keep the read-ahead in
+  // step with the link while the data comes in
+  if (m_state->m_bufferSize && m_state->m_bytesReceived - m_state->m_sampledBytes >= m_state->m_bufferSize)
+  {
+    m_state->SampleTransfer(m_readAhead);
+    m_state->SetReadAhead(m_readAhead.GetReadAheadSize());
+  }
+
+  // once the current session has been read well past its buffer the
+  // demuxer is done probing, don't hold on to a second connection
+  if (m_oldState && m_state->m_filePos - m_state->m_connectPos > 3 * (int64_t)m_state->m_bufferSize)
+  {
+    delete m_oldState;
+    m_oldState = NULL;
+  }
+
+  return read;
+}
+
 unsigned int CCurlFile::CReadState::Read(void* lpBuf, int64_t uiBufSize)
 {
   /* only request 1 byte, for truncated reads (only if not eof) */
   if((m_fileSize == 0 || m_filePos < m_fileSize) && !FillBuffer(1))
     return 0;
 
+  /* take in whatever else has arrived by now without waiting for more, so the
+   * read-ahead keeps filling while the caller works through the buffer */
+  if(m_stillRunning && m_buffer.getMaxWriteSize() > 0 && m_buffer.getMaxReadSize() < uiBufSize)
+    g_curlInterface.multi_perform(m_multiHandle, &m_stillRunning);
+
   /* ensure only available data is considered */
   unsigned int want = (unsigned int)XMIN(m_buffer.getMaxReadSize(), uiBufSize);
 
@@ -1211,6 +1373,7 @@ bool CCurlFile::CReadState::FillBuffer(unsigned int want)
       continue;
     }
 
+    unsigned int waitStart = XbmcThreads::SystemClockMillis();
     CURLMcode result = g_curlInterface.multi_perform(m_multiHandle, &m_stillRunning);
     if (!m_stillRunning)
     {
@@ -1312,6 +1475,7 @@ bool CCurlFile::CReadState::FillBuffer(unsigned int want)
           CLog::Log(LOGERROR, "%s - curl failed with socket error", __FUNCTION__);
           return false;
         }
+        m_transferTime += XbmcThreads::SystemClockMillis() - waitStart;
       }
       break;
       case CURLM_CALL_MULTI_PERFORM:
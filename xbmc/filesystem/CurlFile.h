@@ -22,6 +22,7 @@
 
 #include "IFile.h"
 #include "utils/RingBuffer.h"
+#include "utils/ReadAheadEstimator.h"
 #include <map>
 #include "utils/HttpHeader.h"
 
@@ -49,7 +50,7 @@ namespace XFILE
       virtual int  Stat(const CURL& url, struct __stat64* buffer);
       virtual void Close();
       virtual bool ReadString(char *szLine, int iLineLength)     { return m_state->ReadString(szLine, iLineLength); }
-      virtual unsigned int Read(void* lpBuf, int64_t uiBufSize)  { return m_state->Read(lpBuf, uiBufSize); }
+      virtual unsigned int Read(void* lpBuf, int64_t uiBufSize);
       virtual CStdString GetMimeType()                           { return m_state->m_httpheader.GetMimeType(); }
       virtual int IoControl(EIoControl request, void* param);
 
@@ -103,6 +104,16 @@ namespace XFILE
           int64_t         m_filePos;
           bool            m_bFirstLoop;
 
+          /* transfer statistics, used to size the read-ahead */
+          unsigned int    m_connectTime;      // time until the first data arrived
+          unsigned int    m_transferTime;     // time spent waiting on the network
+          int64_t         m_bytesReceived;    // bytes received since the request was issued
+          unsigned int    m_sampledTime;      // m_transferTime already passed on to the estimator
+          int64_t         m_sampledBytes;     // m_bytesReceived already passed on to the estimator
+          int64_t         m_connectPos;       // position the request was issued for
+
+          CStdString      m_slotHost;         // host whose request slot is held until Disconnect(), empty if none
+
           /* returned http header */
           CHttpHeader m_httpheader;
           bool        m_headerdone;
@@ -110,13 +121,16 @@ namespace XFILE
           size_t WriteCallback(char *buffer, size_t size, size_t nitems);
           size_t HeaderCallback(void *ptr, size_t size, size_t nmemb);
 
-          bool         Seek(int64_t pos);
+          bool         Seek(int64_t pos, unsigned int readThrough = 0);
           unsigned int Read(void* lpBuf, int64_t uiBufSize);
           bool         ReadString(char *szLine, int iLineLength);
           bool         FillBuffer(unsigned int want);
 
+          void         AcquireHostSlot(const CStdString& hostname);
           long         Connect(unsigned int size);
           void         Disconnect();
+          void         SampleTransfer(CReadAheadEstimator& estimator);
+          void         SetReadAhead(unsigned int size);
       };
 
     protected:
@@ -128,7 +142,9 @@ namespace XFILE
 
     private:
       CReadState*     m_state;
+      CReadState*     m_oldState;         // previous session, kept alive so seeking back can reuse it
       unsigned int    m_bufferSize;
+      CReadAheadEstimator m_readAhead;
 
       CStdString      m_url;
       CStdString      m_userAgent;
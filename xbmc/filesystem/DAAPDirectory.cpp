@@ -396,6 +396,23 @@ void CDAAPDirectory::AddToArtistAlbum(char *artist_s, char *album_s)
   }
 }
 
+CStdString CDAAPDirectory::GetDiskCacheValidator(const CStdString& strPath) const
+{
+  // the server bumps its revision whenever its library changes
+  CURL url(strPath);
+  CStdString host = url.GetHostName();
+  if (url.HasPort())
+    host.Format("%s:%i",url.GetHostName(),url.GetPort());
+
+  DAAP_SClientHost *pHost = g_DaapClient.GetHost(host);
+  if (!pHost)
+    return "";
+
+  CStdString validator;
+  validator.Format("%s-%i", pHost->sharename, pHost->revision_number);
+  return validator;
+}
+
 int CDAAPDirectory::GetCurrLevel(CStdString strPath)
 {
   int intSPos;
@@ -36,6 +36,8 @@ public:
   CDAAPDirectory(void);
   virtual ~CDAAPDirectory(void);
   virtual bool IsAllowed(const CStdString &strFile) const { return true; };
+  virtual bool AllowDiskCache(const CStdString& strPath) const { return true; };
+  virtual CStdString GetDiskCacheValidator(const CStdString& strPath) const;
   virtual bool GetDirectory(const CStdString& strPath, CFileItemList &items);
   //virtual void CloseDAAP(void);
   int GetCurrLevel(CStdString strPath);
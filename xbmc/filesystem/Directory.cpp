@@ -25,6 +25,7 @@
 #include "commons/Exception.h"
 #include "FileItem.h"
 #include "DirectoryCache.h"
+#include "DirectoryDiskCache.h"
 #include "settings/GUISettings.h"
 #include "utils/log.h"
 #include "utils/Job.h"
@@ -110,6 +111,14 @@ public:
 };
 
 
+static bool IsFiltered(const IDirectory &directory, const CFileItem &item, const CDirectory::CHints &hints)
+{
+  // TODO: we shouldn't be checking the gui setting here;
+  // callers should use getHidden instead
+  return (!item.m_bIsFolder && !directory.IsAllowed(item.GetPath())) ||
+         (item.GetProperty("file:hidden").asBoolean() && !(hints.flags & DIR_FLAG_GET_HIDDEN) && !g_guiSettings.GetBool("filelists.showhidden"));
+}
+
 CDirectory::CDirectory()
 {}
 
@@ -134,8 +143,20 @@ bool CDirectory::GetDirectory(const CStdString& strPath, CFileItemList &items, c
       return false;
 
     // check our cache for this path
-    if (g_directoryCache.GetDirectory(strPath, items, (hints.flags & DIR_FLAG_READ_CACHE) == DIR_FLAG_READ_CACHE))
+    boost::shared_ptr<const CFileItemList> cached;
+    if (g_directoryCache.GetDirectory(strPath, cached, (hints.flags & DIR_FLAG_READ_CACHE) == DIR_FLAG_READ_CACHE))
+    {
+      // the cached listing is shared, so copy out only the items that aren't filtered below
+      pDirectory->SetMask(hints.mask);
+      items.Copy(*cached, false);
+      for (int i = 0; i < cached->Size(); ++i)
+      {
+        const CFileItemPtr item = cached->Get(i);
+        if (!IsFiltered(*pDirectory, *item, hints))
+          items.Add(CFileItemPtr(new CFileItem(*item)));
+      }
       items.SetPath(strPath);
+    }
     else
     {
       // need to clear the cache (in case the directory fetch fails)
@@ -146,6 +167,29 @@ bool CDirectory::GetDirectory(const CStdString& strPath, CFileItemList &items, c
       pDirectory->SetFlags(hints.flags);
 
       bool result = false, cancel = false;
+
+      // slow sources may have the listing of an earlier visit on disk, a
+      // stale one is used right away and refreshed in the background
+      bool diskCache = !(hints.flags & DIR_FLAG_BYPASS_CACHE) && CDirectoryDiskCache::IsEnabled() && pDirectory->AllowDiskCache(realPath);
+      bool fromDiskCache = false;
+      CStdString validator;
+      if (diskCache)
+      {
+        // a slow validator (an HTTP request) is only checked by the background refresh
+        bool slowValidator = pDirectory->IsDiskCacheValidatorSlow(realPath);
+        if (!slowValidator)
+          validator = pDirectory->GetDiskCacheValidator(realPath);
+
+        bool stale = false;
+        if (g_directoryDiskCache.Load(realPath, slowValidator ? NULL : &validator, items, stale))
+        {
+          items.SetPath(strPath);
+          result = fromDiskCache = true;
+          if (stale)
+            g_directoryDiskCache.Refresh(strPath, hints.flags);
+        }
+      }
+
       while (!result && !cancel)
       {
         if (g_application.IsCurrentThread() && allowThreads && !URIUtils::IsSpecial(strPath))
@@ -189,23 +233,22 @@ bool CDirectory::GetDirectory(const CStdString& strPath, CFileItemList &items, c
         }
       }
 
+      if (diskCache && !fromDiskCache)
+        g_directoryDiskCache.Save(realPath, validator, items);
+
       // cache the directory, if necessary
       if (!(hints.flags & DIR_FLAG_BYPASS_CACHE))
         g_directoryCache.SetDirectory(strPath, items, pDirectory->GetCacheType(strPath));
-    }
 
-    // now filter for allowed files
-    pDirectory->SetMask(hints.mask);
-    for (int i = 0; i < items.Size(); ++i)
-    {
-      CFileItemPtr item = items[i];
-      // TODO: we shouldn't be checking the gui setting here;
-      // callers should use getHidden instead
-      if ((!item->m_bIsFolder && !pDirectory->IsAllowed(item->GetPath())) ||
-          (item->GetProperty("file:hidden").asBoolean() && !(hints.flags & DIR_FLAG_GET_HIDDEN) && !g_guiSettings.GetBool("filelists.showhidden")))
+      // now filter for allowed files, a cached listing was filtered while copying it
+      pDirectory->SetMask(hints.mask);
+      for (int i = 0; i < items.Size(); ++i)
       {
-        items.Remove(i);
-        i--; // don't confuse loop
+        if (IsFiltered(*pDirectory, *items[i], hints))
+        {
+          items.Remove(i);
+          i--; // don't confuse loop
+        }
       }
     }
 
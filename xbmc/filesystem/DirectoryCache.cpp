@@ -22,6 +22,9 @@
 #include "DirectoryCache.h"
 #include "settings/Settings.h"
 #include "FileItem.h"
+#include "video/VideoInfoTag.h"
+#include "music/tags/MusicInfoTag.h"
+#include "pictures/PictureInfoTag.h"
 #include "threads/SingleLock.h"
 #include "utils/log.h"
 #include "utils/URIUtils.h"
@@ -30,17 +33,16 @@
 using namespace std;
 using namespace XFILE;
 
-CDirectoryCache::CDir::CDir(DIR_CACHE_TYPE cacheType)
+CDirectoryCache::CDir::CDir(DIR_CACHE_TYPE cacheType, const boost::shared_ptr<CFileItemList> &items)
+  : m_Items(items)
 {
   m_cacheType = cacheType;
   m_lastAccess = 0;
-  m_Items = new CFileItemList;
-  m_Items->SetFastLookup(true);
+  m_size = EstimateSize(*m_Items);
 }
 
 CDirectoryCache::CDir::~CDir()
 {
-  delete m_Items;
 }
 
 void CDirectoryCache::CDir::SetLastAccess(unsigned int &accessCounter)
@@ -63,7 +65,7 @@ CDirectoryCache::~CDirectoryCache(void)
 {
 }
 
-bool CDirectoryCache::GetDirectory(const CStdString& strPath, CFileItemList &items, bool retrieveAll)
+bool CDirectoryCache::GetDirectory(const CStdString& strPath, boost::shared_ptr<const CFileItemList> &items, bool retrieveAll)
 {
   CSingleLock lock (m_cs);
 
@@ -71,21 +73,22 @@ bool CDirectoryCache::GetDirectory(const CStdString& strPath, CFileItemList &ite
   URIUtils::RemoveSlashAtEnd(storedPath);
 
   ciCache i = m_cache.find(storedPath);
-  if (i != m_cache.end())
-  {
-    CDir* dir = i->second;
-    if (dir->m_cacheType == XFILE::DIR_CACHE_ALWAYS ||
-       (dir->m_cacheType == XFILE::DIR_CACHE_ONCE && retrieveAll))
-    {
-      items.Copy(*dir->m_Items);
-      dir->SetLastAccess(m_accessCounter);
+  if (i == m_cache.end())
+    return false;
+
+  CDir* dir = i->second;
+  if (dir->m_cacheType != XFILE::DIR_CACHE_ALWAYS &&
+     (dir->m_cacheType != XFILE::DIR_CACHE_ONCE || !retrieveAll))
+    return false;
+
+  // the snapshot is never modified once other references exist, so the
+  // caller copies what it needs without blocking the cache
+  items = dir->m_Items;
+  dir->SetLastAccess(m_accessCounter);
 #ifdef _DEBUG
-      m_cacheHits+=items.Size();
+  m_cacheHits+=items->Size();
 #endif
-      return true;
-    }
-  }
-  return false;
+  return true;
 }
 
 void CDirectoryCache::SetDirectory(const CStdString& strPath, const CFileItemList &items, DIR_CACHE_TYPE cacheType)
@@ -104,6 +107,11 @@ void CDirectoryCache::SetDirectory(const CStdString& strPath, const CFileItemLis
   // IDEALLY, any further processing on the item would actually create a new item
   // instead of altering it, but we can't really enforce that in an easy way, so
   // this is the best solution for now.
+  boost::shared_ptr<CFileItemList> snapshot(new CFileItemList);
+  snapshot->SetFastLookup(true);
+  snapshot->Copy(items);
+  CDir* dir = new CDir(cacheType, snapshot);
+
   CSingleLock lock (m_cs);
 
   CStdString storedPath = URIUtils::SubstitutePath(strPath);
@@ -111,10 +119,8 @@ void CDirectoryCache::SetDirectory(const CStdString& strPath, const CFileItemLis
 
   ClearDirectory(storedPath);
 
-  CheckIfFull();
+  CheckIfFull(dir->m_size);
 
-  CDir* dir = new CDir(cacheType);
-  dir->m_Items->Copy(items);
   dir->SetLastAccess(m_accessCounter);
   m_cache.insert(pair<CStdString, CDir*>(storedPath, dir));
 }
@@ -168,8 +174,17 @@ void CDirectoryCache::AddFile(const CStdString& strFile)
   if (i != m_cache.end())
   {
     CDir *dir = i->second;
+    if (!dir->m_Items.unique())
+    {
+      // a reader is still copying the current snapshot, so modify a copy
+      boost::shared_ptr<CFileItemList> items(new CFileItemList);
+      items->SetFastLookup(true);
+      items->Copy(*dir->m_Items);
+      dir->m_Items = items;
+    }
     CFileItemPtr item(new CFileItem(strFile, false));
     dir->m_Items->Add(item);
+    dir->m_size += EstimateSize(*item);
     dir->SetLastAccess(m_accessCounter);
   }
 }
@@ -331,26 +346,64 @@ void CDirectoryCache::ClearMusicThumbCache()
   ClearCache(m_musicThumbDirs);
 }
 
-void CDirectoryCache::CheckIfFull()
+void CDirectoryCache::CheckIfFull(unsigned int newSize)
 {
   CSingleLock lock (m_cs);
-  static const unsigned int max_cached_dirs = 10;
+  static const unsigned int max_cached_bytes = 32 * 1024 * 1024;
+  // the size is only an estimate, and every lookup of the oldest folder walks them all
+  static const unsigned int max_cached_dirs = 100;
 
-  // find the last accessed folder, and remove if the number of cached folders is too many
-  iCache lastAccessed = m_cache.end();
-  unsigned int numCached = 0;
-  for (iCache i = m_cache.begin(); i != m_cache.end(); i++)
+  // remove the least recently accessed folders until the new listing fits
+  while (true)
   {
-    // ensure dirs that are always cached aren't cleared
-    if (!IsCacheDir(i->first) && i->second->m_cacheType != DIR_CACHE_ALWAYS)
+    iCache lastAccessed = m_cache.end();
+    unsigned int cachedSize = 0;
+    unsigned int cachedDirs = 0;
+    for (iCache i = m_cache.begin(); i != m_cache.end(); i++)
     {
-      if (lastAccessed == m_cache.end() || i->second->GetLastAccess() < lastAccessed->second->GetLastAccess())
-        lastAccessed = i;
-      numCached++;
+      // ensure dirs that are always cached aren't cleared
+      if (!IsCacheDir(i->first) && i->second->m_cacheType != DIR_CACHE_ALWAYS)
+      {
+        if (lastAccessed == m_cache.end() || i->second->GetLastAccess() < lastAccessed->second->GetLastAccess())
+          lastAccessed = i;
+        cachedSize += i->second->m_size;
+        cachedDirs++;
+      }
     }
-  }
-  if (lastAccessed != m_cache.end() && numCached >= max_cached_dirs)
+    if (lastAccessed == m_cache.end() || (cachedSize + newSize <= max_cached_bytes && cachedDirs < max_cached_dirs))
+      break;
     Delete(lastAccessed);
+  }
+}
+
+unsigned int CDirectoryCache::EstimateSize(const CFileItem &item)
+{
+  unsigned int size = sizeof(CFileItem) + item.GetPath().size() + item.GetLabel().size() + item.GetLabel2().size() +
+                      item.GetThumbnailImage().size() + item.GetIconImage().size() + item.EstimatePropertiesSize();
+  // tags are counted with their free text and artwork urls, which dwarf the rest of them
+  if (item.HasVideoInfoTag())
+  {
+    const CVideoInfoTag *tag = item.GetVideoInfoTag();
+    size += sizeof(CVideoInfoTag) + tag->m_strPlot.size() + tag->m_strPlotOutline.size() +
+            tag->m_strPictureURL.m_xml.size() + tag->m_fanart.m_xml.size() +
+            tag->m_cast.size() * sizeof(SActorInfo);
+  }
+  if (item.HasMusicInfoTag())
+  {
+    const MUSIC_INFO::CMusicInfoTag *tag = item.GetMusicInfoTag();
+    size += sizeof(MUSIC_INFO::CMusicInfoTag) + tag->GetComment().size() + tag->GetLyrics().size();
+  }
+  if (item.HasPictureInfoTag())
+    size += sizeof(CPictureInfoTag);
+  return size;
+}
+
+unsigned int CDirectoryCache::EstimateSize(const CFileItemList &items)
+{
+  unsigned int size = sizeof(CFileItemList);
+  for (int i = 0; i < items.Size(); i++)
+    size += EstimateSize(*items[i]);
+  return size;
 }
 
 void CDirectoryCache::Delete(iCache it)
@@ -368,6 +421,7 @@ void CDirectoryCache::PrintStats() const
   // run through and find the oldest and the number of items cached
   unsigned int oldest = UINT_MAX;
   unsigned int numItems = 0;
+  unsigned int numBytes = 0;
   unsigned int numDirs = 0;
   for (ciCache i = m_cache.begin(); i != m_cache.end(); i++)
   {
@@ -376,9 +430,10 @@ void CDirectoryCache::PrintStats() const
       CDir *dir = i->second;
       oldest = min(oldest, dir->GetLastAccess());
       numItems += dir->m_Items->Size();
+      numBytes += dir->m_size;
       numDirs++;
     }
   }
-  CLog::Log(LOGDEBUG, "%s - %u folders cached, with %u items total.  Oldest is %u, current is %u", __FUNCTION__, numDirs, numItems, oldest, m_accessCounter);
+  CLog::Log(LOGDEBUG, "%s - %u folders cached, with %u items total (%u KB).  Oldest is %u, current is %u", __FUNCTION__, numDirs, numItems, numBytes / 1024, oldest, m_accessCounter);
 }
 #endif
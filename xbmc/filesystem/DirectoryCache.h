@@ -27,6 +27,8 @@
 #include <map>
 #include <set>
 
+#include <boost/shared_ptr.hpp>
+
 class CFileItem;
 
 namespace XFILE
@@ -36,21 +38,29 @@ namespace XFILE
     class CDir
     {
     public:
-      CDir(DIR_CACHE_TYPE cacheType);
+      CDir(DIR_CACHE_TYPE cacheType, const boost::shared_ptr<CFileItemList> &items);
       virtual ~CDir();
 
       void SetLastAccess(unsigned int &accessCounter);
       unsigned int GetLastAccess() const { return m_lastAccess; };
 
-      CFileItemList* m_Items;
+      /*! \brief Snapshot of the listing, shared with readers copying it out.
+       Never modified while anyone else holds a reference.
+       */
+      boost::shared_ptr<CFileItemList> m_Items;
       DIR_CACHE_TYPE m_cacheType;
+      unsigned int m_size; ///< estimated memory use of the listing in bytes
     private:
       unsigned int m_lastAccess;
     };
   public:
     CDirectoryCache(void);
     virtual ~CDirectoryCache(void);
-    bool GetDirectory(const CStdString& strPath, CFileItemList &items, bool retrieveAll = false);
+    /*! \brief Get a cached listing
+     \param items [out] the listing, shared with the cache and other readers. It must not be
+     modified, callers copy out the items they keep.
+     */
+    bool GetDirectory(const CStdString& strPath, boost::shared_ptr<const CFileItemList> &items, bool retrieveAll = false);
     void SetDirectory(const CStdString& strPath, const CFileItemList &items, DIR_CACHE_TYPE cacheType);
     void ClearDirectory(const CStdString& strPath);
     void ClearFile(const CStdString& strFile);
@@ -69,7 +79,9 @@ namespace XFILE
     void InitCache(std::set<CStdString>& dirs);
     void ClearCache(std::set<CStdString>& dirs);
     bool IsCacheDir(const CStdString &strPath) const;
-    void CheckIfFull();
+    void CheckIfFull(unsigned int newSize);
+    static unsigned int EstimateSize(const CFileItem &item);
+    static unsigned int EstimateSize(const CFileItemList &items);
 
     std::map<CStdString, CDir*> m_cache;
     typedef std::map<CStdString, CDir*>::iterator iCache;
@@ -0,0 +1,250 @@
+/*
+ *      Copyright (C) 2012 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+ *  http://www.gnu.org/copyleft/gpl.html
+ *
+ */
+
+
+#include "DirectoryDiskCache.h"
+#include "DirectoryCache.h"
+#include "DirectoryFactory.h"
+#include "File.h"
+#include "FileItem.h"
+#include "GUIUserMessages.h"
+#include "guilib/GUIWindowManager.h"
+#include "settings/AdvancedSettings.h"
+#include "threads/SingleLock.h"
+#include "utils/Archive.h"
+#include "utils/Crc32.h"
+#include "utils/Job.h"
+#include "utils/JobManager.h"
+#include "utils/log.h"
+#include "utils/URIUtils.h"
+
+#include <time.h>
+
+#define DISKCACHE_VERSION 2
+
+using namespace std;
+using namespace XFILE;
+
+// Refetches a stale listing straight from its IDirectory, so neither the
+// caches nor the filtering CDirectory does for its callers get in the way
+class CDirectoryRefreshJob : public CJob
+{
+public:
+  CDirectoryRefreshJob(const CStdString &strPath, int flags)
+    : m_strPath(strPath), m_flags(flags)
+  {
+  }
+
+  virtual const char *GetType() const { return "directoryrefresh"; }
+
+  virtual bool DoWork()
+  {
+    bool result = Refresh();
+    g_directoryDiskCache.OnRefreshed(m_strPath);
+    return result;
+  }
+
+private:
+  bool Refresh()
+  {
+    CStdString realPath = URIUtils::SubstitutePath(m_strPath);
+    auto_ptr<IDirectory> pDirectory(CDirectoryFactory::Create(realPath));
+    if (!pDirectory.get())
+      return false;
+
+    // nobody is around to answer prompts or watch progress
+    pDirectory->SetFlags((m_flags & ~DIR_FLAG_ALLOW_PROMPT) | DIR_FLAG_NO_PROGRESS);
+
+    // a slow validator wasn't checked when the listing was shown, so do that
+    // now. If the source didn't change, the listing is good for another TTL.
+    CStdString validator;
+    bool slowValidator = pDirectory->IsDiskCacheValidatorSlow(realPath);
+    if (slowValidator)
+    {
+      validator = pDirectory->GetDiskCacheValidator(realPath);
+
+      CFileItemList cached;
+      bool stale;
+      if (!validator.IsEmpty() && g_directoryDiskCache.Load(realPath, &validator, cached, stale))
+      {
+        g_directoryDiskCache.Save(realPath, validator, cached);
+        return true;
+      }
+    }
+
+    CFileItemList items;
+    items.SetPath(m_strPath);
+    if (!pDirectory->GetDirectory(realPath, items))
+    {
+      CLog::Log(LOGDEBUG, "%s - failed to refresh %s, keeping the cached listing", __FUNCTION__, m_strPath.c_str());
+      return false;
+    }
+
+    if (!slowValidator)
+      validator = pDirectory->GetDiskCacheValidator(realPath);
+
+    CFileItemList cached;
+    bool stale;
+    bool changed = !g_directoryDiskCache.Load(realPath, NULL, cached, stale) || !SameListing(cached, items);
+
+    g_directoryDiskCache.Save(realPath, validator, items);
+    g_directoryCache.ClearDirectory(m_strPath);
+
+    if (changed)
+    {
+      CGUIMessage msg(GUI_MSG_NOTIFY_ALL, 0, 0, GUI_MSG_UPDATE_PATH);
+      msg.SetStringParam(m_strPath);
+      g_windowManager.SendThreadMessage(msg);
+    }
+    return true;
+  }
+
+  static bool SameListing(const CFileItemList &a, const CFileItemList &b)
+  {
+    if (a.Size() != b.Size())
+      return false;
+
+    for (int i = 0; i < a.Size(); i++)
+    {
+      if (a[i]->GetPath() != b[i]->GetPath() || a[i]->GetLabel() != b[i]->GetLabel())
+        return false;
+    }
+    return true;
+  }
+
+  CStdString m_strPath;
+  int m_flags;
+};
+
+CDirectoryDiskCache::CDirectoryDiskCache()
+{
+}
+
+CDirectoryDiskCache::~CDirectoryDiskCache()
+{
+}
+
+bool CDirectoryDiskCache::IsEnabled()
+{
+  return g_advancedSettings.m_iListingCacheTTL > 0;
+}
+
+CStdString CDirectoryDiskCache::GetCacheFile(const CStdString &strPath)
+{
+  CStdString path(strPath);
+  URIUtils::RemoveSlashAtEnd(path);
+
+  Crc32 crc;
+  crc.Compute(path); // plugin query strings are case sensitive
+
+  CStdString cacheFile;
+  cacheFile.Format("special://temp/dc-%08x.fi", (unsigned __int32)crc);
+  return cacheFile;
+}
+
+bool CDirectoryDiskCache::Load(const CStdString &strPath, const CStdString *validator, CFileItemList &items, bool &stale)
+{
+  CStdString cacheFile(GetCacheFile(strPath));
+
+  CSingleLock lock(m_cs);
+  CFile file;
+  if (!file.Open(cacheFile))
+    return false;
+
+  CArchive ar(&file, CArchive::load);
+
+  int version;
+  CStdString path, storedValidator;
+  int64_t stored = 0;
+  ar >> version;
+  if (version == DISKCACHE_VERSION)
+    ar >> path >> storedValidator >> stored;
+
+  int64_t age = (int64_t)time(NULL) - stored;
+  bool expired = age < 0 || age > (int64_t)g_advancedSettings.m_iListingCacheTTL + g_advancedSettings.m_iListingCacheStaleTime;
+  if (version != DISKCACHE_VERSION || path != strPath || (validator && storedValidator != *validator) || expired)
+  {
+    ar.Close();
+    file.Close();
+    // don't throw away what a colliding path stored. A listing with another
+    // validator is overwritten by the fetch that follows, unless that fails
+    if (version != DISKCACHE_VERSION || (path == strPath && expired))
+      CFile::Delete(cacheFile);
+    return false;
+  }
+
+  ar >> items;
+  ar.Close();
+  file.Close();
+
+  stale = age > (int64_t)g_advancedSettings.m_iListingCacheTTL;
+  CLog::Log(LOGDEBUG, "%s - using %s listing of %s (%i items, %"PRId64" seconds old)", __FUNCTION__,
+            stale ? "stale" : "cached", strPath.c_str(), items.Size(), age);
+  return true;
+}
+
+void CDirectoryDiskCache::Save(const CStdString &strPath, const CStdString &validator, CFileItemList &items)
+{
+  // the source asked for its listing not to be cached (e.g. a plugin's cacheToDisc)
+  if (!items.CacheToDiscAlways() && !items.CacheToDiscIfSlow())
+  {
+    Remove(strPath);
+    return;
+  }
+
+  CSingleLock lock(m_cs);
+  CFile file;
+  if (!file.OpenForWrite(GetCacheFile(strPath), true))
+    return;
+
+  CArchive ar(&file, CArchive::store);
+  ar << (int)DISKCACHE_VERSION;
+  ar << strPath;
+  ar << validator;
+  ar << (int64_t)time(NULL);
+  ar << items;
+  ar.Close();
+  file.Close();
+}
+
+void CDirectoryDiskCache::Remove(const CStdString &strPath)
+{
+  CStdString cacheFile(GetCacheFile(strPath));
+  CSingleLock lock(m_cs);
+  if (CFile::Exists(cacheFile))
+    CFile::Delete(cacheFile);
+}
+
+void CDirectoryDiskCache::Refresh(const CStdString &strPath, int flags)
+{
+  CSingleLock lock(m_cs);
+  // one refresh per listing is enough
+  if (!m_refreshing.insert(strPath).second)
+    return;
+
+  CJobManager::GetInstance().AddJob(new CDirectoryRefreshJob(strPath, flags), NULL, CJob::PRIORITY_LOW);
+}
+
+void CDirectoryDiskCache::OnRefreshed(const CStdString &strPath)
+{
+  CSingleLock lock(m_cs);
+  m_refreshing.erase(strPath);
+}
@@ -0,0 +1,83 @@
+#pragma once
+/*
+ *      Copyright (C) 2012 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+ *  http://www.gnu.org/copyleft/gpl.html
+ *
+ */
+
+
+#include "utils/StdString.h"
+#include "threads/CriticalSection.h"
+
+#include <set>
+
+class CFileItemList;
+
+namespace XFILE
+{
+  /*!
+   \ingroup filesystem
+   \brief Listings of slow sources (plugins, DAAP, HTTP) kept on disk
+   across sessions. Off unless the listing cache TTL is set.
+
+   A listing is only used while the validator of its source still matches:
+   the addon version for plugins, the library revision for DAAP and the
+   ETag or Last-Modified header for HTTP. A listing younger than the TTL is
+   used as is. An older one is still used while it's within the stale time,
+   but is refetched in the background, and windows showing it are told to
+   update once the new listing is in. Validators that take a request to the
+   source (HTTP) are only checked in the background, where a listing whose
+   validator still matches is kept for another TTL without refetching it.
+   \sa IDirectory::AllowDiskCache, IDirectory::GetDiskCacheValidator
+   */
+  class CDirectoryDiskCache
+  {
+  public:
+    CDirectoryDiskCache();
+    virtual ~CDirectoryDiskCache();
+
+    static bool IsEnabled();
+
+    /*!
+     \brief Load a cached listing
+     \param strPath the directory
+     \param validator has to match the one the listing was saved with, NULL to accept any
+     \param items [out] the listing
+     \param stale [out] true if the listing should be refreshed
+     \return true if there is a listing that may be used
+     */
+    bool Load(const CStdString &strPath, const CStdString *validator, CFileItemList &items, bool &stale);
+    void Save(const CStdString &strPath, const CStdString &validator, CFileItemList &items);
+    void Remove(const CStdString &strPath);
+
+    /*!
+     \brief Refetch a listing in the background
+     \param strPath the directory, as shown by the windows
+     \param flags the DIR_FLAGs it was fetched with
+     */
+    void Refresh(const CStdString &strPath, int flags);
+    void OnRefreshed(const CStdString &strPath);
+
+  private:
+    static CStdString GetCacheFile(const CStdString &strPath);
+
+    CCriticalSection m_cs; ///< also held while a cache file is read or written, the refresh jobs rewrite them
+    std::set<CStdString> m_refreshing;
+  };
+}
+extern XFILE::CDirectoryDiskCache g_directoryDiskCache;
@@ -0,0 +1,338 @@
+/*
+ *      Copyright (C) 2012 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+ *  http://www.gnu.org/copyleft/gpl.html
+ *
+ */
+
+
+#include "DirectoryWalker.h"
+#include "Directory.h"
+#include "FileItem.h"
+#include "URL.h"
+#include "threads/Event.h"
+#include "threads/SingleLock.h"
+#include "threads/SystemClock.h"
+#include "utils/Job.h"
+#include "utils/JobManager.h"
+#include "utils/log.h"
+
+using namespace std;
+using namespace XFILE;
+
+// at most this many listings are fetched or waiting to be picked up at once
+#define MAX_FETCH_AHEAD 32
+
+class CDirectoryWalker::CFetch
+{
+public:
+  enum State
+  {
+    QUEUED = 0, ///< not handed to the job manager yet
+    FETCHING,   ///< counted against its host
+    READY       ///< done, no longer counted against its host
+  };
+
+  CFetch(const CStdString &strPath, const CStdString &host)
+    : m_path(strPath), m_host(host), m_state(QUEUED), m_jobID(0),
+      m_started(false), m_claimed(false), m_done(false), m_result(false)
+  {
+  }
+
+  bool IsDone()
+  {
+    CSingleLock lock(m_section);
+    return m_done;
+  }
+
+  const CStdString m_path;
+  const CStdString m_host;
+
+  // owned by the walker
+  State        m_state;
+  unsigned int m_jobID;
+
+  // shared with the fetch job
+  CCriticalSection m_section;
+  bool          m_started; ///< the job has begun fetching
+  bool          m_claimed; ///< the job isn't wanted any more, and mustn't begin
+  bool          m_done;
+  bool          m_result;
+  CFileItemList m_items;   ///< only touched by the job until m_done is set
+};
+
+class CDirectoryWalker::CFetchJob : public CJob
+{
+public:
+  CFetchJob(const CFetchPtr &fetch, const boost::shared_ptr<CEvent> &fetched,
+            const CStdString &strMask, int flags)
+    : m_fetch(fetch), m_fetched(fetched), m_mask(strMask), m_flags(flags)
+  {
+  }
+
+  virtual const char *GetType() const { return "directoryfetch"; }
+
+  virtual bool DoWork()
+  {
+    {
+      CSingleLock lock(m_fetch->m_section);
+      if (m_fetch->m_claimed)
+        return false;
+      m_fetch->m_started = true;
+    }
+
+    bool result = CDirectory::GetDirectory(m_fetch->m_path, m_fetch->m_items, m_mask, m_flags);
+
+    {
+      CSingleLock lock(m_fetch->m_section);
+      m_fetch->m_result = result;
+      m_fetch->m_done = true;
+    }
+    m_fetched->Set();
+    return result;
+  }
+
+private:
+  CFetchPtr  m_fetch;
+  boost::shared_ptr<CEvent> m_fetched;
+  CStdString m_mask;
+  int        m_flags;
+};
+
+CDirectoryWalker::CDirectoryWalker(const CStdString &strMask, int flags, unsigned int maxPerHost)
+  : m_mask(strMask), m_flags(flags), m_maxPerHost(maxPerHost), m_cancelled(false),
+    m_fetched(new CEvent), m_listings(0), m_fetchedAhead(0), m_waitTime(0)
+{
+}
+
+CDirectoryWalker::~CDirectoryWalker()
+{
+  Cancel();
+  // compare with maxPerHost 0 to see what fetching ahead gains on a given share
+  if (m_listings > 0)
+    CLog::Log(LOGDEBUG, "%s - %u listings, %u fetched ahead, %u ms spent waiting on them",
+              __FUNCTION__, m_listings, m_fetchedAhead, m_waitTime);
+}
+
+bool CDirectoryWalker::GetDirectory(const CStdString &strPath, CFileItemList &items, bool recurse)
+{
+  unsigned int start = XbmcThreads::SystemClockMillis();
+  bool ahead = false;
+  bool result = GetDirectory(strPath, items, recurse, ahead);
+
+  CSingleLock lock(m_section);
+  m_listings++;
+  if (ahead)
+    m_fetchedAhead++;
+  m_waitTime += XbmcThreads::SystemClockMillis() - start;
+  return result;
+}
+
+bool CDirectoryWalker::GetDirectory(const CStdString &strPath, CFileItemList &items, bool recurse, bool &ahead)
+{
+  items.Clear();
+
+  CSingleLock lock(m_section);
+  if (m_cancelled)
+    return false;
+
+  CFetchPtr fetch;
+  for (FetchList::iterator i = m_fetches.begin(); i != m_fetches.end(); ++i)
+  {
+    if ((*i)->m_path == strPath)
+    {
+      fetch = *i;
+      break;
+    }
+  }
+
+  bool fetched = false;
+  bool result = false;
+  if (fetch)
+  {
+    // the caller has moved past everything ahead of this one
+    while (m_fetches.front() != fetch)
+    {
+      Drop(m_fetches.front());
+      m_fetches.pop_front();
+    }
+    m_fetches.pop_front();
+
+    while (fetch->m_state == CFetch::FETCHING)
+    {
+      {
+        CSingleLock fetchLock(fetch->m_section);
+        if (fetch->m_done)
+          break;
+        if (!fetch->m_started)
+        { // still waiting on a worker - quicker to fetch it ourselves
+          fetch->m_claimed = true;
+          break;
+        }
+      }
+      {
+        CSingleExit exit(m_section);
+        m_fetched->Wait();
+      }
+      if (m_cancelled)
+        return false;
+      Dispatch();
+    }
+
+    if (fetch->m_state == CFetch::FETCHING)
+    {
+      CJobManager::GetInstance().CancelJob(fetch->m_jobID);
+      m_hosts[fetch->m_host]--;
+      fetch->m_state = CFetch::READY;
+    }
+
+    if (fetch->IsDone() && fetch->m_result)
+    {
+      items.Assign(fetch->m_items);
+      fetched = result = ahead = true;
+    }
+  }
+
+  if (!fetched)
+  { // not fetched ahead, or it failed - fetch it here so the caller gets any prompts
+    CSingleExit exit(m_section);
+    result = CDirectory::GetDirectory(strPath, items, m_mask, m_flags);
+  }
+
+  if (m_cancelled)
+    return false;
+
+  if (result && recurse && m_maxPerHost)
+  {
+    Queue(items);
+    Dispatch();
+  }
+  return result;
+}
+
+void CDirectoryWalker::Cancel()
+{
+  CSingleLock lock(m_section);
+  m_cancelled = true;
+  for (FetchList::iterator i = m_fetches.begin(); i != m_fetches.end(); ++i)
+    Drop(*i);
+  m_fetches.clear();
+  m_dropped.clear();
+  m_hosts.clear();
+  m_fetched->Set();
+}
+
+bool CDirectoryWalker::IsCancelled() const
+{
+  return m_cancelled;
+}
+
+void CDirectoryWalker::Queue(const CFileItemList &items)
+{
+  // subfolders are walked before anything already queued
+  FetchList::iterator pos = m_fetches.begin();
+  for (int i = 0; i < items.Size(); i++)
+  {
+    const CFileItemPtr item = items[i];
+    if (!item->m_bIsFolder || item->IsParentFolder())
+      continue;
+    m_fetches.insert(pos, CFetchPtr(new CFetch(item->GetPath(), GetHost(item->GetPath()))));
+  }
+}
+
+void CDirectoryWalker::Dispatch()
+{
+  // stop counting anything that has come in
+  for (FetchList::iterator i = m_fetches.begin(); i != m_fetches.end(); ++i)
+  {
+    if ((*i)->m_state == CFetch::FETCHING && (*i)->IsDone())
+    {
+      m_hosts[(*i)->m_host]--;
+      (*i)->m_state = CFetch::READY;
+    }
+  }
+  for (FetchList::iterator i = m_dropped.begin(); i != m_dropped.end(); )
+  {
+    if ((*i)->IsDone())
+    {
+      m_hosts[(*i)->m_host]--;
+      i = m_dropped.erase(i);
+    }
+    else
+      ++i;
+  }
+
+  // and start on whatever is expected soonest
+  unsigned int ahead = 0;
+  for (FetchList::iterator i = m_fetches.begin(); i != m_fetches.end() && ahead < MAX_FETCH_AHEAD; ++i)
+  {
+    CFetchPtr fetch = *i;
+    if (fetch->m_state == CFetch::QUEUED)
+    {
+      if (m_hosts[fetch->m_host] >= GetMaxFetches(fetch->m_host))
+        continue;
+      fetch->m_jobID = CJobManager::GetInstance().AddJob(new CFetchJob(fetch, m_fetched, m_mask, m_flags | DIR_FLAG_NO_PROGRESS),
+                                                         NULL, CJob::PRIORITY_NORMAL);
+      fetch->m_state = CFetch::FETCHING;
+      m_hosts[fetch->m_host]++;
+    }
+    ahead++;
+  }
+}
+
+void CDirectoryWalker::Drop(const CFetchPtr &fetch)
+{
+  if (fetch->m_state != CFetch::FETCHING)
+    return;
+
+  bool running;
+  {
+    CSingleLock lock(fetch->m_section);
+    fetch->m_claimed = true;
+    running = fetch->m_started && !fetch->m_done;
+  }
+  CJobManager::GetInstance().CancelJob(fetch->m_jobID);
+  if (running)
+  { // can't be stopped - keep counting it against its host until it's done
+    m_dropped.push_back(fetch);
+    return;
+  }
+  m_hosts[fetch->m_host]--;
+}
+
+CStdString CDirectoryWalker::GetHost(const CStdString &strPath)
+{
+  CURL url(strPath);
+  // smb and nfs serialize every call behind one library wide lock, whatever the host
+  if (IsSerialized(url.GetProtocol()))
+    return url.GetProtocol() + "://";
+  return url.GetProtocol() + "://" + url.GetHostName();
+}
+
+bool CDirectoryWalker::IsSerialized(const CStdString &protocol)
+{
+  return protocol.Equals("smb") || protocol.Equals("nfs");
+}
+
+unsigned int CDirectoryWalker::GetMaxFetches(const CStdString &host) const
+{
+  // more fetches than one would only tie up job workers waiting on the lock,
+  // a single one still overlaps with what the caller does with its listing
+  if (m_maxPerHost > 1 && IsSerialized(CURL(host).GetProtocol()))
+    return 1;
+  return m_maxPerHost;
+}
@@ -0,0 +1,110 @@
+#pragma once
+/*
+ *      Copyright (C) 2012 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+ *  http://www.gnu.org/copyleft/gpl.html
+ *
+ */
+
+
+#include "utils/StdString.h"
+#include "threads/CriticalSection.h"
+#include "IDirectory.h"
+
+#include <list>
+#include <map>
+#include <boost/shared_ptr.hpp>
+
+class CFileItemList;
+class CEvent;
+
+namespace XFILE
+{
+  /*!
+   \ingroup filesystem
+   \brief Fetches the listings of a recursive walk ahead of time.
+
+   Walking a tree on a network share is usually bound by the round trip of
+   each listing rather than by bandwidth. Used in place of
+   CDirectory::GetDirectory inside a depth-first recursion, the walker fetches
+   the subfolders of every listing it hands out on the job manager, a few at
+   a time per host, so they are mostly in by the time the recursion gets to
+   them. Listings are still handed out in the order the caller asks for them.
+
+   Subfolders the caller skips are dropped as soon as it asks for a folder
+   that comes after them. Any path the walker hasn't seen is simply fetched
+   on the calling thread.
+   \sa CDirectory
+   */
+  class CDirectoryWalker
+  {
+  public:
+    /*!
+     \param strMask the mask every listing is fetched with
+     \param flags the DIR_FLAG flags every listing is fetched with
+     \param maxPerHost how many listings may be fetched at once from one host, 0 disables fetching ahead.
+     smb and nfs get one fetch at most, as those libraries serialize every call.
+     */
+    CDirectoryWalker(const CStdString &strMask = "", int flags = DIR_FLAG_DEFAULTS, unsigned int maxPerHost = 4);
+    virtual ~CDirectoryWalker();
+
+    /*!
+     \brief Get a listing, and start fetching its subfolders
+     \param strPath the directory
+     \param items [out] the listing
+     \param recurse false if the caller won't descend into the subfolders of this listing
+     \return true if the listing was retrieved, false on failure or if the walk was cancelled
+     */
+    bool GetDirectory(const CStdString &strPath, CFileItemList &items, bool recurse = true);
+
+    /*!
+     \brief Stop the walk, dropping anything fetched ahead. May be called from any thread.
+     Any GetDirectory call waiting on a listing fails.
+     */
+    void Cancel();
+    bool IsCancelled() const;
+
+  private:
+    class CFetch;
+    class CFetchJob;
+    typedef boost::shared_ptr<CFetch> CFetchPtr;
+    typedef std::list<CFetchPtr> FetchList;
+
+    bool GetDirectory(const CStdString &strPath, CFileItemList &items, bool recurse, bool &ahead);
+    void Queue(const CFileItemList &items);
+    void Dispatch();
+    void Drop(const CFetchPtr &fetch);
+    static CStdString GetHost(const CStdString &strPath);
+    static bool IsSerialized(const CStdString &protocol);
+    unsigned int GetMaxFetches(const CStdString &host) const;
+
+    CStdString   m_mask;
+    int          m_flags;
+    unsigned int m_maxPerHost;
+    bool         m_cancelled;
+
+    FetchList    m_fetches;                     ///< folders expected next, in depth-first order
+    FetchList    m_dropped;                     ///< skipped folders whose fetch is still running
+    std::map<CStdString, unsigned int> m_hosts; ///< listings being fetched per host
+    boost::shared_ptr<CEvent> m_fetched;        ///< set whenever a listing comes in
+    CCriticalSection m_section;
+
+    unsigned int m_listings;                    ///< listings handed out
+    unsigned int m_fetchedAhead;                ///< ... of which were fetched ahead
+    unsigned int m_waitTime;                    ///< ms the caller spent in GetDirectory
+  };
+}
@@ -25,17 +25,38 @@
 #include "threads/SingleLock.h"
 #include "utils/log.h"
 #include "utils/TimeUtils.h"
+#include "settings/AdvancedSettings.h"
 
 #include <assert.h>
+#include <algorithm>
 
 using namespace XCURL;
 
+/* locks protecting the data in the share object, one per data type */
+static CCriticalSection g_curlShareLocks[CURL_LOCK_DATA_LAST];
+
+extern "C" void share_lock_callback(CURL_HANDLE *handle, curl_lock_data data, curl_lock_access access, void *userptr)
+{
+  g_curlShareLocks[data].lock();
+}
+
+extern "C" void share_unlock_callback(CURL_HANDLE *handle, curl_lock_data data, void *userptr)
+{
+  g_curlShareLocks[data].unlock();
+}
+
 /* okey this is damn ugly. our dll loader doesn't allow for postload, preunload functions */
 static long g_curlReferences = 0;
 #if(0)
 static unsigned int g_curlTimeout = 0;
 #endif
 
+DllLibCurlGlobal::DllLibCurlGlobal()
+{
+  m_share = NULL;
+  memset(&m_stats, 0, sizeof(m_stats));
+}
+
 bool DllLibCurlGlobal::Load()
 {
   CSingleLock lock(m_critSection);
@@ -57,6 +78,18 @@ bool DllLibCurlGlobal::Load()
     return false;
   }
 
+  /* share name resolution and ssl sessions between all our handles */
+  m_share = share_init();
+  if (m_share)
+  {
+    share_setopt(m_share, CURLSHOPT_LOCKFUNC, share_lock_callback);
+    share_setopt(m_share, CURLSHOPT_UNLOCKFUNC, share_unlock_callback);
+    share_setopt(m_share, CURLSHOPT_SHARE, CURL_LOCK_DATA_DNS);
+#ifdef CURL_LOCK_DATA_SSL_SESSION
+    share_setopt(m_share, CURLSHOPT_SHARE, CURL_LOCK_DATA_SSL_SESSION);
+#endif
+  }
+
   /* check idle will clean up the last one */
   g_curlReferences = 2;
 
@@ -71,6 +104,14 @@ void DllLibCurlGlobal::Unload()
     if (!IsLoaded())
       return;
 
+    /* every pooled session holds a reference, so the pool is empty by now.
+     * should a handle still be around, it keeps using the share */
+    if (m_share && m_sessions.empty())
+    {
+      share_cleanup(m_share);
+      m_share = NULL;
+    }
+
     // close libcurl
     global_cleanup();
 
@@ -93,11 +134,24 @@ void DllLibCurlGlobal::CheckIdle()
   CSingleLock lock(m_critSection);
   /* 20 seconds idle time before closing handle */
   const unsigned int idletime = 30000;
+  /* idle sessions beyond the per host limit are aged out sooner */
+  const unsigned int surplusidletime = 5000;
+  const unsigned int maxidle = g_advancedSettings.m_curlmaxhostconnections;
+
+  std::map<CStdString, unsigned int> idle;
+  VEC_CURLSESSIONS::iterator it;
+  for(it = m_sessions.begin(); it != m_sessions.end(); it++)
+  {
+    if( !it->m_busy )
+      idle[it->m_hostname]++;
+  }
 
-  VEC_CURLSESSIONS::iterator it = m_sessions.begin();
+  unsigned int closed = 0;
+  it = m_sessions.begin();
   while(it != m_sessions.end())
   {
-    if( !it->m_busy && (XbmcThreads::SystemClockMillis() - it->m_idletimestamp) > idletime )
+    unsigned int timeout = idle[it->m_hostname] > maxidle ? surplusidletime : idletime;
+    if( !it->m_busy && (XbmcThreads::SystemClockMillis() - it->m_idletimestamp) > timeout )
     {
       CLog::Log(LOGINFO, "%s - Closing session to %s://%s (easy=%p, multi=%p)\n", __FUNCTION__, it->m_protocol.c_str(), it->m_hostname.c_str(), (void*)it->m_easy, (void*)it->m_multi);
 
@@ -108,14 +162,27 @@ void DllLibCurlGlobal::CheckIdle()
       if(it->m_easy)
         easy_cleanup(it->m_easy);
 
-      Unload();
-
+      idle[it->m_hostname]--;
+      closed++;
       it = m_sessions.erase(it);
       continue;
     }
     it++;
   }
 
+  /* drop the references of the closed sessions only once their handles are
+   * gone and out of the pool, the last one cleans up the share they used */
+  for (unsigned int i = 0; i < closed; i++)
+    Unload();
+
+  if (closed && m_stats.m_acquired)
+  {
+    CSingleLock hostLock(m_hostSection);
+    CLog::Log(LOGDEBUG, "%s - %u sessions open, %u of %u requests reused a session, %u waited %u ms in total (max %u ms)",
+              __FUNCTION__, (unsigned int)m_sessions.size(), m_stats.m_reused, m_stats.m_acquired,
+              m_stats.m_queued, m_stats.m_queueTime, m_stats.m_maxQueueTime);
+  }
+
   /* check if we should unload the dll */
 #if(0) // we never unload libcurl, since libssl can break when python unloads then
   if(g_curlReferences == 1 && XbmcThreads::SystemClockMillis() - g_curlTimeout > idletime)
@@ -129,6 +196,8 @@ void DllLibCurlGlobal::easy_aquire(const char *protocol, const char *hostname, C
 
   CSingleLock lock(m_critSection);
 
+  m_stats.m_acquired++;
+
   VEC_CURLSESSIONS::iterator it;
   for(it = m_sessions.begin(); it != m_sessions.end(); it++)
   {
@@ -139,6 +208,7 @@ void DllLibCurlGlobal::easy_aquire(const char *protocol, const char *hostname, C
       if( it->m_protocol.compare(protocol) == 0 && it->m_hostname.compare(hostname) == 0)
       {
         it->m_busy = true;
+        m_stats.m_reused++;
         if(easy_handle)
         {
           if(!it->m_easy)
@@ -275,3 +345,67 @@ void DllLibCurlGlobal::easy_duplicate(CURL_HANDLE* easy, CURLM* multi, CURL_HAND
   }
   return;
 }
+
+void DllLibCurlGlobal::AcquireHostSlot(const CStdString& hostname)
+{
+  CSingleLock lock(m_hostSection);
+  SHost& host = m_hosts[hostname];
+  const unsigned int limit = g_advancedSettings.m_curlmaxhostconnections;
+
+  if (host.m_busy >= limit || !host.m_waiting.empty())
+  {
+    /* wait for our turn, but never longer than a connect would take, so a
+     * caller setting up several requests to the same host can't deadlock */
+    unsigned int ticket = host.m_ticket++;
+    host.m_waiting.push_back(ticket);
+
+    unsigned int start = XbmcThreads::SystemClockMillis();
+    XbmcThreads::EndTime timeout(g_advancedSettings.m_curlconnecttimeout * 1000);
+    while ((host.m_busy >= limit || host.m_waiting.front() != ticket) && !timeout.IsTimePast())
+      m_hostCond.wait(m_hostSection, timeout.MillisLeft());
+
+    if (host.m_busy >= limit)
+      CLog::Log(LOGWARNING, "%s - exceeding connection limit for %s", __FUNCTION__, hostname.c_str());
+
+    host.m_waiting.erase(std::find(host.m_waiting.begin(), host.m_waiting.end(), ticket));
+    m_hostCond.notifyAll();
+
+    unsigned int waited = XbmcThreads::SystemClockMillis() - start;
+    m_stats.m_queued++;
+    m_stats.m_queueTime += waited;
+    m_stats.m_maxQueueTime = std::max(m_stats.m_maxQueueTime, waited);
+  }
+
+  host.m_busy++;
+}
+
+void DllLibCurlGlobal::ReleaseHostSlot(const CStdString& hostname)
+{
+  CSingleLock lock(m_hostSection);
+  MAP_CURLHOSTS::iterator it = m_hosts.find(hostname);
+  if (it == m_hosts.end())
+    return;
+
+  if (it->second.m_busy > 0)
+    it->second.m_busy--;
+
+  if (it->second.m_busy == 0 && it->second.m_waiting.empty())
+    m_hosts.erase(it);
+  else
+    m_hostCond.notifyAll();
+}
+
+void DllLibCurlGlobal::GetStatistics(SStatistics& stats)
+{
+  CSingleLock lock(m_critSection);
+  CSingleLock hostLock(m_hostSection);
+
+  stats = m_stats;
+  stats.m_sessions = m_sessions.size();
+  stats.m_busy = 0;
+  for (VEC_CURLSESSIONS::iterator it = m_sessions.begin(); it != m_sessions.end(); it++)
+  {
+    if (it->m_busy)
+      stats.m_busy++;
+  }
+}
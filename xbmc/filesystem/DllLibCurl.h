@@ -22,6 +22,9 @@
 
 #include "DynamicDll.h"
 #include "threads/CriticalSection.h"
+#include "threads/Condition.h"
+#include <map>
+#include <deque>
 
 /* put types of curl in namespace to avoid namespace pollution */
 namespace XCURL
@@ -53,6 +56,8 @@ namespace XCURL
     virtual void multi_cleanup(CURL_HANDLE * handle )=0;
     virtual struct curl_slist* slist_append(struct curl_slist *, const char *)=0;
     virtual void  slist_free_all(struct curl_slist *)=0;
+    virtual CURLSH* share_init(void)=0;
+    virtual CURLSHcode share_cleanup(CURLSH *share)=0;
   };
 
   class DllLibCurl : public DllDynamic, DllLibCurlInterface
@@ -77,6 +82,9 @@ namespace XCURL
     DEFINE_METHOD1(void, multi_cleanup, (CURLM *p1))
     DEFINE_METHOD2(struct curl_slist*, slist_append, (struct curl_slist * p1, const char * p2))
     DEFINE_METHOD1(void, slist_free_all, (struct curl_slist * p1))
+    DEFINE_METHOD0(CURLSH *, share_init)
+    DEFINE_METHOD_FP(CURLSHcode, share_setopt, (CURLSH *p1, CURLSHoption p2, ...))
+    DEFINE_METHOD1(CURLSHcode, share_cleanup, (CURLSH *p1))
     BEGIN_METHOD_RESOLVE()
       RESOLVE_METHOD_RENAME(curl_global_init, global_init)
       RESOLVE_METHOD_RENAME(curl_global_cleanup, global_cleanup)
@@ -97,6 +105,9 @@ namespace XCURL
       RESOLVE_METHOD_RENAME(curl_multi_cleanup, multi_cleanup)
       RESOLVE_METHOD_RENAME(curl_slist_append, slist_append)
       RESOLVE_METHOD_RENAME(curl_slist_free_all, slist_free_all)
+      RESOLVE_METHOD_RENAME(curl_share_init, share_init)
+      RESOLVE_METHOD_RENAME_FP(curl_share_setopt, share_setopt)
+      RESOLVE_METHOD_RENAME(curl_share_cleanup, share_cleanup)
     END_METHOD_RESOLVE()
 
   };
@@ -104,6 +115,8 @@ namespace XCURL
   class DllLibCurlGlobal : public DllLibCurl
   {
   public:
+    DllLibCurlGlobal();
+
     /* extend interface with buffered functions */
     void easy_aquire(const char *protocol, const char *hostname, CURL_HANDLE** easy_handle, CURLM** multi_handle);
     void easy_release(CURL_HANDLE** easy_handle, CURLM** multi_handle);
@@ -111,10 +124,33 @@ namespace XCURL
     CURL_HANDLE* easy_duphandle(CURL_HANDLE* easy_handle);
     void CheckIdle();
 
+    /* per host request limit. a slot is held for as long as a request runs,
+     * for streams until they disconnect. may not be called with
+     * m_critSection held, as it can wait for a slot */
+    void AcquireHostSlot(const CStdString& hostname);
+    void ReleaseHostSlot(const CStdString& hostname);
+
+    /* share object holding dns cache and ssl sessions, common to all handles */
+    CURLSH* GetShare() { return m_share; }
+
     /* overloaded load and unload with reference counter */
     virtual bool Load();
     virtual void Unload();
 
+    /* pool statistics */
+    typedef struct SStatistics
+    {
+      unsigned int  m_sessions;       // open sessions, idle or busy
+      unsigned int  m_busy;           // sessions currently in use
+      unsigned int  m_acquired;       // number of easy_aquire calls
+      unsigned int  m_reused;         // of those, served by an idle session
+      unsigned int  m_queued;         // requests that had to wait for a per host slot
+      unsigned int  m_queueTime;      // total time spent waiting for a slot in ms
+      unsigned int  m_maxQueueTime;   // longest wait for a slot in ms
+    } SStatistics;
+
+    void GetStatistics(SStatistics& stats);
+
     /* structure holding a session info */
     typedef struct SSession
     {
@@ -128,8 +164,24 @@ namespace XCURL
 
     typedef std::vector<SSession> VEC_CURLSESSIONS;
 
+    /* per host request accounting, slots are handed out in ticket order */
+    typedef struct SHost
+    {
+      SHost() : m_busy(0), m_ticket(0) {}
+      unsigned int  m_busy;
+      unsigned int  m_ticket;         // next ticket to hand out
+      std::deque<unsigned int> m_waiting; // tickets waiting for a slot, in arrival order
+    } SHost;
+
+    typedef std::map<CStdString, SHost> MAP_CURLHOSTS;
+
     VEC_CURLSESSIONS m_sessions;
+    MAP_CURLHOSTS    m_hosts;
+    SStatistics      m_stats;
+    CURLSH*          m_share;
     CCriticalSection m_critSection;
+    CCriticalSection m_hostSection;   // guards m_hosts and the queue statistics
+    XbmcThreads::ConditionVariable m_hostCond;
   };
 }
 
@@ -211,3 +211,17 @@ bool CHTTPDirectory::Exists(const char* strPath)
 
   return false;
 }
+
+CStdString CHTTPDirectory::GetDiskCacheValidator(const CStdString& strPath) const
+{
+  // a HEAD request is enough to tell whether the index page changed. servers
+  // that send neither header are only covered by the cache's TTL
+  CHttpHeader headers;
+  if (!CCurlFile::GetHttpHeader(CURL(strPath), headers))
+    return "";
+
+  CStdString validator = headers.GetValue("etag");
+  if (validator.IsEmpty())
+    validator = headers.GetValue("last-modified");
+  return validator;
+}
@@ -32,6 +32,9 @@ namespace XFILE
       virtual bool GetDirectory(const CStdString& strPath, CFileItemList &items);
       virtual bool Exists(const char* strPath);
       virtual DIR_CACHE_TYPE GetCacheType(const CStdString& strPath) const { return DIR_CACHE_ONCE; };
+      virtual bool AllowDiskCache(const CStdString& strPath) const { return true; };
+      virtual CStdString GetDiskCacheValidator(const CStdString& strPath) const;
+      virtual bool IsDiskCacheValidatorSlow(const CStdString& strPath) const { return true; };
     private:
   };
 }
@@ -46,7 +46,8 @@ namespace XFILE
     DIR_FLAG_NO_FILE_INFO  = (2 << 2), ///< Don't read additional file info (stat for example)
     DIR_FLAG_GET_HIDDEN    = (2 << 3), ///< Get hidden files
     DIR_FLAG_READ_CACHE    = (2 << 4), ///< Force reading from the directory cache (if available)
-    DIR_FLAG_BYPASS_CACHE  = (2 << 5)  ///< Completely bypass the directory cache (no reading, no writing)
+    DIR_FLAG_BYPASS_CACHE  = (2 << 5), ///< Completely bypass the directory cache (no reading, no writing)
+    DIR_FLAG_NO_PROGRESS   = (2 << 6)  ///< Nobody waits on this fetch, so don't show any progress for it
   };
 /*!
  \ingroup filesystem
@@ -104,6 +105,30 @@ public:
   */
   virtual DIR_CACHE_TYPE GetCacheType(const CStdString& strPath) const { return DIR_CACHE_ONCE; };
 
+  /*!
+  \brief Whether listings of this directory are slow enough to fetch that they
+  should be kept in the listing disk cache.
+  \param strPath Directory at hand.
+  \sa CDirectoryDiskCache
+  */
+  virtual bool AllowDiskCache(const CStdString& strPath) const { return false; };
+
+  /*!
+  \brief What a listing in the disk cache depends on besides its path, e.g.
+  the version of the addon that produced it. A cached listing stored with a
+  different validator is not used.
+  \param strPath Directory at hand.
+  */
+  virtual CStdString GetDiskCacheValidator(const CStdString& strPath) const { return ""; };
+
+  /*!
+  \brief Whether GetDiskCacheValidator() has to ask the source, e.g. with a
+  network request. Such a validator is only checked by the background
+  refresh, until then a cached listing is trusted for its TTL.
+  \param strPath Directory at hand.
+  */
+  virtual bool IsDiskCacheValidatorSlow(const CStdString& strPath) const { return false; };
+
   void SetMask(const CStdString& strMask);
   void SetFlags(int flags);
 
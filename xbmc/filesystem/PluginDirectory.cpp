@@ -172,6 +172,13 @@ bool CPluginDirectory::AddItem(int handle, const CFileItem *item, int totalItems
 
 bool CPluginDirectory::AddItems(int handle, const CFileItemList *items, int totalItems)
 {
+  // copy the items once and before locking, so a large listing neither goes
+  // through an intermediate list nor blocks the other handles meanwhile
+  std::vector<CFileItemPtr> copies;
+  copies.reserve(items->Size());
+  for (int i = 0; i < items->Size(); i++)
+    copies.push_back(CFileItemPtr(new CFileItem(*items->Get(i))));
+
   CSingleLock lock(m_handleLock);
   if (handle < 0 || handle >= (int)globalHandles.size())
   {
@@ -180,9 +187,9 @@ bool CPluginDirectory::AddItems(int handle, const CFileItemList *items, int tota
   }
 
   CPluginDirectory *dir = globalHandles[handle];
-  CFileItemList pItemList;
-  pItemList.Copy(*items);
-  dir->m_listItems->Append(pItemList);
+  dir->m_listItems->Reserve(dir->m_listItems->Size() + copies.size());
+  for (unsigned int i = 0; i < copies.size(); i++)
+    dir->m_listItems->Add(copies[i]);
   dir->m_totalItems = totalItems;
 
   return !dir->m_cancelled;
@@ -390,6 +397,16 @@ void CPluginDirectory::AddSortMethod(int handle, SORT_METHOD sortMethod, const C
   }
 }
 
+CStdString CPluginDirectory::GetDiskCacheValidator(const CStdString& strPath) const
+{
+  // listings of an older version of the plugin are of no use
+  AddonPtr addon;
+  CURL url(strPath);
+  if (!CAddonMgr::Get().GetAddon(url.GetHostName(), addon, ADDON_PLUGIN))
+    return "";
+  return addon->Version().c_str();
+}
+
 bool CPluginDirectory::GetDirectory(const CStdString& strPath, CFileItemList& items)
 {
   CURL url(strPath);
@@ -478,7 +495,7 @@ bool CPluginDirectory::WaitOnScriptResult(const CStdString &scriptPath, const CS
     }
 
     // check whether we should pop up the progress dialog
-    if (!progressBar && XbmcThreads::SystemClockMillis() - startTime > timeBeforeProgressBar)
+    if (!progressBar && !(m_flags & DIR_FLAG_NO_PROGRESS) && XbmcThreads::SystemClockMillis() - startTime > timeBeforeProgressBar)
     { // loading takes more then 1.5 secs, show a progress dialog
       progressBar = (CGUIDialogProgress *)g_windowManager.GetWindow(WINDOW_DIALOG_PROGRESS);
 
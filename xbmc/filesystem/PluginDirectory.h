@@ -47,6 +47,8 @@ public:
   virtual bool GetDirectory(const CStdString& strPath, CFileItemList& items);
   virtual bool IsAllowed(const CStdString &strFile) const { return true; };
   virtual bool Exists(const char* strPath) { return true; }
+  virtual bool AllowDiskCache(const CStdString& strPath) const { return true; }
+  virtual CStdString GetDiskCacheValidator(const CStdString& strPath) const;
   static bool RunScriptWithParams(const CStdString& strPath);
   static bool GetPluginResult(const CStdString& strPath, CFileItem &resultItem);
 
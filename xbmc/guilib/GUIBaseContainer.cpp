@@ -29,6 +29,7 @@
 #include "utils/SortUtils.h"
 #include "utils/StringUtils.h"
 #include "GUIStaticItem.h"
+#include "GUITextBatch.h"
 #include "Key.h"
 #include "utils/MathUtils.h"
 #include "utils/XBMCTinyXML.h"
@@ -208,6 +209,10 @@ void CGUIBaseContainer::Render()
     pos += drawOffset;
     end += cacheAfter * m_layout->Size(m_orientation);
 
+    // the items only consist of textures and labels, so the labels of all
+    // items can share their draw calls as long as nothing is drawn on top
+    CGUITextBatch::Begin();
+
     float focusedPos = 0;
     CGUIListItemPtr focusedItem;
     int current = offset - cacheBefore;
@@ -246,6 +251,7 @@ void CGUIBaseContainer::Render()
       else
         RenderItem(focusedPos, origin.y, focusedItem.get(), true);
     }
+    CGUITextBatch::End();
 
     g_graphicsContext.RestoreClipRegion();
   }
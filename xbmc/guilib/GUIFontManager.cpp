@@ -25,6 +25,7 @@
 #include "addons/Skin.h"
 #include "GUIFontTTF.h"
 #include "GUIFont.h"
+#include "GUITextLayoutCache.h"
 #include "utils/XMLUtils.h"
 #include "GUIControlFactory.h"
 #include "filesystem/File.h"
@@ -206,6 +207,9 @@ void GUIFontManager::ReloadTTFFonts(void)
   if (!m_vecFonts.size())
     return;   // we haven't even loaded fonts in yet
 
+  // cached layouts were measured with the old font sizes
+  CGUITextLayoutCache::GetInstance().Clear();
+
   for (unsigned int i = 0; i < m_vecFonts.size(); i++)
   {
     CGUIFont* font = m_vecFonts[i];
@@ -245,6 +249,7 @@ void GUIFontManager::Unload(const CStdString& strFontName)
   {
     if ((*iFont)->GetFontName() == strFontName)
     {
+      CGUITextLayoutCache::GetInstance().Clear();
       delete (*iFont);
       m_vecFonts.erase(iFont);
       return;
@@ -326,6 +331,8 @@ CGUIFont* GUIFontManager::GetDefaultFont(bool border)
 
 void GUIFontManager::Clear()
 {
+  CGUITextLayoutCache::GetInstance().Clear();
+
   for (int i = 0; i < (int)m_vecFonts.size(); ++i)
   {
     CGUIFont* pFont = m_vecFonts[i];
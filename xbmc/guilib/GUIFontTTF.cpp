@@ -22,6 +22,7 @@
 #include "GUIFont.h"
 #include "GUIFontTTF.h"
 #include "GUIFontManager.h"
+#include "GUITextBatch.h"
 #include "Texture.h"
 #include "GraphicContext.h"
 #include "filesystem/SpecialProtocol.h"
@@ -154,6 +155,8 @@ CGUIFontTTFBase::CGUIFontTTFBase(const CStdString& strFileName)
   m_referenceCount = 0;
   m_originX = m_originY = 0.0f;
   m_cellBaseLine = m_cellHeight = 0;
+  m_drawCount = 0;
+  m_recycleRows = false;
   m_numChars = 0;
   m_posX = m_posY = 0;
   m_textureHeight = m_textureWidth = 0;
@@ -199,6 +202,8 @@ void CGUIFontTTFBase::ClearCharacterCache()
   m_posX = m_textureWidth;
   m_posY = -(int)m_cellHeight;
   m_textureHeight = 0;
+  m_rowUsed.clear();
+  m_recycleRows = false;
 }
 
 void CGUIFontTTFBase::Clear()
@@ -283,6 +288,8 @@ bool CGUIFontTTFBase::Load(const CStdString& strFilename, float height, float as
 
   m_maxChars = 0;
   m_numChars = 0;
+  m_rowUsed.clear();
+  m_recycleRows = false;
 
   m_strFilename = strFilename;
 
@@ -308,6 +315,7 @@ bool CGUIFontTTFBase::Load(const CStdString& strFilename, float height, float as
 void CGUIFontTTFBase::DrawTextInternal(float x, float y, const vecColors &colors, const vecText &text, uint32_t alignment, float maxPixelWidth, bool scrolling)
 {
   Begin();
+  m_drawCount++;
 
   // save the origin, which is scaled separately
   m_originX = x;
@@ -477,7 +485,46 @@ CGUIFontTTFBase::Character* CGUIFontTTFBase::GetCharacter(character_t chr)
     else
       return &m_char[mid];
   }
-  // if we get to here, then low is where we should insert the new character
+  // render the character to our texture
+  // must End() as we can't render text to our texture during a Begin(), End() block
+  unsigned int nestedBeginCount = m_nestedBeginCount;
+  m_nestedBeginCount = 1;
+  if (nestedBeginCount) End();
+  // text still waiting in a batch uses the texture coordinates of the current texture
+  CGUITextBatch::Flush();
+  Character newChar;
+  bool cached = CacheCharacter(letter, style, &newChar);
+  if (!cached && EvictCharacters())
+  { // texture is full - reuse the space of the least recently used characters
+    cached = CacheCharacter(letter, style, &newChar);
+  }
+  if (!cached)
+  { // unable to cache character - try clearing them all out and starting over
+    CLog::Log(LOGDEBUG, "GUIFontTTF::GetCharacter: Unable to cache character.  Clearing character cache of %i characters", m_numChars);
+    ClearCharacterCache();
+    if (!CacheCharacter(letter, style, &newChar))
+    {
+      CLog::Log(LOGERROR, "GUIFontTTF::GetCharacter: Unable to cache character (out of memory?)");
+      UpdateQuickAccess();
+      if (nestedBeginCount) Begin();
+      m_nestedBeginCount = nestedBeginCount;
+      return NULL;
+    }
+  }
+  if (nestedBeginCount) Begin();
+  m_nestedBeginCount = nestedBeginCount;
+
+  // find where to insert the new character, as characters may have been dropped meanwhile
+  low = 0;
+  high = m_numChars - 1;
+  while (low <= high)
+  {
+    mid = (low + high) >> 1;
+    if (ch > m_char[mid].letterAndStyle)
+      low = mid + 1;
+    else
+      high = mid - 1;
+  }
 
   // increase the size of the buffer if we need it
   if (m_numChars >= m_maxChars)
@@ -497,28 +544,16 @@ CGUIFontTTFBase::Character* CGUIFontTTFBase::GetCharacter(character_t chr)
   { // just move the data along as necessary
     memmove(m_char + low + 1, m_char + low, (m_numChars - low) * sizeof(Character));
   }
-  // render the character to our texture
-  // must End() as we can't render text to our texture during a Begin(), End() block
-  unsigned int nestedBeginCount = m_nestedBeginCount;
-  m_nestedBeginCount = 1;
-  if (nestedBeginCount) End();
-  if (!CacheCharacter(letter, style, m_char + low))
-  { // unable to cache character - try clearing them all out and starting over
-    CLog::Log(LOGDEBUG, "GUIFontTTF::GetCharacter: Unable to cache character.  Clearing character cache of %i characters", m_numChars);
-    ClearCharacterCache();
-    low = 0;
-    if (!CacheCharacter(letter, style, m_char + low))
-    {
-      CLog::Log(LOGERROR, "GUIFontTTF::GetCharacter: Unable to cache character (out of memory?)");
-      if (nestedBeginCount) Begin();
-      m_nestedBeginCount = nestedBeginCount;
-      return NULL;
-    }
-  }
-  if (nestedBeginCount) Begin();
-  m_nestedBeginCount = nestedBeginCount;
+  m_char[low] = newChar;
+  m_numChars++;
+
+  UpdateQuickAccess();
+
+  return m_char + low;
+}
 
-  // fixup quick access
+void CGUIFontTTFBase::UpdateQuickAccess()
+{
   memset(m_charquick, 0, sizeof(m_charquick));
   for(int i=0;i<m_numChars;i++)
   {
@@ -528,8 +563,45 @@ CGUIFontTTFBase::Character* CGUIFontTTFBase::GetCharacter(character_t chr)
       m_charquick[ch] = m_char+i;
     }
   }
+}
 
-  return m_char + low;
+bool CGUIFontTTFBase::EvictCharacters()
+{
+  // only worth it once the texture can't grow any further
+  if (!m_texture || m_rowUsed.size() < 2)
+    return false;
+  if (!m_recycleRows && m_textureHeight + m_cellHeight <= g_Windowing.GetMaxTextureSize())
+    return false;
+
+  unsigned int row = 0;
+  for (unsigned int i = 1; i < m_rowUsed.size(); i++)
+  {
+    if (m_rowUsed[i] < m_rowUsed[row])
+      row = i;
+  }
+  // all rows are in use by the text being drawn
+  if (m_rowUsed[row] == m_drawCount)
+    return false;
+
+  if (!ClearTextureRows(row * m_cellHeight, m_cellHeight))
+    return false;
+
+  int numChars = 0;
+  for (int i = 0; i < m_numChars; i++)
+  {
+    if (m_char[i].row != row)
+      m_char[numChars++] = m_char[i];
+  }
+  CLog::Log(LOGDEBUG, "GUIFontTTF::EvictCharacters: Dropped %i characters from texture row %u", m_numChars - numChars, row);
+  m_numChars = numChars;
+  UpdateQuickAccess();
+
+  // characters are now added to the freed row, and once that is full the next one is freed
+  m_posX = 0;
+  m_posY = row * m_cellHeight;
+  m_rowUsed[row] = m_drawCount;
+  m_recycleRows = true;
+  return true;
 }
 
 bool CGUIFontTTFBase::CacheCharacter(wchar_t letter, uint32_t style, Character *ch)
@@ -570,6 +642,11 @@ bool CGUIFontTTFBase::CacheCharacter(wchar_t letter, uint32_t style, Character *
   // check we have enough room for the character
   if (m_posX + bitGlyph->left + bitmap.width > (int)m_textureWidth)
   { // no space - gotta drop to the next line (which means creating a new texture and copying it across)
+    if (m_recycleRows)
+    { // the texture can't grow, the next row has to be freed first
+      FT_Done_Glyph(glyph);
+      return false;
+    }
     m_posX = 0;
     m_posY += m_cellHeight;
     if (bitGlyph->left < 0)
@@ -607,6 +684,7 @@ bool CGUIFontTTFBase::CacheCharacter(wchar_t letter, uint32_t style, Character *
 
   // set the character in our table
   ch->letterAndStyle = (style << 16) | letter;
+  ch->row = (unsigned short)(m_posY / m_cellHeight);
   ch->offsetX = (short)bitGlyph->left;
   ch->offsetY = (short)max((short)m_cellBaseLine - bitGlyph->top, 0);
   ch->left = (float)m_posX + ch->offsetX;
@@ -621,7 +699,9 @@ bool CGUIFontTTFBase::CacheCharacter(wchar_t letter, uint32_t style, Character *
     CopyCharToTexture(bitGlyph, ch);
   }
   m_posX += 1 + (unsigned short)max(ch->right - ch->left + ch->offsetX, ch->advance);
-  m_numChars++;
+  if (ch->row >= m_rowUsed.size())
+    m_rowUsed.resize(ch->row + 1, 0);
+  m_rowUsed[ch->row] = m_drawCount;
 
   m_textureScaleX = 1.0f / m_textureWidth;
   m_textureScaleY = 1.0f / m_textureHeight;
@@ -634,6 +714,8 @@ bool CGUIFontTTFBase::CacheCharacter(wchar_t letter, uint32_t style, Character *
 
 void CGUIFontTTFBase::RenderCharacter(float posX, float posY, const Character *ch, color_t color, bool roundX)
 {
+  m_rowUsed[ch->row] = m_drawCount;
+
   // actual image width isn't same as the character width as that is
   // just baseline width and height should include the descent
   const float width = ch->right - ch->left;
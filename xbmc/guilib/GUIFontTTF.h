@@ -87,6 +87,7 @@ protected:
   struct Character
   {
     short offsetX, offsetY;
+    unsigned short row;      // row of the texture the character is cached in
     float left, top, right, bottom;
     float advance;
     character_t letterAndStyle;
@@ -111,10 +112,13 @@ protected:
   bool CacheCharacter(wchar_t letter, uint32_t style, Character *ch);
   void RenderCharacter(float posX, float posY, const Character *ch, color_t color, bool roundX);
   void ClearCharacterCache();
+  bool EvictCharacters();
+  void UpdateQuickAccess();
 
   virtual CBaseTexture* ReallocTexture(unsigned int& newHeight) = 0;
   virtual bool CopyCharToTexture(FT_BitmapGlyph bitGlyph, Character *ch) = 0;
   virtual void DeleteHardwareTexture() = 0;
+  virtual bool ClearTextureRows(unsigned int top, unsigned int height) = 0;
 
   // modifying glyphs
   void EmboldenGlyph(FT_GlyphSlot slot);
@@ -139,6 +143,10 @@ protected:
   unsigned int m_cellBaseLine;
   unsigned int m_cellHeight;
 
+  std::vector<unsigned int> m_rowUsed; // last draw each texture row was used in
+  unsigned int m_drawCount;          // number of texts drawn, used to find the least recently used row
+  bool m_recycleRows;                // texture is at its maximum size, rows are reused once full
+
   unsigned int m_nestedBeginCount;             // speedups
 
   // freetype stuff
@@ -28,6 +28,7 @@
 #include "gui3d.h"
 #include "utils/log.h"
 #include "utils/GLUtils.h"
+#include <float.h>
 #if HAS_GLES == 2
 #include "windowing/WindowingFactory.h"
 #endif
@@ -46,63 +47,26 @@ using namespace std;
 CGUIFontTTFGL::CGUIFontTTFGL(const CStdString& strFileName)
 : CGUIFontTTFBase(strFileName)
 {
+  m_batchStart = 0;
 }
 
 CGUIFontTTFGL::~CGUIFontTTFGL(void)
 {
+  CGUITextBatch::Remove(this);
 }
 
 void CGUIFontTTFGL::Begin()
 {
   if (m_nestedBeginCount == 0)
   {
-    if (!m_bTextureLoaded)
+    // text of this font that is still pending in the batch is simply added to,
+    // anything else has to be drawn first to keep the order of the labels
+    if (!CGUITextBatch::IsDeferred(this))
     {
-      // Have OpenGL generate a texture object handle for us
-      glGenTextures(1, (GLuint*) &m_nTexture);
-
-      // Bind the texture object
-      glBindTexture(GL_TEXTURE_2D, m_nTexture);
-#ifdef HAS_GL
-      glEnable(GL_TEXTURE_2D);
-#endif
-      // Set the texture's stretching properties
-      glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-      glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-
-      // Set the texture image -- THIS WORKS, so the pixels must be wrong.
-      glTexImage2D(GL_TEXTURE_2D, 0, GL_ALPHA, m_texture->GetWidth(), m_texture->GetHeight(), 0,
-                   GL_ALPHA, GL_UNSIGNED_BYTE, m_texture->GetPixels());
-
-      VerifyGLState();
-      m_bTextureLoaded = true;
+      CGUITextBatch::Flush();
+      m_vertex_count = 0;
     }
-
-    // Turn Blending On
-    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-    glEnable(GL_BLEND);
-#ifdef HAS_GL
-    glEnable(GL_TEXTURE_2D);
-#endif
-    glBindTexture(GL_TEXTURE_2D, m_nTexture);
-
-#ifdef HAS_GL
-    glTexEnvi(GL_TEXTURE_ENV,GL_TEXTURE_ENV_MODE,GL_COMBINE);
-    glTexEnvi(GL_TEXTURE_ENV,GL_COMBINE_RGB,GL_REPLACE);
-    glTexEnvi(GL_TEXTURE_ENV, GL_SOURCE0_RGB, GL_PRIMARY_COLOR);
-    glTexEnvi(GL_TEXTURE_ENV, GL_OPERAND0_RGB, GL_SRC_COLOR);
-    glTexEnvi(GL_TEXTURE_ENV, GL_COMBINE_ALPHA, GL_MODULATE);
-    glTexEnvi(GL_TEXTURE_ENV, GL_SOURCE0_ALPHA, GL_TEXTURE0);
-    glTexEnvi(GL_TEXTURE_ENV, GL_OPERAND0_ALPHA, GL_SRC_ALPHA);
-    glTexEnvi(GL_TEXTURE_ENV, GL_SOURCE1_ALPHA, GL_PRIMARY_COLOR);
-    glTexEnvi(GL_TEXTURE_ENV, GL_OPERAND1_ALPHA, GL_SRC_ALPHA);
-    glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
-    VerifyGLState();
-#else
-    g_Windowing.EnableGUIShader(SM_FONTS);
-#endif
-
-    m_vertex_count = 0;
+    m_batchStart = m_vertex_count;
   }
   // Keep track of the nested begin/end calls.
   m_nestedBeginCount++;
@@ -116,6 +80,66 @@ void CGUIFontTTFGL::End()
   if (--m_nestedBeginCount > 0)
     return;
 
+  if (m_vertex_count == m_batchStart)
+    return;
+
+  if (CGUITextBatch::IsBatching())
+    CGUITextBatch::Defer(this, GetBatchBounds(m_batchStart));
+  else
+    RenderBatch();
+}
+
+void CGUIFontTTFGL::RenderBatch()
+{
+  if (m_vertex_count == 0)
+    return;
+
+  if (!m_bTextureLoaded)
+  {
+    // Have OpenGL generate a texture object handle for us
+    glGenTextures(1, (GLuint*) &m_nTexture);
+
+    // Bind the texture object
+    glBindTexture(GL_TEXTURE_2D, m_nTexture);
+#ifdef HAS_GL
+    glEnable(GL_TEXTURE_2D);
+#endif
+    // Set the texture's stretching properties
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+
+    // Set the texture image -- THIS WORKS, so the pixels must be wrong.
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_ALPHA, m_texture->GetWidth(), m_texture->GetHeight(), 0,
+                 GL_ALPHA, GL_UNSIGNED_BYTE, m_texture->GetPixels());
+
+    VerifyGLState();
+    m_bTextureLoaded = true;
+  }
+
+  // Turn Blending On
+  glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+  glEnable(GL_BLEND);
+#ifdef HAS_GL
+  glEnable(GL_TEXTURE_2D);
+#endif
+  glBindTexture(GL_TEXTURE_2D, m_nTexture);
+
+#ifdef HAS_GL
+  glTexEnvi(GL_TEXTURE_ENV,GL_TEXTURE_ENV_MODE,GL_COMBINE);
+  glTexEnvi(GL_TEXTURE_ENV,GL_COMBINE_RGB,GL_REPLACE);
+  glTexEnvi(GL_TEXTURE_ENV, GL_SOURCE0_RGB, GL_PRIMARY_COLOR);
+  glTexEnvi(GL_TEXTURE_ENV, GL_OPERAND0_RGB, GL_SRC_COLOR);
+  glTexEnvi(GL_TEXTURE_ENV, GL_COMBINE_ALPHA, GL_MODULATE);
+  glTexEnvi(GL_TEXTURE_ENV, GL_SOURCE0_ALPHA, GL_TEXTURE0);
+  glTexEnvi(GL_TEXTURE_ENV, GL_OPERAND0_ALPHA, GL_SRC_ALPHA);
+  glTexEnvi(GL_TEXTURE_ENV, GL_SOURCE1_ALPHA, GL_PRIMARY_COLOR);
+  glTexEnvi(GL_TEXTURE_ENV, GL_OPERAND1_ALPHA, GL_SRC_ALPHA);
+  glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
+  VerifyGLState();
+#else
+  g_Windowing.EnableGUIShader(SM_FONTS);
+#endif
+
 #ifdef HAS_GL
   glPushClientAttrib(GL_CLIENT_VERTEX_ARRAY_BIT);
 
@@ -167,6 +191,25 @@ void CGUIFontTTFGL::End()
 
   g_Windowing.DisableGUIShader();
 #endif
+
+  CGUITextBatch::CountDraw(m_vertex_count * sizeof(SVertex));
+  m_vertex_count = 0;
+}
+
+CRect CGUIFontTTFGL::GetBatchBounds(int first) const
+{
+  CRect bounds(FLT_MAX, FLT_MAX, -FLT_MAX, -FLT_MAX);
+  for (int i = first; i < m_vertex_count; i++)
+  {
+    const SVertex &v = m_vertex[i];
+    if (v.z != 0.0f)
+      return CRect(-FLT_MAX, -FLT_MAX, FLT_MAX, FLT_MAX);
+    bounds.x1 = std::min(bounds.x1, v.x);
+    bounds.y1 = std::min(bounds.y1, v.y);
+    bounds.x2 = std::max(bounds.x2, v.x);
+    bounds.y2 = std::max(bounds.y2, v.y);
+  }
+  return bounds;
 }
 
 CBaseTexture* CGUIFontTTFGL::ReallocTexture(unsigned int& newHeight)
@@ -228,6 +271,23 @@ bool CGUIFontTTFGL::CopyCharToTexture(FT_BitmapGlyph bitGlyph, Character* ch)
   return TRUE;
 }
 
+bool CGUIFontTTFGL::ClearTextureRows(unsigned int top, unsigned int height)
+{
+  if (!m_texture || top + height > m_texture->GetHeight())
+    return false;
+
+  memset((unsigned char*) m_texture->GetPixels() + top * m_texture->GetPitch(), 0, height * m_texture->GetPitch());
+
+  if (m_bTextureLoaded)
+  {
+    g_graphicsContext.BeginPaint();  //FIXME
+    DeleteHardwareTexture();
+    g_graphicsContext.EndPaint();
+    m_bTextureLoaded = false;
+  }
+
+  return true;
+}
 
 void CGUIFontTTFGL::DeleteHardwareTexture()
 {
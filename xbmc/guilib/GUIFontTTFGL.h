@@ -30,13 +30,14 @@
 
 
 #include "GUIFontTTF.h"
+#include "GUITextBatch.h"
 
 
 /*!
  \ingroup textures
  \brief
  */
-class CGUIFontTTFGL : public CGUIFontTTFBase
+class CGUIFontTTFGL : public CGUIFontTTFBase, public ITextBatchRenderer
 {
 public:
   CGUIFontTTFGL(const CStdString& strFileName);
@@ -45,11 +46,19 @@ public:
   virtual void Begin();
   virtual void End();
 
+  // ITextBatchRenderer
+  virtual void RenderBatch();
+
 protected:
   virtual CBaseTexture* ReallocTexture(unsigned int& newHeight);
   virtual bool CopyCharToTexture(FT_BitmapGlyph bitGlyph, Character *ch);
   virtual void DeleteHardwareTexture();
+  virtual bool ClearTextureRows(unsigned int top, unsigned int height);
+
+private:
+  CRect GetBatchBounds(int first) const;
 
+  int m_batchStart; ///< first vertex of the label being rendered
 };
 
 #endif
@@ -191,6 +191,18 @@ void CGUIListItem::SetArt(const map<string, string> &art)
     SetProperty("fanart_image", i->second);
 }
 
+unsigned int CGUIListItem::EstimatePropertiesSize() const
+{
+  unsigned int size = 0;
+  for (PropertyMap::const_iterator it = m_mapProperties.begin(); it != m_mapProperties.end(); ++it)
+  {
+    size += sizeof(*it) + it->first.size();
+    if (it->second.isString())
+      size += it->second.asString().size();
+  }
+  return size;
+}
+
 void CGUIListItem::Select(bool bOnOff)
 {
   m_bSelected = bOnOff;
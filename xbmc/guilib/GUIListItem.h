@@ -140,6 +140,11 @@ public:
 
   CVariant   GetProperty(const CStdString &strKey) const;
 
+  /*! \brief Rough estimate of the memory used by the properties, in bytes.
+   Fanart and other artwork are stored as properties, so they are included.
+   */
+  unsigned int EstimatePropertiesSize() const;
+
 protected:
   CStdString m_strLabel2;     // text of column2
   CStdString m_strThumbnailImage; // filename of thumbnail
@@ -0,0 +1,142 @@
+/*
+ *      Copyright (C) 2012 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+ *  http://www.gnu.org/copyleft/gpl.html
+ *
+ */
+
+
+#include "GUITextBatch.h"
+#include "GraphicContext.h"
+
+#include <float.h>
+
+using namespace std;
+
+unsigned int CGUITextBatch::m_depth = 0;
+ITextBatchRenderer *CGUITextBatch::m_pending = NULL;
+vector<CRect> CGUITextBatch::m_bounds;
+unsigned int CGUITextBatch::m_drawCalls = 0;
+unsigned int CGUITextBatch::m_labels = 0;
+unsigned int CGUITextBatch::m_vertexBytes = 0;
+unsigned int CGUITextBatch::m_lastDrawCalls = 0;
+unsigned int CGUITextBatch::m_lastLabels = 0;
+unsigned int CGUITextBatch::m_lastVertexBytes = 0;
+
+void CGUITextBatch::Begin()
+{
+  m_depth++;
+}
+
+void CGUITextBatch::End()
+{
+  if (m_depth == 0)
+    return;
+
+  if (--m_depth == 0)
+    Flush();
+}
+
+void CGUITextBatch::Defer(ITextBatchRenderer *renderer, const CRect &bounds)
+{
+  if (m_pending != renderer)
+    Flush();
+
+  m_pending = renderer;
+  m_bounds.push_back(bounds);
+  m_labels++;
+}
+
+void CGUITextBatch::Flush()
+{
+  if (!m_pending)
+    return;
+
+  // reset first, the renderer may start a new label while drawing
+  ITextBatchRenderer *renderer = m_pending;
+  m_pending = NULL;
+  m_bounds.clear();
+  renderer->RenderBatch();
+}
+
+void CGUITextBatch::Flush(const CRect &rect)
+{
+  if (!m_pending)
+    return;
+
+  // transform the corners to screen space. Anything that isn't flat
+  // can't be tested reliably, so it is assumed to overlap.
+  float x[4] = { rect.x1, rect.x2, rect.x2, rect.x1 };
+  float y[4] = { rect.y1, rect.y1, rect.y2, rect.y2 };
+  CRect screen(FLT_MAX, FLT_MAX, -FLT_MAX, -FLT_MAX);
+  for (int i = 0; i < 4; i++)
+  {
+    if (g_graphicsContext.ScaleFinalZCoord(x[i], y[i]) != 0.0f)
+    {
+      Flush();
+      return;
+    }
+    float sx = g_graphicsContext.ScaleFinalXCoord(x[i], y[i]);
+    float sy = g_graphicsContext.ScaleFinalYCoord(x[i], y[i]);
+    screen.x1 = min(screen.x1, sx);
+    screen.y1 = min(screen.y1, sy);
+    screen.x2 = max(screen.x2, sx);
+    screen.y2 = max(screen.y2, sy);
+  }
+
+  for (vector<CRect>::const_iterator it = m_bounds.begin(); it != m_bounds.end(); ++it)
+  {
+    if (screen.x1 < it->x2 && it->x1 < screen.x2 &&
+        screen.y1 < it->y2 && it->y1 < screen.y2)
+    {
+      Flush();
+      return;
+    }
+  }
+}
+
+void CGUITextBatch::Remove(const ITextBatchRenderer *renderer)
+{
+  if (renderer && m_pending == renderer)
+  {
+    m_pending = NULL;
+    m_bounds.clear();
+  }
+}
+
+void CGUITextBatch::CountDraw(unsigned int vertexBytes)
+{
+  m_drawCalls++;
+  m_vertexBytes += vertexBytes;
+}
+
+void CGUITextBatch::NextFrame()
+{
+  m_lastDrawCalls = m_drawCalls;
+  m_lastLabels = m_labels;
+  m_lastVertexBytes = m_vertexBytes;
+  m_drawCalls = 0;
+  m_labels = 0;
+  m_vertexBytes = 0;
+}
+
+void CGUITextBatch::GetStats(unsigned int &drawCalls, unsigned int &labels, unsigned int &vertexBytes)
+{
+  drawCalls = m_lastDrawCalls;
+  labels = m_lastLabels;
+  vertexBytes = m_lastVertexBytes;
+}
@@ -0,0 +1,133 @@
+#pragma once
+/*
+ *      Copyright (C) 2012 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+ *  http://www.gnu.org/copyleft/gpl.html
+ *
+ */
+
+
+#include "Geometry.h"
+
+#include <vector>
+
+/*!
+ \ingroup textures
+ \brief Interface of a font renderer whose text draws can be deferred by CGUITextBatch.
+ */
+class ITextBatchRenderer
+{
+public:
+  virtual ~ITextBatchRenderer() {}
+
+  /*!
+   \brief Draw all text that has been queued since the last draw.
+   */
+  virtual void RenderBatch() = 0;
+};
+
+/*!
+ \ingroup textures
+ \brief Merges the text of consecutive labels into a single draw call.
+
+ While a batch is open, a font that finishes a label does not draw it but registers itself
+ as pending along with the screen area of the label. Further labels in the same font append
+ their vertices, so a list of labels ends up as one draw. The pending text is drawn when
+ - another font starts rendering,
+ - a texture is drawn on top of one of the pending labels (see Flush(const CRect&)),
+ - the viewport, scissors, camera or resolution change,
+ - the batch is closed.
+
+ Only the render thread may use this class.
+ */
+class CGUITextBatch
+{
+public:
+  /*!
+   \brief Open a batch. Batches may be nested, text is drawn when the outermost one is closed.
+   */
+  static void Begin();
+
+  /*!
+   \brief Close a batch, drawing any pending text if it was the outermost one.
+   */
+  static void End();
+
+  /*!
+   \brief Whether text draws are currently deferred.
+   */
+  static bool IsBatching() { return m_depth > 0; };
+
+  /*!
+   \brief Register text of a renderer as pending.
+   \param renderer the renderer holding the text. Text of any other renderer is drawn first.
+   \param bounds screen area covered by the text, in final (transformed) coordinates.
+   */
+  static void Defer(ITextBatchRenderer *renderer, const CRect &bounds);
+
+  /*!
+   \brief Whether the given renderer has text pending in the current batch.
+   */
+  static bool IsDeferred(const ITextBatchRenderer *renderer) { return renderer && m_pending == renderer; };
+
+  /*!
+   \brief Draw any pending text.
+   */
+  static void Flush();
+
+  /*!
+   \brief Draw the pending text if it overlaps the given area, so that something drawn on
+   top of it keeps its order.
+   \param rect area about to be drawn, in GUI coordinates of the current transform.
+   */
+  static void Flush(const CRect &rect);
+
+  /*!
+   \brief Drop the pending text of a renderer that is going away.
+   */
+  static void Remove(const ITextBatchRenderer *renderer);
+
+  /*!
+   \brief Account for a draw call of text, for the debug statistics.
+   */
+  static void CountDraw(unsigned int vertexBytes);
+
+  /*!
+   \brief Start counting the statistics of a new frame.
+   */
+  static void NextFrame();
+
+  /*!
+   \brief Statistics of the last complete frame.
+   \param drawCalls number of text draw calls.
+   \param labels number of labels that were drawn as part of a batch.
+   \param vertexBytes size of the vertex data sent for text.
+   */
+  static void GetStats(unsigned int &drawCalls, unsigned int &labels, unsigned int &vertexBytes);
+
+private:
+  static unsigned int m_depth;
+  static ITextBatchRenderer *m_pending;
+  static std::vector<CRect> m_bounds;
+
+  static unsigned int m_drawCalls;
+  static unsigned int m_labels;
+  static unsigned int m_vertexBytes;
+  static unsigned int m_lastDrawCalls;
+  static unsigned int m_lastLabels;
+  static unsigned int m_lastVertexBytes;
+};
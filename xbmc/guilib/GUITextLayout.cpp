@@ -20,6 +20,7 @@
  */
 
 #include "GUITextLayout.h"
+#include "GUITextLayoutCache.h"
 #include "GUIFont.h"
 #include "GUIControl.h"
 #include "GUIColorManager.h"
@@ -208,6 +209,16 @@ bool CGUITextLayout::UpdateW(const CStdStringW &text, float maxWidth /*= 0*/, bo
   if (text.Equals(m_lastText) && !forceUpdate)
     return false;
 
+  // lists recycle their layouts, so the same text is often laid out already
+  bool wrap = m_wrap && maxWidth > 0;
+  CGUITextLayoutCache::CKey key(text, m_font, wrap ? maxWidth : 0, m_maxHeight, forceLTRReadingOrder);
+  if (m_font && CGUITextLayoutCache::GetInstance().Get(key, m_lines, m_colors, m_textWidth, m_textHeight))
+  {
+    m_colors[0] = m_textColor;
+    m_lastText = text;
+    return true;
+  }
+
   vecText parsedText;
 
   // empty out our previous string
@@ -222,7 +233,7 @@ bool CGUITextLayout::UpdateW(const CStdStringW &text, float maxWidth /*= 0*/, bo
   parsedText.push_back(L'\n');
 
   // if we need to wrap the text, then do so
-  if (m_wrap && maxWidth > 0)
+  if (wrap)
     WrapText(parsedText, maxWidth);
   else
     LineBreakText(parsedText, m_lines);
@@ -236,6 +247,9 @@ bool CGUITextLayout::UpdateW(const CStdStringW &text, float maxWidth /*= 0*/, bo
   // and cache the width and height for later reading
   CalcTextExtent();
 
+  if (m_font)
+    CGUITextLayoutCache::GetInstance().Add(key, m_lines, m_colors, m_textWidth, m_textHeight);
+
   m_lastText = text;
   return true;
 }
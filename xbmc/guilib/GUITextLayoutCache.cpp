@@ -0,0 +1,124 @@
+/*
+ *      Copyright (C) 2012 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+ *  http://www.gnu.org/copyleft/gpl.html
+ *
+ */
+
+
+#include "GUITextLayoutCache.h"
+#include "threads/SingleLock.h"
+#include "utils/log.h"
+
+using namespace std;
+
+#define TEXT_LAYOUT_CACHE_SIZE 2000
+
+CGUITextLayoutCache::CKey::CKey(const CStdStringW &text, const CGUIFont *font, float maxWidth, float maxHeight, bool forceLTRReadingOrder)
+  : m_text(text), m_font(font), m_maxWidth(maxWidth), m_maxHeight(maxHeight), m_forceLTRReadingOrder(forceLTRReadingOrder)
+{
+}
+
+bool CGUITextLayoutCache::CKey::operator<(const CKey &right) const
+{
+  if (m_font != right.m_font)
+    return m_font < right.m_font;
+  if (m_maxWidth != right.m_maxWidth)
+    return m_maxWidth < right.m_maxWidth;
+  if (m_maxHeight != right.m_maxHeight)
+    return m_maxHeight < right.m_maxHeight;
+  if (m_forceLTRReadingOrder != right.m_forceLTRReadingOrder)
+    return right.m_forceLTRReadingOrder;
+  return m_text.compare(right.m_text) < 0;
+}
+
+CGUITextLayoutCache::CGUITextLayoutCache()
+{
+  m_hits = 0;
+  m_misses = 0;
+}
+
+CGUITextLayoutCache &CGUITextLayoutCache::GetInstance()
+{
+  static CGUITextLayoutCache layoutCache;
+  return layoutCache;
+}
+
+bool CGUITextLayoutCache::Get(const CKey &key, vector<CGUIString> &lines, vecColors &colors, float &width, float &height)
+{
+  CSingleLock lock(m_section);
+  LayoutMap::iterator it = m_lookup.find(key);
+  if (it == m_lookup.end())
+  {
+    m_misses++;
+    return false;
+  }
+  m_hits++;
+
+  // move to the front of the list
+  m_layouts.splice(m_layouts.begin(), m_layouts, it->second);
+
+  const CLayout &layout = it->second->second;
+  lines = layout.m_lines;
+  colors = layout.m_colors;
+  width = layout.m_width;
+  height = layout.m_height;
+  return true;
+}
+
+void CGUITextLayoutCache::Add(const CKey &key, const vector<CGUIString> &lines, const vecColors &colors, float width, float height)
+{
+  CSingleLock lock(m_section);
+  LayoutMap::iterator it = m_lookup.find(key);
+  if (it != m_lookup.end())
+  {
+    m_layouts.erase(it->second);
+    m_lookup.erase(it);
+  }
+  else if (m_lookup.size() >= TEXT_LAYOUT_CACHE_SIZE)
+  {
+    m_lookup.erase(m_layouts.back().first);
+    m_layouts.pop_back();
+  }
+
+  CLayout layout;
+  layout.m_lines = lines;
+  layout.m_colors = colors;
+  layout.m_width = width;
+  layout.m_height = height;
+  m_layouts.push_front(make_pair(key, layout));
+  m_lookup.insert(make_pair(key, m_layouts.begin()));
+}
+
+void CGUITextLayoutCache::Clear()
+{
+  CSingleLock lock(m_section);
+  if (m_hits + m_misses)
+    CLog::Log(LOGDEBUG, "%s - dropping %u layouts, %u hits, %u misses (%.1f%% hit rate)", __FUNCTION__,
+              (unsigned int)m_lookup.size(), m_hits, m_misses, 100.0f * m_hits / (m_hits + m_misses));
+  m_lookup.clear();
+  m_layouts.clear();
+  m_hits = 0;
+  m_misses = 0;
+}
+
+void CGUITextLayoutCache::GetStats(unsigned int &hits, unsigned int &misses) const
+{
+  CSingleLock lock(m_section);
+  hits = m_hits;
+  misses = m_misses;
+}
@@ -0,0 +1,102 @@
+#pragma once
+/*
+ *      Copyright (C) 2012 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+ *  http://www.gnu.org/copyleft/gpl.html
+ *
+ */
+
+
+#include "GUITextLayout.h"
+#include "threads/CriticalSection.h"
+
+#include <list>
+#include <map>
+
+/*!
+ \ingroup textures
+ \brief Least recently used cache of laid out text, shared by all CGUITextLayout objects.
+
+ Lists recycle their item layouts while scrolling, so the same labels are parsed, wrapped
+ and measured over and over. The cache keeps the result of CGUITextLayout::UpdateW keyed on
+ everything that affects it: the text, the font, the wrapping width and the reading order.
+
+ The font is identified by its pointer, so the cache must be cleared whenever a font is
+ deleted or has its metrics changed (see GUIFontManager).
+ */
+class CGUITextLayoutCache
+{
+public:
+  class CKey
+  {
+  public:
+    CKey(const CStdStringW &text, const CGUIFont *font, float maxWidth, float maxHeight, bool forceLTRReadingOrder);
+    bool operator<(const CKey &right) const;
+
+    CStdStringW m_text;
+    const CGUIFont *m_font;
+    float m_maxWidth;        ///< wrapping width, 0 if the text isn't wrapped
+    float m_maxHeight;
+    bool m_forceLTRReadingOrder;
+  };
+
+  static CGUITextLayoutCache &GetInstance();
+
+  /*!
+   \brief Look up a layout, marking it as most recently used.
+   \return true if the layout was cached and has been copied to the out parameters.
+   */
+  bool Get(const CKey &key, std::vector<CGUIString> &lines, vecColors &colors, float &width, float &height);
+
+  /*!
+   \brief Store a layout, dropping the least recently used one if the cache is full.
+   */
+  void Add(const CKey &key, const std::vector<CGUIString> &lines, const vecColors &colors, float width, float height);
+
+  /*!
+   \brief Drop all layouts, e.g. when fonts are reloaded.
+   */
+  void Clear();
+
+  /*!
+   \brief Lookup statistics since the cache was last cleared.
+   */
+  void GetStats(unsigned int &hits, unsigned int &misses) const;
+
+private:
+  CGUITextLayoutCache();
+  CGUITextLayoutCache(const CGUITextLayoutCache&);
+  CGUITextLayoutCache const& operator=(CGUITextLayoutCache const&);
+
+  class CLayout
+  {
+  public:
+    std::vector<CGUIString> m_lines;
+    vecColors m_colors;
+    float m_width;
+    float m_height;
+  };
+
+  typedef std::list< std::pair<CKey, CLayout> > LayoutList;
+  typedef std::map<CKey, LayoutList::iterator> LayoutMap;
+
+  LayoutList m_layouts;   ///< most recently used first
+  LayoutMap  m_lookup;
+  unsigned int m_hits;
+  unsigned int m_misses;
+  mutable CCriticalSection m_section;
+};
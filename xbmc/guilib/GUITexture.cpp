@@ -23,6 +23,7 @@
 #include "GraphicContext.h"
 #include "TextureManager.h"
 #include "GUILargeTextureManager.h"
+#include "GUITextBatch.h"
 #include "utils/MathUtils.h"
 
 using namespace std;
@@ -179,6 +180,9 @@ void CGUITextureBase::Render()
   if (m_alpha != 0xFF) color = MIX_ALPHA(m_alpha, m_diffuseColor);
   color = g_graphicsContext.MergeAlpha(color);
 
+  // text waiting to be drawn underneath us has to go first
+  CGUITextBatch::Flush(m_vertex);
+
   // setup our renderer
   Begin(color);
 
@@ -23,6 +23,7 @@
 #if defined(HAS_GL)
 #include "GUITextureGL.h"
 #endif
+#include "GUITextBatch.h"
 #include "Texture.h"
 #include "utils/log.h"
 #include "utils/GLUtils.h"
@@ -137,6 +138,8 @@ void CGUITextureGL::Draw(float *x, float *y, float *z, const CRect &texture, con
 
 void CGUITextureGL::DrawQuad(const CRect &rect, color_t color, CBaseTexture *texture, const CRect *texCoords)
 {
+  CGUITextBatch::Flush();
+
   if (texture)
   {
     texture->LoadToGPU();
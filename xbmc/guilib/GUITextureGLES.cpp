@@ -23,6 +23,7 @@
 #if defined(HAS_GLES)
 #include "GUITextureGLES.h"
 #endif
+#include "GUITextBatch.h"
 #include "Texture.h"
 #include "utils/log.h"
 #include "utils/GLUtils.h"
@@ -213,6 +214,8 @@ void CGUITextureGLES::Draw(float *x, float *y, float *z, const CRect &texture, c
 
 void CGUITextureGLES::DrawQuad(const CRect &rect, color_t color, CBaseTexture *texture, const CRect *texCoords)
 {
+  CGUITextBatch::Flush();
+
   if (texture)
   {
     texture->LoadToGPU();
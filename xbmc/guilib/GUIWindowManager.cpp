@@ -32,6 +32,7 @@
 #include "settings/AdvancedSettings.h"
 #include "addons/Skin.h"
 #include "GUITexture.h"
+#include "GUITextBatch.h"
 #include "windowing/WindowingFactory.h"
 #include "utils/Variant.h"
 
@@ -106,7 +107,7 @@ bool CGUIWindowManager::SendMessage(CGUIMessage& message)
   bool modalAcceptedMessage(false);
   // don't use an iterator for this loop, as some messages mean that m_activeDialogs is altered,
   // which will invalidate any iterator
-  CSingleLock lock(g_graphicsContext);
+  CSingleLock lock(m_stackSection);
   unsigned int topWindow = m_activeDialogs.size();
   while (topWindow)
   {
@@ -183,6 +184,7 @@ void CGUIWindowManager::Add(CGUIWindow* pWindow)
   }
   // push back all the windows if there are more than one covered by this class
   CSingleLock lock(g_graphicsContext);
+  CSingleLock stackLock(m_stackSection);
   for (int i = 0; i < pWindow->GetIDRange(); i++)
   {
     WindowMap::iterator it = m_mapWindows.find(pWindow->GetID() + i);
@@ -207,6 +209,7 @@ void CGUIWindowManager::AddCustomWindow(CGUIWindow* pWindow)
 void CGUIWindowManager::AddModeless(CGUIWindow* dialog)
 {
   CSingleLock lock(g_graphicsContext);
+  CSingleLock stackLock(m_stackSection);
   // only add the window if it's not already added
   for (iDialog it = m_activeDialogs.begin(); it != m_activeDialogs.end(); ++it)
     if (*it == dialog) return;
@@ -216,6 +219,7 @@ void CGUIWindowManager::AddModeless(CGUIWindow* dialog)
 void CGUIWindowManager::Remove(int id)
 {
   CSingleLock lock(g_graphicsContext);
+  CSingleLock stackLock(m_stackSection);
   WindowMap::iterator it = m_mapWindows.find(id);
   if (it != m_mapWindows.end())
   {
@@ -281,9 +285,13 @@ void CGUIWindowManager::PreviousWindow()
     }
     return;
   }
-  m_windowHistory.pop();
-  int previousWindow = GetActiveWindow();
-  m_windowHistory.push(currentWindow);
+  int previousWindow;
+  {
+    CSingleLock stackLock(m_stackSection);
+    m_windowHistory.pop();
+    previousWindow = GetActiveWindow();
+    m_windowHistory.push(currentWindow);
+  }
 
   CGUIWindow *pNewWindow = GetWindow(previousWindow);
   if (!pNewWindow)
@@ -309,7 +317,9 @@ void CGUIWindowManager::PreviousWindow()
   g_infoManager.SetPreviousWindow(currentWindow);
 
   // remove the current window off our window stack
-  m_windowHistory.pop();
+  { CSingleLock stackLock(m_stackSection);
+    m_windowHistory.pop();
+  }
 
   // ok, initialize the new window
   CLog::Log(LOGDEBUG,"CGUIWindowManager::PreviousWindow: Activate new");
@@ -420,9 +430,12 @@ void CGUIWindowManager::ActivateWindow_Internal(int iWindowID, const vector<CStd
   // as all messages done in WINDOW_INIT will want to be sent to the new
   // topmost window).  If we are swapping windows, we pop the old window
   // off the history stack
-  if (swappingWindows && m_windowHistory.size())
-    m_windowHistory.pop();
-  AddToWindowHistory(iWindowID);
+  {
+    CSingleLock stackLock(m_stackSection);
+    if (swappingWindows && m_windowHistory.size())
+      m_windowHistory.pop();
+    AddToWindowHistory(iWindowID);
+  }
 
   g_infoManager.SetPreviousWindow(currentWindow);
   // Send the init message
@@ -444,7 +457,7 @@ void CGUIWindowManager::CloseDialogs(bool forceClose)
 
 bool CGUIWindowManager::OnAction(const CAction &action)
 {
-  CSingleLock lock(g_graphicsContext);
+  CSingleLock lock(m_stackSection);
   unsigned int topMost = m_activeDialogs.size();
   while (topMost)
   {
@@ -546,6 +559,7 @@ bool CGUIWindowManager::Render()
   CSingleLock lock(g_graphicsContext);
 
   CDirtyRegionList dirtyRegions = m_tracker.GetDirtyRegions();
+  CGUITextBatch::NextFrame();
 
   bool hasRendered = false;
   // If we visualize the regions we will always render the entire viewport
@@ -625,7 +639,7 @@ CGUIWindow* CGUIWindowManager::GetWindow(int id) const
     return NULL;
   }
 
-  CSingleLock lock(g_graphicsContext);
+  CSingleLock lock(m_stackSection);
   WindowMap::const_iterator it = m_mapWindows.find(id);
   if (it != m_mapWindows.end())
     return (*it).second;
@@ -678,7 +692,9 @@ void CGUIWindowManager::DeInitialize()
 
   // clear our vectors of windows
   m_vecCustomWindows.clear();
-  m_activeDialogs.clear();
+  { CSingleLock stackLock(m_stackSection);
+    m_activeDialogs.clear();
+  }
 
   m_initialized = false;
 }
@@ -688,6 +704,7 @@ void CGUIWindowManager::DeInitialize()
 void CGUIWindowManager::RouteToWindow(CGUIWindow* dialog)
 {
   CSingleLock lock(g_graphicsContext);
+  CSingleLock stackLock(m_stackSection);
   // Just to be sure: Unroute this window,
   // #we may have routed to it before
   RemoveDialog(dialog->GetID());
@@ -700,6 +717,7 @@ void CGUIWindowManager::RouteToWindow(CGUIWindow* dialog)
 void CGUIWindowManager::RemoveDialog(int id)
 {
   CSingleLock lock(g_graphicsContext);
+  CSingleLock stackLock(m_stackSection);
   for (iDialog it = m_activeDialogs.begin(); it != m_activeDialogs.end(); ++it)
   {
     if ((*it)->GetID() == id)
@@ -712,7 +730,7 @@ void CGUIWindowManager::RemoveDialog(int id)
 
 bool CGUIWindowManager::HasModalDialog() const
 {
-  CSingleLock lock(g_graphicsContext);
+  CSingleLock lock(m_stackSection);
   for (ciDialog it = m_activeDialogs.begin(); it != m_activeDialogs.end(); ++it)
   {
     CGUIWindow *window = *it;
@@ -727,6 +745,7 @@ bool CGUIWindowManager::HasModalDialog() const
 
 bool CGUIWindowManager::HasDialogOnScreen() const
 {
+  CSingleLock lock(m_stackSection);
   return (m_activeDialogs.size() > 0);
 }
 
@@ -734,7 +753,7 @@ bool CGUIWindowManager::HasDialogOnScreen() const
 /// \return id ID of the window or WINDOW_INVALID if no routed window available
 int CGUIWindowManager::GetTopMostModalDialogID(bool ignoreClosing /*= false*/) const
 {
-  CSingleLock lock(g_graphicsContext);
+  CSingleLock lock(m_stackSection);
   for (crDialog it = m_activeDialogs.rbegin(); it != m_activeDialogs.rend(); ++it)
   {
     CGUIWindow *dialog = *it;
@@ -793,6 +812,7 @@ void CGUIWindowManager::AddMsgTarget( IMsgTargetCallback* pMsgTarget )
 
 int CGUIWindowManager::GetActiveWindow() const
 {
+  CSingleLock lock(m_stackSection);
   if (!m_windowHistory.empty())
     return m_windowHistory.top();
   return WINDOW_INVALID;
@@ -814,7 +834,7 @@ bool CGUIWindowManager::IsWindowActive(int id, bool ignoreClosing /* = true */)
   id &= WINDOW_ID_MASK;
   if ((GetActiveWindow() & WINDOW_ID_MASK) == id) return true;
   // run through the dialogs
-  CSingleLock lock(g_graphicsContext);
+  CSingleLock lock(m_stackSection);
   for (ciDialog it = m_activeDialogs.begin(); it != m_activeDialogs.end(); ++it)
   {
     CGUIWindow *window = *it;
@@ -826,7 +846,7 @@ bool CGUIWindowManager::IsWindowActive(int id, bool ignoreClosing /* = true */)
 
 bool CGUIWindowManager::IsWindowActive(const CStdString &xmlFile, bool ignoreClosing /* = true */) const
 {
-  CSingleLock lock(g_graphicsContext);
+  CSingleLock lock(m_stackSection);
   CGUIWindow *window = GetWindow(GetActiveWindow());
   if (window && URIUtils::GetFileName(window->GetProperty("xmlfile").asString()).Equals(xmlFile)) return true;
   // run through the dialogs
@@ -901,6 +921,7 @@ void CGUIWindowManager::AddToWindowHistory(int newWindowID)
   // Check the window stack to see if this window is in our history,
   // and if so, pop all the other windows off the stack so that we
   // always have a predictable "Back" behaviour for each window
+  CSingleLock lock(m_stackSection);
   stack<int> historySave = m_windowHistory;
   while (historySave.size())
   {
@@ -922,7 +943,7 @@ void CGUIWindowManager::GetActiveModelessWindows(vector<int> &ids)
 {
   // run through our modeless windows, and construct a vector of them
   // useful for saving and restoring the modeless windows on skin change etc.
-  CSingleLock lock(g_graphicsContext);
+  CSingleLock lock(m_stackSection);
   for (iDialog it = m_activeDialogs.begin(); it != m_activeDialogs.end(); ++it)
   {
     if (!(*it)->IsModalDialog())
@@ -932,7 +953,7 @@ void CGUIWindowManager::GetActiveModelessWindows(vector<int> &ids)
 
 CGUIWindow *CGUIWindowManager::GetTopMostDialog() const
 {
-  CSingleLock lock(g_graphicsContext);
+  CSingleLock lock(m_stackSection);
   // find the window with the lowest render order
   vector<CGUIWindow *> renderList = m_activeDialogs;
   stable_sort(renderList.begin(), renderList.end(), RenderOrderSortFunction);
@@ -962,6 +983,7 @@ bool CGUIWindowManager::IsWindowTopMost(const CStdString &xmlFile) const
 
 void CGUIWindowManager::ClearWindowHistory()
 {
+  CSingleLock lock(m_stackSection);
   while (m_windowHistory.size())
     m_windowHistory.pop();
 }
@@ -156,6 +156,13 @@ private:
 
   std::stack<int> m_windowHistory;
 
+  // The window stack (m_mapWindows, m_activeDialogs and m_windowHistory) is
+  // only altered while holding both the graphics context and m_stackSection,
+  // so either is enough to read it. Queries from other threads take just
+  // m_stackSection and don't wait on the render thread. Never call into a
+  // window (other than trivial getters) while holding m_stackSection.
+  mutable CCriticalSection m_stackSection;
+
   IWindowManagerCallback* m_pCallback;
   std::vector < std::pair<CGUIMessage*,int> > m_vecThreadMessages;
   CCriticalSection m_critSection;
@@ -31,6 +31,7 @@
 #include "TextureManager.h"
 #include "input/MouseStat.h"
 #include "GUIWindowManager.h"
+#include "GUITextBatch.h"
 #include "utils/JobManager.h"
 #include "video/VideoReferenceClock.h"
 
@@ -154,6 +155,7 @@ void CGraphicContext::ClipRect(CRect &vertex, CRect &texture, CRect *texture2)
 
 bool CGraphicContext::SetViewPort(float fx, float fy, float fwidth, float fheight, bool intersectPrevious /* = false */)
 {
+  CGUITextBatch::Flush();
   CRect oldviewport;
   g_Windowing.GetViewPort(oldviewport);
 
@@ -226,6 +228,7 @@ bool CGraphicContext::SetViewPort(float fx, float fy, float fwidth, float fheigh
 
 void CGraphicContext::RestoreViewPort()
 {
+  CGUITextBatch::Flush();
   if (!m_viewStack.size()) return;
 
   CRect oldviewport = m_viewStack.top();
@@ -238,6 +241,7 @@ void CGraphicContext::RestoreViewPort()
 
 void CGraphicContext::SetScissors(const CRect &rect)
 {
+  CGUITextBatch::Flush();
   m_scissors = rect;
   m_scissors.Intersect(CRect(0,0,(float)m_iScreenWidth, (float)m_iScreenHeight));
   g_Windowing.SetScissors(m_scissors);
@@ -245,6 +249,7 @@ void CGraphicContext::SetScissors(const CRect &rect)
 
 void CGraphicContext::ResetScissors()
 {
+  CGUITextBatch::Flush();
   m_scissors.SetRect(0, 0, (float)m_iScreenWidth, (float)m_iScreenHeight);
   g_Windowing.ResetScissors(); // SetScissors(m_scissors) instead?
 }
@@ -725,6 +730,7 @@ CRect CGraphicContext::generateAABB(const CRect &rect) const
 //       to cut down on one setting)
 void CGraphicContext::UpdateCameraPosition(const CPoint &camera)
 {
+  CGUITextBatch::Flush();
   g_Windowing.SetCameraPosition(camera, m_iScreenWidth, m_iScreenHeight);
 }
 
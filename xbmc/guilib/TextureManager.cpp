@@ -226,6 +226,7 @@ const CTextureArray& CGUITextureManager::GetTexture(const CStdString& strTexture
 {
   static CTextureArray emptyTexture;
   //  CLog::Log(LOGINFO, " refcount++ for  GetTexture(%s)\n", strTextureName.c_str());
+  CSingleLock lock(m_texturesSection);
   for (int i = 0; i < (int)m_vecTextures.size(); ++i)
   {
     CTextureMap *pMap = m_vecTextures[i];
@@ -265,22 +266,28 @@ bool CGUITextureManager::HasTexture(const CStdString &textureName, CStdString *p
 
   // Check our loaded and bundled textures - we store in bundles using \\.
   CStdString bundledName = CTextureBundle::Normalize(textureName);
-  for (int i = 0; i < (int)m_vecTextures.size(); ++i)
   {
-    CTextureMap *pMap = m_vecTextures[i];
-    if (pMap->GetName() == textureName)
+    CSingleLock lock(m_texturesSection);
+    for (int i = 0; i < (int)m_vecTextures.size(); ++i)
     {
-      if (size) *size = 1;
-      return true;
+      CTextureMap *pMap = m_vecTextures[i];
+      if (pMap->GetName() == textureName)
+      {
+        if (size) *size = 1;
+        return true;
+      }
     }
   }
 
-  for (int i = 0; i < 2; i++)
   {
-    if (m_TexBundle[i].HasFile(bundledName))
+    CSingleLock lock(m_bundleSection);
+    for (int i = 0; i < 2; i++)
     {
-      if (bundle) *bundle = i;
-      return true;
+      if (m_TexBundle[i].HasFile(bundledName))
+      {
+        if (bundle) *bundle = i;
+        return true;
+      }
     }
   }
 
@@ -305,9 +312,8 @@ int CGUITextureManager::Load(const CStdString& strTextureName, bool checkBundleO
   if (checkBundleOnly && bundle == -1)
     return 0;
 
-  //Lock here, we will do stuff that could break rendering
-  CSingleLock lock(g_graphicsContext);
-
+  // no graphics context needed here - textures are only decoded into memory,
+  // the upload happens on first bind from the render thread.
 #ifdef _DEBUG
   int64_t start;
   start = CurrentHostCounter();
@@ -322,7 +328,11 @@ int CGUITextureManager::Load(const CStdString& strTextureName, bool checkBundleO
       CBaseTexture **pTextures;
       int nLoops = 0, width = 0, height = 0;
       int* Delay;
-      int nImages = m_TexBundle[bundle].LoadAnim(strTextureName, &pTextures, width, height, nLoops, &Delay);
+      int nImages;
+      {
+        CSingleLock lock(m_bundleSection);
+        nImages = m_TexBundle[bundle].LoadAnim(strTextureName, &pTextures, width, height, nLoops, &Delay);
+      }
       if (!nImages)
       {
         CLog::Log(LOGERROR, "Texture manager unable to load bundled file: %s", strTextureName.c_str());
@@ -384,14 +394,14 @@ int CGUITextureManager::Load(const CStdString& strTextureName, bool checkBundleO
     OutputDebugString(temp);
 #endif
 
-    m_vecTextures.push_back(pMap);
-    return 1;
+    return AddTexture(pMap);
   } // of if (strPath.Right(4).ToLower()==".gif")
 
   CBaseTexture *pTexture = NULL;
   int width = 0, height = 0;
   if (bundle >= 0)
   {
+    CSingleLock lock(m_bundleSection);
     if (FAILED(m_TexBundle[bundle].LoadTexture(strTextureName, &pTexture, width, height)))
     {
       CLog::Log(LOGERROR, "Texture manager unable to load bundled file: %s", strTextureName.c_str());
@@ -411,7 +421,6 @@ int CGUITextureManager::Load(const CStdString& strTextureName, bool checkBundleO
 
   CTextureMap* pMap = new CTextureMap(strTextureName, width, height, 0);
   pMap->Add(pTexture, 100);
-  m_vecTextures.push_back(pMap);
 
 #ifdef _DEBUG_TEXTURES
   int64_t end, freq;
@@ -422,13 +431,30 @@ int CGUITextureManager::Load(const CStdString& strTextureName, bool checkBundleO
   OutputDebugString(temp);
 #endif
 
+  return AddTexture(pMap);
+}
+
+int CGUITextureManager::AddTexture(CTextureMap *map)
+{
+  CSingleLock lock(m_texturesSection);
+  for (ivecTextures i = m_vecTextures.begin(); i != m_vecTextures.end(); ++i)
+  {
+    if ((*i)->GetName() == map->GetName())
+    { // another thread loaded it while we were decoding - keep theirs
+      lock.Leave();
+      CSingleLock gfxLock(g_graphicsContext);
+      delete map;
+      return 1;
+    }
+  }
+  m_vecTextures.push_back(map);
   return 1;
 }
 
 
 void CGUITextureManager::ReleaseTexture(const CStdString& strTextureName)
 {
-  CSingleLock lock(g_graphicsContext);
+  CSingleLock lock(m_texturesSection);
 
   ivecTextures i;
   i = m_vecTextures.begin();
@@ -453,7 +479,8 @@ void CGUITextureManager::ReleaseTexture(const CStdString& strTextureName)
 
 void CGUITextureManager::FreeUnusedTextures()
 {
-  CSingleLock lock(g_graphicsContext);
+  CSingleLock gfxLock(g_graphicsContext);
+  CSingleLock lock(m_texturesSection);
   for (ivecTextures i = m_unusedTextures.begin(); i != m_unusedTextures.end(); ++i)
     delete *i;
   m_unusedTextures.clear();
@@ -461,7 +488,8 @@ void CGUITextureManager::FreeUnusedTextures()
 
 void CGUITextureManager::Cleanup()
 {
-  CSingleLock lock(g_graphicsContext);
+  CSingleLock gfxLock(g_graphicsContext);
+  CSingleLock lock(m_texturesSection);
 
   ivecTextures i;
   i = m_vecTextures.begin();
@@ -472,13 +500,17 @@ void CGUITextureManager::Cleanup()
     delete pMap;
     i = m_vecTextures.erase(i);
   }
-  for (int i = 0; i < 2; i++)
-    m_TexBundle[i].Cleanup();
+  {
+    CSingleLock bundleLock(m_bundleSection);
+    for (int i = 0; i < 2; i++)
+      m_TexBundle[i].Cleanup();
+  }
   FreeUnusedTextures();
 }
 
 void CGUITextureManager::Dump() const
 {
+  CSingleLock lock(m_texturesSection);
   CStdString strLog;
   strLog.Format("total texturemaps size:%i\n", m_vecTextures.size());
   OutputDebugString(strLog.c_str());
@@ -493,7 +525,8 @@ void CGUITextureManager::Dump() const
 
 void CGUITextureManager::Flush()
 {
-  CSingleLock lock(g_graphicsContext);
+  CSingleLock gfxLock(g_graphicsContext);
+  CSingleLock lock(m_texturesSection);
 
   ivecTextures i;
   i = m_vecTextures.begin();
@@ -516,6 +549,7 @@ void CGUITextureManager::Flush()
 unsigned int CGUITextureManager::GetMemoryUsage() const
 {
   unsigned int memUsage = 0;
+  CSingleLock lock(m_texturesSection);
   for (int i = 0; i < (int)m_vecTextures.size(); ++i)
   {
     memUsage += m_vecTextures[i]->GetMemoryUsage();
@@ -578,6 +612,7 @@ CStdString CGUITextureManager::GetTexturePath(const CStdString &textureName, boo
 
 void CGUITextureManager::GetBundledTexturesFromPath(const CStdString& texturePath, std::vector<CStdString> &items)
 {
+  CSingleLock lock(m_bundleSection);
   m_TexBundle[0].GetTexturesFromPath(texturePath, items);
   if (items.empty())
     m_TexBundle[1].GetTexturesFromPath(texturePath, items);
@@ -125,6 +125,7 @@ public:
 
   void FreeUnusedTextures(); ///< Free textures (called from app thread only)
 protected:
+  int AddTexture(CTextureMap *map);
   std::vector<CTextureMap*> m_vecTextures;
   std::vector<CTextureMap*> m_unusedTextures;
   typedef std::vector<CTextureMap*>::iterator ivecTextures;
@@ -133,6 +134,12 @@ protected:
 
   std::vector<CStdString> m_texturePaths;
   CCriticalSection m_section;
+
+  // the loaded textures and the bundles have their own locks so that loading
+  // doesn't need the graphics context. Anything that frees textures takes the
+  // graphics context first, then m_texturesSection.
+  mutable CCriticalSection m_texturesSection; ///< guards m_vecTextures and m_unusedTextures
+  CCriticalSection m_bundleSection;           ///< guards m_TexBundle (they share a file handle)
 };
 
 /*!
@@ -21,7 +21,9 @@
 
 #include "AnnouncementManager.h"
 #include "threads/SingleLock.h"
+#include "threads/Thread.h"
 #include <stdio.h>
+#include <string.h>
 #include "utils/log.h"
 #include "utils/Variant.h"
 #include "utils/StringUtils.h"
@@ -32,11 +34,85 @@
 
 #define LOOKUP_PROPERTY "database-lookup"
 
+// announcements waiting for delivery before the oldest ones are dropped
+#define ANNOUNCEMENT_QUEUE_SIZE 256
+
 using namespace std;
 using namespace ANNOUNCEMENT;
 
+namespace ANNOUNCEMENT
+{
+  class CAnnouncementDispatcher : public CThread
+  {
+  public:
+    CAnnouncementDispatcher() : CThread("CAnnouncementDispatcher") { }
+
+  protected:
+    virtual void Process()
+    {
+      while (!m_bStop)
+      {
+        CAnnouncementManager::m_queueEvent.WaitMSec(1000);
+        CAnnouncementManager::DispatchQueue();
+      }
+
+      // whatever was announced before we were stopped still goes out
+      CAnnouncementManager::DispatchQueue();
+    }
+  };
+}
+
+// Only the latest state of these is of interest, so a burst of them that
+// has not been delivered yet collapses into one announcement
+static const char *coalescableMessages[] = { "OnSeek", "OnSpeedChanged", "OnVolumeChanged" };
+
+static bool IsCoalescable(const char *message)
+{
+  for (unsigned int i = 0; i < sizeof(coalescableMessages) / sizeof(coalescableMessages[0]); i++)
+  {
+    if (strcmp(message, coalescableMessages[i]) == 0)
+      return true;
+  }
+  return false;
+}
+
 CCriticalSection CAnnouncementManager::m_critSection;
 vector<IAnnouncer *> CAnnouncementManager::m_announcers;
+deque<CAnnouncementManager::CQueuedAnnouncement> CAnnouncementManager::m_queue;
+CCriticalSection CAnnouncementManager::m_queueSection;
+unsigned int CAnnouncementManager::m_deliveries = 0;
+XbmcThreads::ConditionVariable CAnnouncementManager::m_delivered;
+XbmcThreads::ThreadLocal<const deque<CAnnouncementManager::CQueuedAnnouncement> > CAnnouncementManager::m_delivering;
+CEvent CAnnouncementManager::m_queueEvent;
+CAnnouncementDispatcher *CAnnouncementManager::m_dispatcher = NULL;
+
+void CAnnouncementManager::Start()
+{
+  CSingleLock lock(m_queueSection);
+  if (m_dispatcher)
+    return;
+
+  m_dispatcher = new CAnnouncementDispatcher();
+  m_dispatcher->Create();
+}
+
+void CAnnouncementManager::Stop()
+{
+  CAnnouncementDispatcher *dispatcher;
+  {
+    CSingleLock lock(m_queueSection);
+    dispatcher = m_dispatcher;
+    m_dispatcher = NULL;
+  }
+
+  if (!dispatcher)
+    return;
+
+  dispatcher->StopThread(false);
+  m_queueEvent.Set();
+  dispatcher->StopThread(true);
+  delete dispatcher;
+}
 
 void CAnnouncementManager::AddAnnouncer(IAnnouncer *listener)
 {
@@ -58,9 +134,15 @@ void CAnnouncementManager::RemoveAnnouncer(IAnnouncer *listener)
     if (m_announcers[i] == listener)
     {
       m_announcers.erase(m_announcers.begin() + i);
-      return;
+      break;
     }
   }
+
+  // announcers are called unlocked, so another thread may still be calling
+  // this one. Its caller is about to destroy it, so wait until that is done.
+  unsigned int own = m_delivering.get() ? 1 : 0;
+  while (m_deliveries > own)
+    m_delivered.wait(m_critSection);
 }
 
 void CAnnouncementManager::Announce(AnnouncementFlag flag, const char *sender, const char *message)
@@ -72,9 +154,106 @@ void CAnnouncementManager::Announce(AnnouncementFlag flag, const char *sender, c
 void CAnnouncementManager::Announce(AnnouncementFlag flag, const char *sender, const char *message, CVariant &data)
 {
   CLog::Log(LOGDEBUG, "CAnnouncementManager - Announcement: %s from %s", message, sender);
-  CSingleLock lock (m_critSection);
-  for (unsigned int i = 0; i < m_announcers.size(); i++)
-    m_announcers[i]->Announce(flag, sender, message, data);
+
+  // sleep, wake and quit have to be handled before the caller carries on,
+  // unless an announcer announces them while it handles another announcement
+  if ((flag != System || m_delivering.get()) && Queue(flag, sender, message, data))
+    return;
+
+  // but not before what was announced ahead of them, e.g. OnStop before OnQuit.
+  // Only a batch the dispatcher took already may still be on its way.
+  deque<CQueuedAnnouncement> announcements;
+  {
+    CSingleLock lock (m_queueSection);
+    announcements.swap(m_queue);
+  }
+  announcements.push_back(CQueuedAnnouncement());
+  CQueuedAnnouncement &announcement = announcements.back();
+  announcement.flag    = flag;
+  announcement.sender  = sender;
+  announcement.message = message;
+  announcement.data    = data;
+
+  Deliver(announcements);
+}
+
+bool CAnnouncementManager::Queue(AnnouncementFlag flag, const char *sender, const char *message, const CVariant &data)
+{
+  CSingleLock lock (m_queueSection);
+  if (!m_dispatcher)
+    return false;
+
+  if (!m_queue.empty() && IsCoalescable(message))
+  {
+    CQueuedAnnouncement &last = m_queue.back();
+    if (last.flag == flag && last.sender == sender && last.message == message)
+    {
+      last.data = data;
+      return true;
+    }
+  }
+
+  if (m_queue.size() >= ANNOUNCEMENT_QUEUE_SIZE)
+  {
+    CLog::Log(LOGWARNING, "CAnnouncementManager - Queue full, dropping announcement %s from %s",
+              m_queue.front().message.c_str(), m_queue.front().sender.c_str());
+    m_queue.pop_front();
+  }
+
+  m_queue.push_back(CQueuedAnnouncement());
+  CQueuedAnnouncement &announcement = m_queue.back();
+  announcement.flag    = flag;
+  announcement.sender  = sender;
+  announcement.message = message;
+  announcement.data    = data;
+
+  m_queueEvent.Set();
+  return true;
+}
+
+void CAnnouncementManager::DispatchQueue()
+{
+  while (true)
+  {
+    deque<CQueuedAnnouncement> announcements;
+    {
+      CSingleLock lock (m_queueSection);
+      if (m_queue.empty())
+        return;
+      announcements.swap(m_queue);
+    }
+
+    Deliver(announcements);
+  }
+}
+
+void CAnnouncementManager::Deliver(const deque<CQueuedAnnouncement> &announcements)
+{
+  // no lock is held while the announcers run, they may wait for other
+  // threads that announce themselves
+  vector<IAnnouncer *> announcers;
+  const deque<CQueuedAnnouncement> *outer = m_delivering.get();
+  {
+    CSingleLock lock (m_critSection);
+    announcers = m_announcers;
+    if (!outer)
+      m_deliveries++;
+  }
+
+  m_delivering.set(&announcements);
+  for (deque<CQueuedAnnouncement>::const_iterator it = announcements.begin(); it != announcements.end(); ++it)
+  {
+    for (unsigned int i = 0; i < announcers.size(); i++)
+      announcers[i]->Announce(it->flag, it->sender.c_str(), it->message.c_str(), it->data);
+  }
+  m_delivering.set(const_cast<deque<CQueuedAnnouncement> *>(outer));
+
+  if (!outer)
+  {
+    CSingleLock lock (m_critSection);
+    m_deliveries--;
+    m_delivered.notifyAll();
+  }
 }
 
 void CAnnouncementManager::Announce(AnnouncementFlag flag, const char *sender, const char *message, CFileItemPtr item)
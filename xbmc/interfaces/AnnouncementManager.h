@@ -22,11 +22,19 @@
 
 #include "IAnnouncer.h"
 #include "FileItem.h"
+#include "threads/Condition.h"
 #include "threads/CriticalSection.h"
+#include "threads/Event.h"
+#include "threads/ThreadLocal.h"
+#include "utils/Variant.h"
+#include <deque>
+#include <string>
 #include <vector>
 
 namespace ANNOUNCEMENT
 {
+  class CAnnouncementDispatcher;
+
   class CAnnouncementManager
   {
   public:
@@ -36,8 +44,41 @@ namespace ANNOUNCEMENT
     static void Announce(AnnouncementFlag flag, const char *sender, const char *message, CVariant &data);
     static void Announce(AnnouncementFlag flag, const char *sender, const char *message, CFileItemPtr item);
     static void Announce(AnnouncementFlag flag, const char *sender, const char *message, CFileItemPtr item, CVariant &data);
+
+    /*!
+     \brief Start delivering announcements on a dispatch thread.
+     Until this is called (and after Stop) announcers are called directly
+     on the announcing thread.
+     */
+    static void Start();
+    /*!
+     \brief Deliver all queued announcements and stop the dispatch thread.
+     */
+    static void Stop();
   private:
+    friend class CAnnouncementDispatcher;
+
+    struct CQueuedAnnouncement
+    {
+      AnnouncementFlag flag;
+      std::string sender;
+      std::string message;
+      CVariant data;
+    };
+
+    static bool Queue(AnnouncementFlag flag, const char *sender, const char *message, const CVariant &data);
+    static void DispatchQueue();
+    static void Deliver(const std::deque<CQueuedAnnouncement> &announcements);
+
     static std::vector<IAnnouncer *> m_announcers;
     static CCriticalSection m_critSection;
+    static unsigned int m_deliveries;                 ///< threads calling announcers right now
+    static XbmcThreads::ConditionVariable m_delivered;
+    static XbmcThreads::ThreadLocal<const std::deque<CQueuedAnnouncement> > m_delivering; ///< batch the current thread is delivering
+
+    static std::deque<CQueuedAnnouncement> m_queue;
+    static CCriticalSection m_queueSection;
+    static CEvent m_queueEvent;
+    static CAnnouncementDispatcher *m_dispatcher;
   };
 }
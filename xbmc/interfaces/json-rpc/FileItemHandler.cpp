@@ -191,7 +191,6 @@ void CFileItemHandler::HandleFileItemList(const char *ID, bool allowFile, const
 
   for (int i = start; i < end; i++)
   {
-    CVariant object;
     CFileItemPtr item = items.Get(i);
     HandleFileItem(ID, allowFile, resultname, item, parameterObject, parameterObject["properties"], result);
   }
@@ -287,10 +286,15 @@ void CFileItemHandler::HandleFileItem(const char *ID, bool allowFile, const char
 
   if (resultname)
   {
+    // move the item into the result instead of deep copying all its details
     if (append)
-      result[resultname].append(object);
+    {
+      CVariant &list = result[resultname];
+      list.append(CVariant());
+      list[list.size() - 1].swap(object);
+    }
     else
-      result[resultname] = object;
+      result[resultname].swap(object);
   }
 }
 
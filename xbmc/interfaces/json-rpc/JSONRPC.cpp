@@ -152,6 +152,16 @@ JSONRPC_STATUS CJSONRPC::NotifyAll(const CStdString &method, ITransportLayer *tr
 }
 
 CStdString CJSONRPC::MethodCall(const CStdString &inputString, ITransportLayer *transport, IClient *client)
+{
+  std::string output;
+  CJSONStringOutputStream stream(output);
+  if (!MethodCall(inputString, transport, client, stream))
+    return "";
+
+  return output;
+}
+
+bool CJSONRPC::MethodCall(const CStdString &inputString, ITransportLayer *transport, IClient *client, IJSONOutputStream &output)
 {
   CVariant inputroot, outputroot, result;
   bool hasResponse = false;
@@ -165,7 +175,7 @@ CStdString CJSONRPC::MethodCall(const CStdString &inputString, ITransportLayer *
       if (inputroot.size() <= 0)
       {
         CLog::Log(LOGERROR, "JSONRPC: Empty batch call\n");
-        BuildResponse(inputroot, InvalidRequest, CVariant(), outputroot);
+        BuildResponse(inputroot, InvalidRequest, result, outputroot);
         hasResponse = true;
       }
       else
@@ -175,7 +185,9 @@ CStdString CJSONRPC::MethodCall(const CStdString &inputString, ITransportLayer *
           CVariant response;
           if (HandleMethodCall(*itr, response, transport, client))
           {
-            outputroot.append(response);
+            // move the response into the batch instead of deep copying it
+            outputroot.append(CVariant());
+            outputroot[outputroot.size() - 1].swap(response);
             hasResponse = true;
           }
         }
@@ -187,12 +199,20 @@ CStdString CJSONRPC::MethodCall(const CStdString &inputString, ITransportLayer *
   else
   {
     CLog::Log(LOGERROR, "JSONRPC: Failed to parse '%s'\n", inputString.c_str());
-    BuildResponse(inputroot, ParseError, CVariant(), outputroot);
+    BuildResponse(inputroot, ParseError, result, outputroot);
     hasResponse = true;
   }
 
-  CStdString str = hasResponse ? CJSONVariantWriter::Write(outputroot, g_advancedSettings.m_jsonOutputCompact) : "";
-  return str;
+  if (!hasResponse)
+    return false;
+
+  if (!CJSONVariantWriter::Write(outputroot, output, g_advancedSettings.m_jsonOutputCompact))
+  {
+    CLog::Log(LOGERROR, "JSONRPC: Failed to serialize the response to '%s'\n", inputString.c_str());
+    return false;
+  }
+
+  return true;
 }
 
 bool CJSONRPC::HandleMethodCall(const CVariant& request, CVariant& response, ITransportLayer *transport, IClient *client)
@@ -233,7 +253,7 @@ inline bool CJSONRPC::IsProperJSONRPC(const CVariant& inputroot)
   return inputroot.isObject() && inputroot.isMember("jsonrpc") && inputroot["jsonrpc"].isString() && inputroot["jsonrpc"] == CVariant("2.0") && inputroot.isMember("method") && inputroot["method"].isString() && (!inputroot.isMember("params") || inputroot["params"].isArray() || inputroot["params"].isObject());
 }
 
-inline void CJSONRPC::BuildResponse(const CVariant& request, JSONRPC_STATUS code, const CVariant& result, CVariant& response)
+inline void CJSONRPC::BuildResponse(const CVariant& request, JSONRPC_STATUS code, CVariant& result, CVariant& response)
 {
   response["jsonrpc"] = "2.0";
   response["id"] = request.isObject() && request.isMember("id") ? request["id"] : CVariant();
@@ -241,7 +261,8 @@ inline void CJSONRPC::BuildResponse(const CVariant& request, JSONRPC_STATUS code
   switch (code)
   {
     case OK:
-      response["result"] = result;
+      // the result can be the whole library, so hand it over instead of copying it
+      response["result"].swap(result);
       break;
     case ACK:
       response["result"] = "OK";
@@ -254,7 +275,7 @@ inline void CJSONRPC::BuildResponse(const CVariant& request, JSONRPC_STATUS code
       response["error"]["code"] = InvalidParams;
       response["error"]["message"] = "Invalid params.";
       if (!result.isNull())
-        response["error"]["data"] = result;
+        response["error"]["data"].swap(result);
       break;
     case MethodNotFound:
       response["error"]["code"] = MethodNotFound;
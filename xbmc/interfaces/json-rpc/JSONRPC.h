@@ -28,6 +28,7 @@
 #include "JSONRPCUtils.h"
 #include "JSONServiceDescription.h"
 #include "interfaces/IAnnouncer.h"
+#include "utils/JSONVariantWriter.h"
 #include "utils/StdString.h"
 
 namespace JSONRPC
@@ -63,6 +64,21 @@ namespace JSONRPC
      */
     static CStdString MethodCall(const CStdString &inputString, ITransportLayer *transport, IClient *client);
 
+    /*
+     \brief Handles an incoming JSON-RPC request
+     \param inputString received JSON-RPC request
+     \param transport Transport protocol on which the request arrived
+     \param client Client which sent the request
+     \param output Stream the JSON-RPC response is serialized into
+     \return True if a response was written, false for notifications and if
+     the response could not be serialized (the stream may hold part of it then)
+
+     Same as above but the response is written into the given stream while
+     it is being serialized, so transports can send large results in pieces
+     instead of building the whole response string first.
+     */
+    static bool MethodCall(const CStdString &inputString, ITransportLayer *transport, IClient *client, IJSONOutputStream &output);
+
     static JSONRPC_STATUS Introspect(const CStdString &method, ITransportLayer *transport, IClient *client, const CVariant& parameterObject, CVariant &result);
     static JSONRPC_STATUS Version(const CStdString &method, ITransportLayer *transport, IClient *client, const CVariant& parameterObject, CVariant &result);
     static JSONRPC_STATUS Permission(const CStdString &method, ITransportLayer *transport, IClient *client, const CVariant& parameterObject, CVariant &result);
@@ -76,7 +92,7 @@ namespace JSONRPC
     static bool HandleMethodCall(const CVariant& request, CVariant& response, ITransportLayer *transport, IClient *client);
     static inline bool IsProperJSONRPC(const CVariant& inputroot);
 
-    inline static void BuildResponse(const CVariant& request, JSONRPC_STATUS code, const CVariant& result, CVariant& response);
+    inline static void BuildResponse(const CVariant& request, JSONRPC_STATUS code, CVariant& result, CVariant& response);
 
     static bool m_initialized;
   };
@@ -34,6 +34,7 @@
 #include "guilib/LocalizeStrings.h"
 #include "utils/log.h"
 #include "threads/SingleLock.h"
+#include "threads/SystemClock.h"
 #include "utils/URIUtils.h"
 #include "addons/AddonManager.h"
 #include "addons/Addon.h"
@@ -70,6 +71,10 @@ XBPyThread::XBPyThread(XBPython *pExecuter, int id) : CThread("XBPyThread")
   m_argv        = NULL;
   m_source      = NULL;
   m_argc        = 0;
+  m_persistent  = false;
+  m_parked      = false;
+  m_reusable    = true;
+  m_startTime   = XbmcThreads::SystemClockMillis();
 }
 
 XBPyThread::~XBPyThread()
@@ -80,12 +85,19 @@ XBPyThread::~XBPyThread()
   StopThread();
   CLog::Log(LOGDEBUG,"python thread %d destructed", m_id);
   delete [] m_source;
+  freeArgv();
+}
+
+void XBPyThread::freeArgv()
+{
   if (m_argv)
   {
     for (unsigned int i = 0; i < m_argc; i++)
       delete [] m_argv[i];
     delete [] m_argv;
   }
+  m_argv = NULL;
+  m_argc = 0;
 }
 
 void XBPyThread::setSource(const CStdString &src)
@@ -119,6 +131,7 @@ int XBPyThread::evalString(const CStdString &src)
 
 int XBPyThread::setArgv(const std::vector<CStdString> &argv)
 {
+  freeArgv();
   m_argc = argv.size();
   m_argv = new char*[m_argc];
   for(unsigned int i = 0; i < m_argc; i++)
@@ -129,12 +142,35 @@ int XBPyThread::setArgv(const std::vector<CStdString> &argv)
   return 0;
 }
 
+bool XBPyThread::isParked()
+{
+  CSingleLock lock(m_pExecuter->m_critSection);
+  return m_parked;
+}
+
+void XBPyThread::reuse(int id, const std::vector<CStdString> &argv)
+{
+  CSingleLock lock(m_pExecuter->m_critSection);
+  CLog::Log(LOGDEBUG,"python thread %d reused as %d", m_id, id);
+  m_id        = id;
+  m_parked    = false;
+  m_startTime = XbmcThreads::SystemClockMillis();
+  setArgv(argv);
+  // the previous run has set it, and stop() must wait for this one
+  stoppedEvent.Reset();
+  m_jobEvent.Set();
+}
+
+unsigned int XBPyThread::getStartTime()
+{
+  CSingleLock lock(m_pExecuter->m_critSection);
+  return m_startTime;
+}
+
 void XBPyThread::Process()
 {
   CLog::Log(LOGDEBUG,"Python thread: start processing");
 
-  int m_Py_file_input = Py_file_input;
-
   // get the global lock
   PyEval_AcquireLock();
   PyThreadState* state = Py_NewInterpreter();
@@ -212,6 +248,30 @@ void XBPyThread::Process()
   PyObject* module = PyImport_AddModule((char*)"__main__");
   PyObject* moduleDict = PyModule_GetDict(module);
 
+  do
+  {
+    runScript(state, moduleDict);
+  } while (waitForNextJob(state, moduleDict));
+
+  PyEval_AcquireLock();
+  PyThreadState_Swap(state);
+
+  m_pExecuter->DeInitializeInterpreter();
+
+  Py_EndInterpreter(state);
+  PyThreadState_Swap(NULL);
+
+  PyEval_ReleaseLock();
+}
+
+// expects the GIL to be held with our thread state swapped in and returns
+// with it released
+void XBPyThread::runScript(void *threadState, void *dict)
+{
+  PyThreadState* state = (PyThreadState*)threadState;
+  PyObject* moduleDict = (PyObject*)dict;
+  int m_Py_file_input = Py_file_input;
+
   // when we are done initing we store thread state so we can be aborted
   PyThreadState_Swap(NULL);
   PyEval_ReleaseLock();
@@ -271,6 +331,9 @@ void XBPyThread::Process()
     CLog::Log(LOGINFO, "Scriptresult: Aborted");
   else
   {
+    // whatever the script left behind is not worth running it again in
+    m_reusable = false;
+
     PyObject* exc_type;
     PyObject* exc_value;
     PyObject* exc_traceback;
@@ -385,16 +448,57 @@ void XBPyThread::Process()
   { CSingleLock lock(m_pExecuter->m_critSection);
     m_threadState = NULL;
   }
+}
+
+// parks a persistent interpreter until XBPython hands it the next run of
+// the script. Returns true with the GIL held and the interpreter reset.
+bool XBPyThread::waitForNextJob(void *threadState, void *dict)
+{
+  if (!m_persistent || !m_reusable)
+    return false;
+
+  { CSingleLock lock(m_pExecuter->m_critSection);
+    if (m_stopping)
+      return false;
+    m_parked = true;
+  }
+
+  // hands us over to the idle interpreters
+  m_pExecuter->setDone(m_id);
+
+  m_jobEvent.Wait();
+
+  { CSingleLock lock(m_pExecuter->m_critSection);
+    if (m_stopping)
+      return false;
+  }
+
+  PyThreadState* state = (PyThreadState*)threadState;
+  PyObject* moduleDict = (PyObject*)dict;
 
   PyEval_AcquireLock();
   PyThreadState_Swap(state);
 
-  m_pExecuter->DeInitializeInterpreter();
+  // imported modules stay cached, but the script itself starts from a clean
+  // __main__ just like in a new interpreter
+  PyDict_Clear(moduleDict);
+  PyDict_SetItemString(moduleDict, "__builtins__", PyEval_GetBuiltins());
+  PyObject *name = PyString_FromString("__main__");
+  PyDict_SetItemString(moduleDict, "__name__", name);
+  Py_DECREF(name);
 
-  Py_EndInterpreter(state);
-  PyThreadState_Swap(NULL);
+  PyObject *m = PyImport_AddModule((char*)"xbmc");
+  if(!m || PyObject_SetAttrString(m, (char*)"abortRequested", PyBool_FromLong(0)))
+    CLog::Log(LOGERROR, "Scriptresult: failed to reset abortRequested");
 
-  PyEval_ReleaseLock();
+  // PySys_SetArgv would prepend to sys.path again on every run
+  PyObject *argv = PyList_New(m_argc);
+  for (unsigned int i = 0; i < m_argc; i++)
+    PyList_SetItem(argv, i, PyString_FromString(m_argv[i]));
+  PySys_SetObject((char*)"argv", argv);
+  Py_DECREF(argv);
+
+  return true;
 }
 
 void XBPyThread::OnExit()
@@ -424,6 +528,8 @@ void XBPyThread::stop()
     return;
 
   m_stopping = true;
+  // a parked interpreter only has to be woken up to shut down
+  m_jobEvent.Set();
 
   if (m_threadState)
   {
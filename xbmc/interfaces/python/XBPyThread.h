@@ -40,6 +40,21 @@ public:
   void stop();
 
   void setAddon(ADDON::AddonPtr _addon) { addon = _addon; }
+  ADDON::AddonPtr getAddon() const { return addon; }
+
+  /*!
+   \brief Keep the interpreter alive once the script is done, so the same
+   script can be run in it again without paying for a new interpreter and
+   the module imports. The thread parks itself and XBPython takes it over.
+   */
+  void setPersistent(bool persistent) { m_persistent = persistent; }
+  bool isPersistent() const { return m_persistent; }
+  bool isParked();
+  /*!
+   \brief Run the script again in a parked interpreter
+   */
+  void reuse(int id, const std::vector<CStdString> &argv);
+  unsigned int getStartTime();
 
 protected:
   XBPython *m_pExecuter;
@@ -54,7 +69,16 @@ protected:
   int  m_id;
   ADDON::AddonPtr addon;
 
+  bool m_persistent;
+  bool m_parked;
+  bool m_reusable;
+  unsigned int m_startTime;
+  CEvent m_jobEvent;
+
   void setSource(const CStdString &src);
+  void freeArgv();
+  void runScript(void *threadState, void *moduleDict);
+  bool waitForNextJob(void *threadState, void *moduleDict);
 
   virtual void Process();
   virtual void OnExit();
@@ -41,11 +41,15 @@
 
 #include "threads/SystemClock.h"
 #include "addons/Addon.h"
+#include "settings/AdvancedSettings.h"
 #include "interfaces/AnnouncementManager.h"
 #include "interfaces/python/xbmcmodule/PythonMonitor.h"
 
 using namespace ANNOUNCEMENT;
 
+// how long a pooled interpreter waits for its plugin to be run again
+#define PYTHON_POOL_IDLE_TIME 300000
+
 extern "C" HMODULE __stdcall dllLoadLibraryA(LPCSTR file);
 extern "C" BOOL __stdcall dllFreeLibrary(HINSTANCE hLibModule);
 
@@ -621,6 +625,16 @@ void XBPython::FreeResources()
       it = m_vecPyList.erase(it);
       FinalizeScript();
     }
+
+    PyIdleList::iterator idle = m_vecPyIdleList.begin();
+    while (idle != m_vecPyIdleList.end())
+    {
+      lock.Leave();
+      delete idle->pyThread;
+      lock.Enter();
+      idle = m_vecPyIdleList.erase(idle);
+      FinalizeScript();
+    }
   }
 }
 
@@ -643,6 +657,7 @@ void XBPython::Process()
 
   if (m_bInitialized)
   {
+    std::vector<int> overdue;
     PyList::iterator it = m_vecPyList.begin();
     while (it != m_vecPyList.end())
     {
@@ -653,7 +668,47 @@ void XBPython::Process()
         it = m_vecPyList.erase(it);
         FinalizeScript();
       }
-      else ++it;
+      else
+      {
+        // pooled plugins are stopped by the watchdog rather than being left
+        // to hang on to their interpreter
+        if (it->pyThread->isPersistent() && g_advancedSettings.m_pythonPoolWatchdog > 0 && !it->pyThread->isStopping() &&
+            XbmcThreads::SystemClockMillis() - it->pyThread->getStartTime() > (unsigned int)g_advancedSettings.m_pythonPoolWatchdog * 1000)
+          overdue.push_back(it->id);
+        ++it;
+      }
+    }
+
+    // interpreters nobody asked for in a while and those beyond the pool
+    // size are shut down, oldest first
+    std::vector<XBPyThread*> expired;
+    PyIdleList::iterator idle = m_vecPyIdleList.begin();
+    while (idle != m_vecPyIdleList.end())
+    {
+      if ((int)m_vecPyIdleList.size() > g_advancedSettings.m_pythonPoolSize ||
+          XbmcThreads::SystemClockMillis() - idle->idleSince > PYTHON_POOL_IDLE_TIME)
+      {
+        expired.push_back(idle->pyThread);
+        idle = m_vecPyIdleList.erase(idle);
+      }
+      else ++idle;
+    }
+
+    if (!overdue.empty() || !expired.empty())
+    {
+      //unlock here because the python thread might lock when it exits
+      lock.Leave();
+      for (unsigned int i = 0; i < overdue.size(); i++)
+      {
+        CLog::Log(LOGWARNING, "Python: pooled script %d did not finish in %d seconds, stopping it", overdue[i], g_advancedSettings.m_pythonPoolWatchdog);
+        stopScript(overdue[i]);
+      }
+      for (unsigned int i = 0; i < expired.size(); i++)
+      {
+        delete expired[i];
+        FinalizeScript();
+      }
+      lock.Enter();
     }
 
     if(m_iDllScriptCounter == 0 && (XbmcThreads::SystemClockMillis() - m_endtime) > 10000 )
@@ -661,6 +716,23 @@ void XBPython::Process()
   }
 }
 
+XBPyThread* XBPython::GetIdleInterpreter(const CStdString &src, ADDON::AddonPtr addon)
+{
+  CSingleLock lock(m_critSection);
+  for (PyIdleList::iterator it = m_vecPyIdleList.begin(); it != m_vecPyIdleList.end(); ++it)
+  {
+    ADDON::AddonPtr idleAddon = it->pyThread->getAddon();
+    // an updated addon gets a fresh interpreter so no stale modules are used
+    if (it->strFile == src && idleAddon && idleAddon->ID() == addon->ID() && idleAddon->Version() == addon->Version())
+    {
+      XBPyThread *pyThread = it->pyThread;
+      m_vecPyIdleList.erase(it);
+      return pyThread;
+    }
+  }
+  return NULL;
+}
+
 bool XBPython::StopScript(const CStdString &path)
 {
   int id = getScriptId(path);
@@ -699,15 +771,32 @@ int XBPython::evalFile(const CStdString &src, const std::vector<CStdString> &arg
     return -1;
 
   CSingleLock lock(m_critSection);
-  Initialize();
 
-  if (!m_bInitialized) return -1;
+  // plugins are run over and over again while browsing them, so they can be
+  // kept in a pool of persistent interpreters
+  bool pooled = g_advancedSettings.m_pythonPoolSize > 0 && addon && addon->Type() == ADDON::ADDON_PLUGIN;
+
+  XBPyThread *pyThread = pooled ? GetIdleInterpreter(src, addon) : NULL;
+  if (pyThread)
+  {
+    // the idle interpreter still holds its share of the python library
+    m_nextid++;
+    pyThread->reuse(m_nextid, argv);
+  }
+  else
+  {
+    Initialize();
+
+    if (!m_bInitialized) return -1;
+
+    m_nextid++;
+    pyThread = new XBPyThread(this, m_nextid);
+    pyThread->setArgv(argv);
+    pyThread->setAddon(addon);
+    pyThread->setPersistent(pooled);
+    pyThread->evalFile(src);
+  }
 
-  m_nextid++;
-  XBPyThread *pyThread = new XBPyThread(this, m_nextid);
-  pyThread->setArgv(argv);
-  pyThread->setAddon(addon);
-  pyThread->evalFile(src);
   PyElem inf;
   inf.id        = m_nextid;
   inf.bDone     = false;
@@ -731,6 +820,18 @@ void XBPython::setDone(int id)
         CLog::Log(LOGINFO, "Python script interrupted by user");
       else
         CLog::Log(LOGINFO, "Python script stopped");
+
+      if (it->pyThread->isParked())
+      {
+        PyIdleElem idle;
+        idle.strFile   = it->strFile;
+        idle.idleSince = XbmcThreads::SystemClockMillis();
+        idle.pyThread  = it->pyThread;
+        m_vecPyIdleList.push_back(idle);
+
+        it = m_vecPyList.erase(it);
+        continue;
+      }
       it->bDone = true;
     }
     ++it;
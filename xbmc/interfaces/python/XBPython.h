@@ -39,7 +39,15 @@ typedef struct {
 class LibraryLoader;
 class CPythonMonitor;
 
+// a persistent interpreter waiting for the next run of its script
+typedef struct {
+  std::string strFile;
+  unsigned int idleSince;
+  XBPyThread *pyThread;
+}PyIdleElem;
+
 typedef std::vector<PyElem> PyList;
+typedef std::vector<PyIdleElem> PyIdleList;
 typedef std::vector<PVOID> PlayerCallbackList;
 typedef std::vector<PVOID> MonitorCallbackList;
 typedef std::vector<LibraryLoader*> PythonExtensionLibraries;
@@ -121,6 +129,7 @@ public:
   CCriticalSection    m_critSection;
 private:
   bool              FileExist(const char* strFile);
+  XBPyThread*       GetIdleInterpreter(const CStdString &src, ADDON::AddonPtr addon);
 
   int               m_nextid;
   void*             m_mainThreadState;
@@ -132,6 +141,7 @@ private:
 
   //Vector with list of threads used for running scripts
   PyList              m_vecPyList;
+  PyIdleList          m_vecPyIdleList;
   PlayerCallbackList  m_vecPlayerCallbackList;
   MonitorCallbackList m_vecMonitorCallbackList;
   LibraryLoader*      m_pDll;
@@ -1015,11 +1015,10 @@ namespace PYXBMC
     if (!PyXBMCGetUnicodeString(uText, value, 1))
       return NULL;
 
+    // window properties have their own lock, no need for the graphics context
     CStdString lowerKey = key;
     {
       CPyThreadState gil;
-      CSingleLock lock(g_graphicsContext);
-      
       self->pWindow->SetProperty(lowerKey.ToLower(), uText);
     }
 
@@ -1055,7 +1054,6 @@ namespace PYXBMC
       return NULL;    }
     if (!key) return NULL;
 
-    GilSafeSingleLock lock(g_graphicsContext);
     CStdString lowerKey = key;
     string value = self->pWindow->GetProperty(lowerKey.ToLower()).asString();
 
@@ -1090,7 +1088,6 @@ namespace PYXBMC
       return NULL;
     }
     if (!key) return NULL;
-    GilSafeSingleLock lock(g_graphicsContext);
 
     CStdString lowerKey = key;
     self->pWindow->SetProperty(lowerKey.ToLower(), "");
@@ -1108,7 +1105,6 @@ namespace PYXBMC
 
   PyObject* Window_ClearProperties(Window *self, PyObject *args)
   {
-    GilSafeSingleLock lock(g_graphicsContext);
     self->pWindow->ClearProperties();
 
     Py_INCREF(Py_None);
@@ -76,6 +76,7 @@ using namespace CDDB;
 #endif
 
 CMusicDatabase::CMusicDatabase(void)
+  : m_artistCache("artist"), m_genreCache("genre"), m_pathCache("path"), m_thumbCache("thumb")
 {
 }
 
@@ -252,20 +253,20 @@ void CMusicDatabase::CreateViews()
               "    album.idAlbum=albuminfo.idAlbum");
 }
 
-void CMusicDatabase::AddSong(CSong& song, bool bCheck)
+bool CMusicDatabase::AddSong(CSong& song, bool bCheck)
 {
   CStdString strSQL;
   try
   {
     // We need at least the title
     if (song.strTitle.IsEmpty())
-      return;
+      return false;
 
     CStdString strPath, strFileName;
     URIUtils::Split(song.strFileName, strPath, strFileName);
 
-    if (NULL == m_pDB.get()) return ;
-    if (NULL == m_pDS.get()) return ;
+    if (NULL == m_pDB.get()) return false;
+    if (NULL == m_pDS.get()) return false;
 
     // split our (possibly) multiple artist string into individual artists
     std::vector<std::string> extraArtists;
@@ -325,7 +326,7 @@ void CMusicDatabase::AddSong(CSong& song, bool bCheck)
                     idAlbum, crc, song.strTitle.c_str());
 
       if (!m_pDS->query(strSQL.c_str()))
-        return;
+        return false;
 
       if (m_pDS->num_rows() != 0)
       {
@@ -389,11 +390,116 @@ void CMusicDatabase::AddSong(CSong& song, bool bCheck)
       AddKaraokeData( song );
 
     AnnounceUpdate("song", idSong);
+    return true;
   }
   catch (...)
   {
     CLog::Log(LOGERROR, "musicdatabase:unable to addsong (%s)", strSQL.c_str());
   }
+  return false;
+}
+
+bool CMusicDatabase::AddSongs(VECSONGS& songs, bool bCheck, const volatile bool *stop /* = NULL */)
+{
+  if (NULL == m_pDB.get()) return false;
+  if (NULL == m_pDS.get()) return false;
+
+  // gather everything the batch will look up, normalized the same way
+  // as AddArtist, AddGenre and AddPath do
+  set<CStdString> artists, genres, paths;
+  for (VECSONGS::const_iterator song = songs.begin(); song != songs.end(); ++song)
+  {
+    vector<string> names(song->artist);
+    names.insert(names.end(), song->albumArtist.begin(), song->albumArtist.end());
+    for (vector<string>::const_iterator i = names.begin(); i != names.end(); ++i)
+    {
+      CStdString name(*i);
+      name.TrimLeft(" ");
+      name.TrimRight(" ");
+      if (!name.IsEmpty() && !m_artistCache.Contains(name))
+        artists.insert(name);
+    }
+    for (vector<string>::const_iterator i = song->genre.begin(); i != song->genre.end(); ++i)
+    {
+      CStdString name(*i);
+      name.TrimLeft(" ");
+      name.TrimRight(" ");
+      if (!name.IsEmpty() && !m_genreCache.Contains(name))
+        genres.insert(name);
+    }
+    CStdString strPath, strFileName;
+    URIUtils::Split(song->strFileName, strPath, strFileName);
+    URIUtils::AddSlashAtEnd(strPath);
+    if (!m_pathCache.Contains(strPath))
+      paths.insert(strPath);
+  }
+
+  bool bTransaction = !InTransaction();
+  if (bTransaction)
+    BeginTransaction();
+
+  PreloadCache("artist", "idArtist", "strArtist", artists, m_artistCache);
+  PreloadCache("genre", "idGenre", "strGenre", genres, m_genreCache);
+  PreloadCache("path", "idPath", "strPath", paths, m_pathCache);
+
+  unsigned int failed = 0;
+  for (VECSONGS::iterator song = songs.begin(); song != songs.end(); ++song)
+  {
+    if (stop && *stop)
+    {
+      if (bTransaction)
+      {
+        RollbackTransaction();
+        // the caches hold ids of rows that are gone now
+        EmptyCache();
+      }
+      return false;
+    }
+    if (!AddSong(*song, bCheck))
+      failed++;
+  }
+  if (failed)
+    CLog::Log(LOGWARNING, "%s - %u of %u songs could not be added", __FUNCTION__, failed, (unsigned int)songs.size());
+
+  if (bTransaction && !CommitTransaction())
+  {
+    EmptyCache();
+    return false;
+  }
+  return true;
+}
+
+void CMusicDatabase::PreloadCache(const CStdString &table, const CStdString &idField, const CStdString &nameField,
+                                  const set<CStdString> &names, CDatabaseIdCache &cache)
+{
+  // names not found here are resolved (and inserted) one by one later on
+  const unsigned int batchSize = 100;
+  set<CStdString>::const_iterator it = names.begin();
+  while (it != names.end())
+  {
+    CStdString strIn;
+    for (unsigned int i = 0; i < batchSize && it != names.end(); i++, ++it)
+      strIn += PrepareSQL("'%s',", it->c_str());
+    strIn.TrimRight(',');
+
+    CStdString strSQL = PrepareSQL("select %s, %s from %s where %s in (", idField.c_str(), nameField.c_str(), table.c_str(), nameField.c_str()) + strIn + ")";
+    try
+    {
+      if (!m_pDS->query(strSQL.c_str()))
+        return;
+      while (!m_pDS->eof())
+      {
+        cache.Set(m_pDS->fv(1).get_asString(), m_pDS->fv(0).get_asInt());
+        m_pDS->next();
+      }
+      m_pDS->close();
+    }
+    catch (...)
+    {
+      CLog::Log(LOGERROR, "%s - failed on query %s", __FUNCTION__, strSQL.c_str());
+      return;
+    }
+  }
 }
 
 int CMusicDatabase::UpdateSong(const CSong& song, int idSong /* = -1 */)
@@ -512,11 +618,9 @@ int CMusicDatabase::AddGenre(const CStdString& strGenre1)
 
     if (NULL == m_pDB.get()) return -1;
     if (NULL == m_pDS.get()) return -1;
-    map <CStdString, int>::const_iterator it;
-
-    it = m_genreCache.find(strGenre);
-    if (it != m_genreCache.end())
-      return it->second;
+    int idGenre;
+    if (m_genreCache.Get(strGenre, idGenre))
+      return idGenre;
 
 
     strSQL=PrepareSQL("select * from genre where strGenre like '%s'", strGenre.c_str());
@@ -528,14 +632,14 @@ int CMusicDatabase::AddGenre(const CStdString& strGenre1)
       strSQL=PrepareSQL("insert into genre (idGenre, strGenre) values( NULL, '%s' )", strGenre.c_str());
       m_pDS->exec(strSQL.c_str());
 
-      int idGenre = (int)m_pDS->lastinsertid();
-      m_genreCache.insert(pair<CStdString, int>(strGenre1, idGenre));
+      idGenre = (int)m_pDS->lastinsertid();
+      m_genreCache.Set(strGenre, idGenre);
       return idGenre;
     }
     else
     {
-      int idGenre = m_pDS->fv("idGenre").get_asInt();
-      m_genreCache.insert(pair<CStdString, int>(strGenre1, idGenre));
+      idGenre = m_pDS->fv("idGenre").get_asInt();
+      m_genreCache.Set(strGenre, idGenre);
       m_pDS->close();
       return idGenre;
     }
@@ -563,11 +667,9 @@ int CMusicDatabase::AddArtist(const CStdString& strArtist1)
     if (NULL == m_pDB.get()) return -1;
     if (NULL == m_pDS.get()) return -1;
 
-    map <CStdString, int>::const_iterator it;
-
-    it = m_artistCache.find(strArtist);
-    if (it != m_artistCache.end())
-      return it->second;//.idArtist;
+    int idArtist;
+    if (m_artistCache.Get(strArtist, idArtist))
+      return idArtist;
 
     strSQL=PrepareSQL("select * from artist where strArtist like '%s'", strArtist.c_str());
     m_pDS->query(strSQL.c_str());
@@ -578,14 +680,14 @@ int CMusicDatabase::AddArtist(const CStdString& strArtist1)
       // doesnt exists, add it
       strSQL=PrepareSQL("insert into artist (idArtist, strArtist) values( NULL, '%s' )", strArtist.c_str());
       m_pDS->exec(strSQL.c_str());
-      int idArtist = (int)m_pDS->lastinsertid();
-      m_artistCache.insert(pair<CStdString, int>(strArtist1, idArtist));
+      idArtist = (int)m_pDS->lastinsertid();
+      m_artistCache.Set(strArtist, idArtist);
       return idArtist;
     }
     else
     {
-      int idArtist = (int)m_pDS->fv("idArtist").get_asInt();
-      m_artistCache.insert(pair<CStdString, int>(strArtist1, idArtist));
+      idArtist = (int)m_pDS->fv("idArtist").get_asInt();
+      m_artistCache.Set(strArtist, idArtist);
       m_pDS->close();
       return idArtist;
     }
@@ -740,11 +842,9 @@ int CMusicDatabase::AddPath(const CStdString& strPath1)
     if (NULL == m_pDB.get()) return -1;
     if (NULL == m_pDS.get()) return -1;
 
-    map <CStdString, int>::const_iterator it;
-
-    it = m_pathCache.find(strPath);
-    if (it != m_pathCache.end())
-      return it->second;
+    int idPath;
+    if (m_pathCache.Get(strPath, idPath))
+      return idPath;
 
     strSQL=PrepareSQL( "select * from path where strPath='%s'", strPath.c_str());
     m_pDS->query(strSQL.c_str());
@@ -755,14 +855,14 @@ int CMusicDatabase::AddPath(const CStdString& strPath1)
       strSQL=PrepareSQL("insert into path (idPath, strPath) values( NULL, '%s' )", strPath.c_str());
       m_pDS->exec(strSQL.c_str());
 
-      int idPath = (int)m_pDS->lastinsertid();
-      m_pathCache.insert(pair<CStdString, int>(strPath, idPath));
+      idPath = (int)m_pDS->lastinsertid();
+      m_pathCache.Set(strPath, idPath);
       return idPath;
     }
     else
     {
-      int idPath = m_pDS->fv("idPath").get_asInt();
-      m_pathCache.insert(pair<CStdString, int>(strPath, idPath));
+      idPath = m_pDS->fv("idPath").get_asInt();
+      m_pathCache.Set(strPath, idPath);
       m_pDS->close();
       return idPath;
     }
@@ -1730,11 +1830,11 @@ bool CMusicDatabase::GetSongsByPath(const CStdString& strPath1, CSongMap& songs,
 
 void CMusicDatabase::EmptyCache()
 {
-  m_artistCache.erase(m_artistCache.begin(), m_artistCache.end());
-  m_genreCache.erase(m_genreCache.begin(), m_genreCache.end());
-  m_pathCache.erase(m_pathCache.begin(), m_pathCache.end());
+  m_artistCache.Clear();
+  m_genreCache.Clear();
+  m_pathCache.Clear();
   m_albumCache.erase(m_albumCache.begin(), m_albumCache.end());
-  m_thumbCache.erase(m_thumbCache.begin(), m_thumbCache.end());
+  m_thumbCache.Clear();
 }
 
 bool CMusicDatabase::Search(const CStdString& search, CFileItemList &items)
@@ -2282,6 +2382,9 @@ int CMusicDatabase::Cleanup(CGUIDialogProgress *pDlgProgress)
   unsigned int time = XbmcThreads::SystemClockMillis();
   CLog::Log(LOGNOTICE, "%s: Starting musicdatabase cleanup ..", __FUNCTION__);
 
+  // cached ids may refer to rows removed below
+  EmptyCache();
+
   // first cleanup any songs with invalid paths
   if (pDlgProgress)
   {
@@ -3556,11 +3659,9 @@ int CMusicDatabase::AddThumb(const CStdString& strThumb1)
     if (NULL == m_pDB.get()) return -1;
     if (NULL == m_pDS.get()) return -1;
 
-    map <CStdString, int>::const_iterator it;
-
-    it = m_thumbCache.find(strThumb1);
-    if (it != m_thumbCache.end())
-      return it->second;
+    int idPath;
+    if (m_thumbCache.Get(strThumb1, idPath))
+      return idPath;
 
     strSQL=PrepareSQL( "select * from thumb where strThumb='%s'", strThumb.c_str());
     m_pDS->query(strSQL.c_str());
@@ -3571,14 +3672,14 @@ int CMusicDatabase::AddThumb(const CStdString& strThumb1)
       strSQL=PrepareSQL("insert into thumb (idThumb, strThumb) values( NULL, '%s' )", strThumb.c_str());
       m_pDS->exec(strSQL.c_str());
 
-      int idPath = (int)m_pDS->lastinsertid();
-      m_thumbCache.insert(pair<CStdString, int>(strThumb1, idPath));
+      idPath = (int)m_pDS->lastinsertid();
+      m_thumbCache.Set(strThumb1, idPath);
       return idPath;
     }
     else
     {
-      int idPath = m_pDS->fv("idThumb").get_asInt();
-      m_thumbCache.insert(pair<CStdString, int>(strThumb1, idPath));
+      idPath = m_pDS->fv("idThumb").get_asInt();
+      m_thumbCache.Set(strThumb1, idPath);
       m_pDS->close();
       return idPath;
     }
@@ -4167,6 +4268,7 @@ bool CMusicDatabase::RemoveSongsFromPath(const CStdString &path1, CSongMap &song
     // and remove the path as well (it'll be re-added later on with the new hash if it's non-empty)
     sql = "delete from path" + where;
     m_pDS->exec(sql.c_str());
+    m_pathCache.Clear();
     return iRowsFound > 0;
   }
   catch (...)
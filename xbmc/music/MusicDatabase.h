@@ -24,6 +24,7 @@
 */
 #pragma once
 #include "dbwrappers/Database.h"
+#include "dbwrappers/DatabaseIdCache.h"
 #include "Album.h"
 #include "addons/Scraper.h"
 #include "utils/SortUtils.h"
@@ -128,7 +129,22 @@ public:
   void DeleteAlbumInfo();
   bool LookupCDDBInfo(bool bRequery=false);
   void DeleteCDDBInfo();
-  void AddSong(CSong& song, bool bCheck = true);
+  /*! \brief Add a song, its album, artists and genres
+   \return true if the song was added, false otherwise
+   */
+  bool AddSong(CSong& song, bool bCheck = true);
+
+  /*! \brief Add a batch of songs in a single transaction
+   Artists, genres and paths used by the batch are looked up in one query per table up front,
+   so only songs and their links cost a round trip each.
+   \param songs the songs to add, their idSong is updated
+   \param bCheck whether to check for existing songs/links first, as in AddSong
+   \param stop checked before each song, the batch is rolled back once it is set
+   \return true if the batch was committed, false if it was stopped or failed. Single songs that
+   can't be added are skipped, as with AddSong.
+   \sa AddSong
+   */
+  bool AddSongs(VECSONGS& songs, bool bCheck = true, const volatile bool *stop = NULL);
   int UpdateSong(const CSong& song, int idSong = -1);
   int SetAlbumInfo(int idAlbum, const CAlbum& album, const VECSONGS& songs, bool bTransaction=true);
   bool DeleteAlbumInfo(int idArtist);
@@ -222,10 +238,10 @@ public:
   static void SetPropertiesFromArtist(CFileItem& item, const CArtist& artist);
   static void SetPropertiesFromAlbum(CFileItem& item, const CAlbum& album);
 protected:
-  std::map<CStdString, int /*CArtistCache*/> m_artistCache;
-  std::map<CStdString, int /*CGenreCache*/> m_genreCache;
-  std::map<CStdString, int /*CPathCache*/> m_pathCache;
-  std::map<CStdString, int /*CPathCache*/> m_thumbCache;
+  CDatabaseIdCache m_artistCache;
+  CDatabaseIdCache m_genreCache;
+  CDatabaseIdCache m_pathCache;
+  CDatabaseIdCache m_thumbCache;
   std::map<CStdString, CAlbumCache> m_albumCache;
 
   virtual bool CreateTables();
@@ -241,6 +257,8 @@ protected:
   void AddExtraSongArtists(const std::vector<std::string>& vecArtists, int idSong, bool bCheck = true);
   void AddKaraokeData(const CSong& song);
   void AddExtraGenres(const std::vector<std::string>& vecGenres, int idSong, int idAlbum, bool bCheck = true);
+  void PreloadCache(const CStdString &table, const CStdString &idField, const CStdString &nameField,
+                    const std::set<CStdString> &names, CDatabaseIdCache &cache);
   bool SetAlbumInfoSongs(int idAlbumInfo, const VECSONGS& songs);
   bool GetAlbumInfoSongs(int idAlbumInfo, VECSONGS& songs);
 private:
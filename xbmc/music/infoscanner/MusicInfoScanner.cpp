@@ -25,6 +25,7 @@
 #include "MusicAlbumInfo.h"
 #include "MusicInfoScraper.h"
 #include "filesystem/DirectoryCache.h"
+#include "filesystem/DirectoryWalker.h"
 #include "filesystem/MusicDatabaseDirectory.h"
 #include "filesystem/MusicDatabaseDirectory/DirectoryNode.h"
 #include "Util.h"
@@ -38,6 +39,7 @@
 #include "dialogs/GUIDialogSelect.h"
 #include "dialogs/GUIDialogKeyboard.h"
 #include "filesystem/File.h"
+#include "utils/LibraryWatcher.h"
 #include "settings/AdvancedSettings.h"
 #include "settings/GUISettings.h"
 #include "settings/Settings.h"
@@ -126,6 +128,8 @@ void CMusicInfoScanner::Process()
         commit = !cancelled;
       }
 
+      CLibraryWatcher::Get().EndScan(CLibraryWatcher::LibraryMusic, commit);
+
       if (commit)
       {
         g_infoManager.ResetLibraryBools();
@@ -203,6 +207,7 @@ void CMusicInfoScanner::Process()
   }
   catch (...)
   {
+    CLibraryWatcher::Get().EndScan(CLibraryWatcher::LibraryMusic, false);
     CLog::Log(LOGERROR, "MusicInfoScanner: Exception while scanning.");
   }
   ANNOUNCEMENT::CAnnouncementManager::Announce(ANNOUNCEMENT::AudioLibrary, "xbmc", "OnScanFinished");
@@ -229,6 +234,11 @@ void CMusicInfoScanner::Start(const CStdString& strDirectory)
   m_pathsToCount = m_pathsToScan;
   m_scanType = 0;
   StopThread();
+
+  // let the watcher skip local folders that didn't change since the last update
+  if (strDirectory.IsEmpty())
+    CLibraryWatcher::Get().BeginScan(CLibraryWatcher::LibraryMusic, m_pathsToScan);
+
   Create();
   m_bRunning = true;
 }
@@ -371,6 +381,16 @@ bool CMusicInfoScanner::DoScan(const CStdString& strDirectory)
   if (CUtil::ExcludeFileOrFolder(strDirectory, regexps))
     return true;
 
+  if (CLibraryWatcher::Get().IsUnchanged(CLibraryWatcher::LibraryMusic, strDirectory))
+  { // folder has been watched since the last update and didn't change. Its subfolders
+    // are either queued on their own or were reported as changed by the watcher.
+    CLog::Log(LOGDEBUG, "%s Skipping dir '%s' due to no change (watched)", __FUNCTION__, strDirectory.c_str());
+    if (m_pObserver)
+      m_pObserver->OnDirectoryScanned(strDirectory);
+    return true;
+  }
+  CLibraryWatcher::Get().WatchDirectory(CLibraryWatcher::LibraryMusic, strDirectory);
+
   // load subfolder
   CFileItemList items;
   CDirectory::GetDirectory(strDirectory, items, g_settings.m_musicExtensions + "|.jpg|.tbn|.lrc|.cdg");
@@ -399,19 +419,27 @@ bool CMusicInfoScanner::DoScan(const CStdString& strDirectory)
     items.Sort(SORT_METHOD_LABEL, SortOrderAscending);
 
     // and then scan in the new information
-    if (RetrieveMusicInfo(items, strDirectory) > 0)
+    int numAdded = RetrieveMusicInfo(items, strDirectory);
+    if (numAdded > 0)
     {
       if (m_pObserver)
         m_pObserver->OnDirectoryScanned(strDirectory);
     }
 
-    // save information about this folder
-    m_musicDatabase.SetPathHash(strDirectory, hash);
+    // save information about this folder, unless its songs were rolled back
+    // in which case the next scan has to process it again
+    if (numAdded >= 0)
+      m_musicDatabase.SetPathHash(strDirectory, hash);
+    else
+    {
+      m_musicDatabase.SetPathHash(strDirectory, "");
+      CLibraryWatcher::Get().InvalidateDirectory(CLibraryWatcher::LibraryMusic, strDirectory);
+    }
   }
   else
   { // path is the same - no need to rescan
     CLog::Log(LOGDEBUG, "%s Skipping dir '%s' due to no change", __FUNCTION__, strDirectory.c_str());
-    m_currentItem += CountFiles(items, false);  // false for non-recursive
+    m_currentItem += CountFiles(items);
 
     // notify our observer of our progress
     if (m_pObserver)
@@ -463,7 +491,7 @@ int CMusicInfoScanner::RetrieveMusicInfo(CFileItemList& items, const CStdString&
     URIUtils::GetExtension(pItem->GetPath(), strExtension);
 
     if (m_bStop)
-      return 0;
+      return -1;
 
     // Discard all excluded files defined by m_musicExcludeRegExps
     if (CUtil::ExcludeFileOrFolder(pItem->GetPath(), regexps))
@@ -537,21 +565,18 @@ int CMusicInfoScanner::RetrieveMusicInfo(CFileItemList& items, const CStdString&
   // finally, add these to the database
   set<CStdString> artistsToScan;
   set< pair<CStdString, CStdString> > albumsToScan;
-  m_musicDatabase.BeginTransaction();
+  if (!m_musicDatabase.AddSongs(songsToAdd, false, &m_bStop))
+  {
+    if (!m_bStop)
+      CLog::Log(LOGERROR, "%s - failed to add the songs of %s", __FUNCTION__, items.GetPath().c_str());
+    return -1;
+  }
   for (unsigned int i = 0; i < songsToAdd.size(); ++i)
   {
-    if (m_bStop)
-    {
-      m_musicDatabase.RollbackTransaction();
-      return i;
-    }
     CSong &song = songsToAdd[i];
-    m_musicDatabase.AddSong(song, false);
-
     artistsToScan.insert(StringUtils::Join(song.artist, g_advancedSettings.m_musicItemSeparator));
     albumsToScan.insert(make_pair(song.strAlbum, StringUtils::Join(song.artist, g_advancedSettings.m_musicItemSeparator)));
   }
-  m_musicDatabase.CommitTransaction();
 
   bool bCanceled;
   for (set<CStdString>::iterator i = artistsToScan.begin(); i != artistsToScan.end(); ++i)
@@ -747,24 +772,29 @@ void CMusicInfoScanner::UpdateFolderThumb(const VECSONGS &songs, const CStdStrin
 void CMusicInfoScanner::Run()
 {
   int count = 0;
+  CDirectoryWalker walker(g_settings.m_musicExtensions, DIR_FLAG_NO_FILE_DIRS);
   while (!m_bStop && m_pathsToCount.size())
-    count+=CountFilesRecursively(*m_pathsToCount.begin());
+    count+=CountFilesRecursively(*m_pathsToCount.begin(), walker);
   m_itemCount = count;
 }
 
 // Recurse through all folders we scan and count files
-int CMusicInfoScanner::CountFilesRecursively(const CStdString& strPath)
+int CMusicInfoScanner::CountFilesRecursively(const CStdString& strPath, CDirectoryWalker &walker)
 {
-  // load subfolder
+  // load subfolder - the walker fetches its subfolders in the meantime
   CFileItemList items;
 //  CLog::Log(LOGDEBUG, __FUNCTION__" - processing dir: %s", strPath.c_str());
-  CDirectory::GetDirectory(strPath, items, g_settings.m_musicExtensions, DIR_FLAG_NO_FILE_DIRS);
+  walker.GetDirectory(strPath, items);
 
   if (m_bStop)
     return 0;
 
-  // true for recursive counting
-  int count = CountFiles(items, true);
+  int count = CountFiles(items);
+  for (int i = 0; i < items.Size() && !m_bStop; ++i)
+  {
+    if (items[i]->m_bIsFolder)
+      count+=CountFilesRecursively(items[i]->GetPath(), walker);
+  }
 
   // remove this path from the list we're processing
   set<CStdString>::iterator it = m_pathsToCount.find(strPath);
@@ -775,16 +805,14 @@ int CMusicInfoScanner::CountFilesRecursively(const CStdString& strPath)
   return count;
 }
 
-int CMusicInfoScanner::CountFiles(const CFileItemList &items, bool recursive)
+int CMusicInfoScanner::CountFiles(const CFileItemList &items)
 {
   int count = 0;
   for (int i=0; i<items.Size(); ++i)
   {
     const CFileItemPtr pItem=items[i];
 
-    if (recursive && pItem->m_bIsFolder)
-      count+=CountFilesRecursively(pItem->GetPath());
-    else if (pItem->IsAudio() && !pItem->IsPlayList() && !pItem->IsNFO())
+    if (!pItem->m_bIsFolder && pItem->IsAudio() && !pItem->IsPlayList() && !pItem->IsNFO())
       count++;
   }
   return count;
@@ -26,6 +26,11 @@
 class CAlbum;
 class CArtist;
 
+namespace XFILE
+{
+  class CDirectoryWalker;
+}
+
 namespace MUSIC_INFO
 {
 enum SCAN_STATE { PREPARING = 0, REMOVING_OLD, CLEANING_UP_DATABASE, READING_MUSIC_INFO, DOWNLOADING_ALBUM_INFO, DOWNLOADING_ARTIST_INFO, COMPRESSING_DATABASE, WRITING_CHANGES };
@@ -61,6 +66,9 @@ public:
   bool DownloadArtistInfo(const CStdString& strPath, const CStdString& strArtist, bool& bCanceled, CGUIDialogProgress* pDialog=NULL);
 protected:
   virtual void Process();
+  /*! \brief Read the tags of the songs in a folder and add them to the database
+   \return the number of songs added, or -1 if the scan was stopped or the songs were not stored
+   */
   int RetrieveMusicInfo(CFileItemList& items, const CStdString& strDirectory);
   void UpdateFolderThumb(const VECSONGS &songs, const CStdString &folderPath);
   int GetPathHash(const CFileItemList &items, CStdString &hash);
@@ -70,8 +78,8 @@ protected:
   bool DoScan(const CStdString& strDirectory);
 
   virtual void Run();
-  int CountFiles(const CFileItemList& items, bool recursive);
-  int CountFilesRecursively(const CStdString& strPath);
+  int CountFiles(const CFileItemList& items);
+  int CountFilesRecursively(const CStdString& strPath, XFILE::CDirectoryWalker &walker);
 
 protected:
   IMusicInfoScannerObserver* m_pObserver;
@@ -57,6 +57,67 @@ using namespace ANNOUNCEMENT;
 
 #define RECEIVEBUFFER 1024
 
+#ifndef MSG_DONTWAIT
+// without it a send that was cleared by select may still block until the
+// whole buffer is out
+#define MSG_DONTWAIT 0
+#endif
+
+static bool IsWritable(SOCKET socket)
+{
+  fd_set         wfds;
+  struct timeval to = {0, 0};
+  FD_ZERO(&wfds);
+  FD_SET(socket, &wfds);
+
+  return select((intptr_t)socket + 1, NULL, &wfds, NULL, &to) > 0;
+}
+
+// Collects the serialized response of a JSON-RPC call and sends it to the
+// client whenever a chunk is full, so large library listings never have to
+// exist as one string. Announcements queued before the call go out first,
+// the ones queued meanwhile wait until the client is unlocked once the
+// response is out, so none ends up between two chunks.
+class CTCPServer::CTCPResponseStream : public IJSONOutputStream
+{
+public:
+  CTCPResponseStream(CTCPClient *client)
+    : m_lock(client->m_critSection), m_client(client), m_chunkSize(client->GetResponseChunkSize())
+  {
+    if (m_chunkSize > 0)
+      m_buffer.reserve(m_chunkSize);
+    m_client->FlushAnnouncements(true);
+    m_client->m_responding = true;
+  }
+
+  ~CTCPResponseStream()
+  {
+    m_client->m_responding = false;
+  }
+
+  virtual void Write(const char *data, size_t length)
+  {
+    m_buffer.append(data, length);
+    if (m_chunkSize > 0 && m_buffer.size() >= m_chunkSize)
+      Flush();
+  }
+
+  void Flush()
+  {
+    if (m_buffer.empty())
+      return;
+
+    m_client->SendResponse(m_buffer.c_str(), m_buffer.size());
+    m_buffer.clear();
+  }
+
+private:
+  CSingleLock m_lock;
+  CTCPClient *m_client;
+  size_t m_chunkSize;
+  std::string m_buffer;
+};
+
 CTCPServer *CTCPServer::ServerInstance = NULL;
 
 bool CTCPServer::StartServer(int port, bool nonlocal)
@@ -100,9 +161,10 @@ void CTCPServer::Process()
   while (!m_bStop)
   {
     SOCKET          max_fd = 0;
-    fd_set          rfds;
+    fd_set          rfds, wfds;
     struct timeval  to     = {1, 0};
     FD_ZERO(&rfds);
+    FD_ZERO(&wfds);
 
     for (std::vector<SOCKET>::iterator it = m_servers.begin(); it != m_servers.end(); it++)
     {
@@ -114,11 +176,14 @@ void CTCPServer::Process()
     for (unsigned int i = 0; i < m_connections.size(); i++)
     {
       FD_SET(m_connections[i]->m_socket, &rfds);
+      // wake up as soon as a client that fell behind can take more
+      if (m_connections[i]->HasPendingAnnouncements())
+        FD_SET(m_connections[i]->m_socket, &wfds);
       if ((intptr_t)m_connections[i]->m_socket > (intptr_t)max_fd)
         max_fd = m_connections[i]->m_socket;
     }
 
-    int res = select((intptr_t)max_fd+1, &rfds, NULL, NULL, &to);
+    int res = select((intptr_t)max_fd+1, &rfds, &wfds, NULL, &to);
     if (res < 0)
     {
       CLog::Log(LOGERROR, "JSONRPC Server: Select failed");
@@ -148,6 +213,7 @@ void CTCPServer::Process()
               if (websocket != NULL)
               {
                 // Replace the CTCPClient with a CWebSocketClient
+                CSingleLock lock (m_connectionsSection);
                 CWebSocketClient *websocketClient = new CWebSocketClient(websocket, *(m_connections[i]));
                 delete m_connections[i];
                 m_connections.erase(m_connections.begin() + i);
@@ -162,9 +228,13 @@ void CTCPServer::Process()
           if (nread <= 0)
           {
             CLog::Log(LOGINFO, "JSONRPC Server: Disconnection detected");
-            m_connections[i]->Disconnect();
-            delete m_connections[i];
-            m_connections.erase(m_connections.begin() + i);
+            CTCPClient *connection = m_connections[i];
+            {
+              CSingleLock lock (m_connectionsSection);
+              m_connections.erase(m_connections.begin() + i);
+            }
+            connection->Disconnect();
+            delete connection;
           }
         }
       }
@@ -182,11 +252,23 @@ void CTCPServer::Process()
           else
           {
             CLog::Log(LOGINFO, "JSONRPC Server: New connection added");
+            CSingleLock lock (m_connectionsSection);
             m_connections.push_back(newconnection);
           }
         }
       }
     }
+
+    // announcements the announcing thread could not send right away, either
+    // because we were busy answering that client or because it fell behind
+    for (unsigned int i = 0; i < m_connections.size(); i++)
+    {
+      if (m_connections[i]->HasPendingAnnouncements())
+      {
+        CSingleLock lock (m_connections[i]->m_critSection);
+        m_connections[i]->FlushAnnouncements(false);
+      }
+    }
   }
 
   Deinitialize();
@@ -211,15 +293,21 @@ void CTCPServer::Announce(AnnouncementFlag flag, const char *sender, const char
 {
   std::string str = IJSONRPCAnnouncer::AnnouncementToJSONRPC(flag, sender, message, data, g_advancedSettings.m_jsonOutputCompact);
 
+  CSingleLock connectionsLock (m_connectionsSection);
   for (unsigned int i = 0; i < m_connections.size(); i++)
   {
-    {
-      CSingleLock lock (m_connections[i]->m_critSection);
-      if ((m_connections[i]->GetAnnouncementFlags() & flag) == 0)
-        continue;
-    }
-
-    m_connections[i]->Send(str.c_str(), str.size());
+    CTCPClient *connection = m_connections[i];
+    if ((connection->GetAnnouncementFlags() & flag) == 0)
+      continue;
+
+    connection->QueueAnnouncement(str.c_str(), str.size());
+
+    // if the server thread is busy with this client it sends the
+    // announcement once it is done, even when the announcement comes from
+    // the thread sending the response, which holds the lock already
+    CSingleTryLock lock (connection->m_critSection);
+    if (lock.IsOwner() && !connection->m_responding)
+      connection->FlushAnnouncements(false);
   }
 }
 
@@ -463,13 +551,17 @@ bool CTCPServer::InitializeTCP()
 
 void CTCPServer::Deinitialize()
 {
-  for (unsigned int i = 0; i < m_connections.size(); i++)
+  std::vector<CTCPClient*> connections;
   {
-    m_connections[i]->Disconnect();
-    delete m_connections[i];
+    CSingleLock lock (m_connectionsSection);
+    connections.swap(m_connections);
   }
 
-  m_connections.clear();
+  for (unsigned int i = 0; i < connections.size(); i++)
+  {
+    connections[i]->Disconnect();
+    delete connections[i];
+  }
 
   for (unsigned int i = 0; i < m_servers.size(); i++)
     closesocket(m_servers[i]);
@@ -494,6 +586,8 @@ CTCPServer::CTCPClient::CTCPClient()
   m_endBrackets = 0;
   m_beginChar = 0;
   m_endChar = 0;
+  m_pendingOverflow = false;
+  m_responding = false;
 
   m_addrlen = sizeof(m_cliaddr);
 }
@@ -526,13 +620,95 @@ bool CTCPServer::CTCPClient::SetAnnouncementFlags(int flags)
 }
 
 void CTCPServer::CTCPClient::Send(const char *data, unsigned int size)
+{
+  CSingleLock lock (m_critSection);
+  // an announcement that only went out partially has to be completed first
+  FlushAnnouncements(true);
+  SendResponse(data, size);
+}
+
+void CTCPServer::CTCPClient::SendResponse(const char *data, unsigned int size)
+{
+  SendData(data, size);
+}
+
+void CTCPServer::CTCPClient::SendData(const char *data, unsigned int size)
 {
   unsigned int sent = 0;
-  do
+  while (sent < size)
   {
-    CSingleLock lock (m_critSection);
-    sent += send(m_socket, data, size - sent, 0);
-  } while (sent < size);
+    int res = send(m_socket, data + sent, size - sent, 0);
+    if (res <= 0)
+    {
+      CLog::Log(LOGERROR, "JSONRPC Server: Failed to send data to client");
+      return;
+    }
+    sent += res;
+  }
+}
+
+void CTCPServer::CTCPClient::QueueAnnouncement(const char *data, unsigned int size)
+{
+  QueueData(data, size);
+}
+
+void CTCPServer::CTCPClient::QueueData(const char *data, unsigned int size)
+{
+  CSingleLock lock (m_pendingSection);
+  if (m_pending.size() + size > PENDINGANNOUNCEMENTSIZE)
+  {
+    if (!m_pendingOverflow)
+      CLog::Log(LOGWARNING, "JSONRPC Server: Client does not keep up, dropping announcements");
+    m_pendingOverflow = true;
+    return;
+  }
+
+  m_pendingOverflow = false;
+  m_pending.append(data, size);
+}
+
+bool CTCPServer::CTCPClient::HasPendingAnnouncements()
+{
+  CSingleLock lock (m_pendingSection);
+  return !m_pending.empty();
+}
+
+void CTCPServer::CTCPClient::FlushAnnouncements(bool block)
+{
+  std::string pending;
+  {
+    CSingleLock lock (m_pendingSection);
+    if (m_pending.empty())
+      return;
+    pending.swap(m_pending);
+  }
+
+  if (block)
+  {
+    SendData(pending.c_str(), pending.size());
+    return;
+  }
+
+  unsigned int sent = 0;
+  while (sent < pending.size() && IsWritable(m_socket))
+  {
+    int res = send(m_socket, pending.c_str() + sent, pending.size() - sent, MSG_DONTWAIT);
+    if (res <= 0)
+    {
+      // the socket claimed to be writable so the connection is broken,
+      // dropping the rest keeps select from waking us up over and over
+      CLog::Log(LOGERROR, "JSONRPC Server: Failed to send announcements to client");
+      return;
+    }
+    sent += res;
+  }
+
+  // put back what the socket did not take, ahead of anything queued meanwhile
+  if (sent < pending.size())
+  {
+    CSingleLock lock (m_pendingSection);
+    m_pending.insert(0, pending, sent, std::string::npos);
+  }
 }
 
 void CTCPServer::CTCPClient::PushBuffer(CTCPServer *host, const char *buffer, int length)
@@ -563,8 +739,9 @@ void CTCPServer::CTCPClient::PushBuffer(CTCPServer *host, const char *buffer, in
         m_endBrackets++;
       if (m_beginBrackets > 0 && m_endBrackets > 0 && m_beginBrackets == m_endBrackets)
       {
-        std::string line = CJSONRPC::MethodCall(m_buffer, host, this);
-        Send(line.c_str(), line.size());
+        CTCPResponseStream response(this);
+        if (CJSONRPC::MethodCall(m_buffer, host, this, response))
+          response.Flush();
         m_beginChar = m_beginBrackets = m_endBrackets = 0;
         m_buffer.clear();
       }
@@ -595,6 +772,9 @@ void CTCPServer::CTCPClient::Copy(const CTCPClient& client)
   m_beginChar         = client.m_beginChar;
   m_endChar           = client.m_endChar;
   m_buffer            = client.m_buffer;
+  m_pending           = client.m_pending;
+  m_pendingOverflow   = client.m_pendingOverflow;
+  m_responding        = client.m_responding;
 }
 
 CTCPServer::CWebSocketClient::CWebSocketClient(CWebSocket *websocket)
@@ -630,15 +810,41 @@ CTCPServer::CWebSocketClient& CTCPServer::CWebSocketClient::operator=(const CWeb
   return *this;
 }
 
-void CTCPServer::CWebSocketClient::Send(const char *data, unsigned int size)
+void CTCPServer::CWebSocketClient::SendResponse(const char *data, unsigned int size)
+{
+  const CWebSocketMessage *msg = m_websocket->Send(WebSocketTextFrame, data, size);
+  if (msg == NULL)
+    return;
+
+  if (msg->IsComplete())
+  {
+    std::vector<const CWebSocketFrame *> frames = msg->GetFrames();
+    for (unsigned int index = 0; index < frames.size(); index++)
+      SendData(frames.at(index)->GetFrameData(), (unsigned int)frames.at(index)->GetFrameLength());
+  }
+
+  delete msg;
+}
+
+void CTCPServer::CWebSocketClient::QueueAnnouncement(const char *data, unsigned int size)
 {
   const CWebSocketMessage *msg = m_websocket->Send(WebSocketTextFrame, data, size);
-  if (msg == NULL || !msg->IsComplete())
+  if (msg == NULL)
     return;
+  if (!msg->IsComplete())
+  {
+    delete msg;
+    return;
+  }
 
+  // queue all frames at once so they are either all sent or all dropped
+  std::string frameData;
   std::vector<const CWebSocketFrame *> frames = msg->GetFrames();
   for (unsigned int index = 0; index < frames.size(); index++)
-    CTCPClient::Send(frames.at(index)->GetFrameData(), (unsigned int)frames.at(index)->GetFrameLength());
+    frameData.append(frames.at(index)->GetFrameData(), (size_t)frames.at(index)->GetFrameLength());
+
+  delete msg;
+  QueueData(frameData.c_str(), frameData.size());
 }
 
 void CTCPServer::CWebSocketClient::PushBuffer(CTCPServer *host, const char *buffer, int length)
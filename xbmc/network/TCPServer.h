@@ -30,6 +30,10 @@
 #include "threads/Thread.h"
 #include "websocket/WebSocket.h"
 
+#define RESPONSECHUNKSIZE 65536
+// announcements a client may fall behind by before it misses some
+#define PENDINGANNOUNCEMENTSIZE (1024 * 1024)
+
 namespace JSONRPC
 {
   class CTCPServer : public ITransportLayer, public JSONRPC::IJSONRPCAnnouncer, public CThread
@@ -70,21 +74,52 @@ namespace JSONRPC
       virtual void PushBuffer(CTCPServer *host, const char *buffer, int length);
       virtual void Disconnect();
 
+      /*!
+       \brief Send (part of) a response without sending queued announcements
+       first, the caller has to hold m_critSection
+       */
+      virtual void SendResponse(const char *data, unsigned int size);
+
+      /*!
+       \brief Queue an announcement without touching the socket, so a
+       client that does not read cannot hold up the announcing thread
+       */
+      virtual void QueueAnnouncement(const char *data, unsigned int size);
+      bool HasPendingAnnouncements();
+      /*!
+       \brief Send queued announcements, the caller has to hold m_critSection
+       \param block whether to wait until everything is sent or only send
+       as much as the socket takes right now
+       */
+      void FlushAnnouncements(bool block);
+
       virtual bool IsNew() const { return m_new; }
+      /*!
+       \brief Size of the pieces a response is sent in while it is serialized,
+       0 to send every response as a whole
+       */
+      virtual unsigned int GetResponseChunkSize() const { return RESPONSECHUNKSIZE; }
 
       SOCKET           m_socket;
       sockaddr_storage m_cliaddr;
       socklen_t        m_addrlen;
       CCriticalSection m_critSection;
+      bool             m_responding; ///< a response is being sent, guarded by m_critSection
 
     protected:
       void Copy(const CTCPClient& client);
+      void SendData(const char *data, unsigned int size);
+      void QueueData(const char *data, unsigned int size);
     private:
       bool m_new;
       int m_announcementflags;
       int m_beginBrackets, m_endBrackets;
       char m_beginChar, m_endChar;
       std::string m_buffer;
+
+      std::string m_pending;
+      bool m_pendingOverflow;
+      CCriticalSection m_pendingSection;
     };
 
     class CWebSocketClient : public CTCPClient
@@ -96,17 +131,25 @@ namespace JSONRPC
       CWebSocketClient& operator=(const CWebSocketClient& client);
       ~CWebSocketClient();
 
-      virtual void Send(const char *data, unsigned int size);
+      virtual void SendResponse(const char *data, unsigned int size);
       virtual void PushBuffer(CTCPServer *host, const char *buffer, int length);
       virtual void Disconnect();
+      virtual void QueueAnnouncement(const char *data, unsigned int size);
 
       virtual bool IsNew() const { return m_websocket == NULL; }
+      // every response has to go out as one websocket message
+      virtual unsigned int GetResponseChunkSize() const { return 0; }
 
     private:
       CWebSocket *m_websocket;
     };
 
+    class CTCPResponseStream;
+
     std::vector<CTCPClient*> m_connections;
+    // guards m_connections against the announcing thread, only the server
+    // thread modifies it
+    CCriticalSection m_connectionsSection;
     std::vector<SOCKET> m_servers;
     int m_port;
     bool m_nonlocal;
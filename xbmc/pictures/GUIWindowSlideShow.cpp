@@ -21,6 +21,7 @@
 
 #include "threads/SystemClock.h"
 #include "system.h"
+#include <algorithm>
 #include "GUIWindowSlideShow.h"
 #include "Application.h"
 #include "Picture.h"
@@ -41,6 +42,7 @@
 #include "guilib/Texture.h"
 #include "guilib/LocalizeStrings.h"
 #include "threads/SingleLock.h"
+#include "utils/JobManager.h"
 #include "utils/log.h"
 #include "utils/TimeUtils.h"
 
@@ -67,15 +69,200 @@ using namespace XFILE;
 
 static float zoomamount[10] = { 1.0f, 1.2f, 1.5f, 2.0f, 2.8f, 4.0f, 6.0f, 9.0f, 13.5f, 20.0f };
 
+#define PREFETCH_PREVIEW_DIVIDER              4 /* previews are decoded at a quarter of the size */
+
+class CSlideShowPrefetchJob : public CJob
+{
+public:
+  CSlideShowPrefetchJob(const CSlideShowPicCachePtr &cache, const CStdString &strFileName, int maxWidth, int maxHeight)
+    : m_cache(cache), m_strFileName(strFileName), m_maxWidth(maxWidth), m_maxHeight(maxHeight) {}
+
+  virtual const char *GetType() const { return "slideshowprefetch"; }
+
+  virtual bool DoWork()
+  {
+    // the loader may have claimed the picture, or it's no longer wanted
+    if (!m_cache->StartDecode(m_strFileName, m_maxWidth, m_maxHeight))
+      return false;
+
+    unsigned int originalWidth = 0;
+    unsigned int originalHeight = 0;
+    CBaseTexture *texture = CBackgroundPicLoader::LoadTexture(m_strFileName, m_maxWidth, m_maxHeight, originalWidth, originalHeight);
+    m_cache->Add(m_strFileName, m_maxWidth, m_maxHeight, texture, originalWidth, originalHeight);
+    return texture != NULL;
+  }
+
+private:
+  CSlideShowPicCachePtr m_cache;
+  CStdString m_strFileName;
+  int m_maxWidth;
+  int m_maxHeight;
+};
+
+CSlideShowPicCache::~CSlideShowPicCache()
+{
+  Clear();
+}
+
+std::vector<CSlideShowPicCache::CachedPic>::iterator CSlideShowPicCache::Find(const CStdString &file, int maxWidth, int maxHeight)
+{
+  std::vector<CachedPic>::iterator it = m_pics.begin();
+  while (it != m_pics.end() && !(it->file == file && it->maxWidth == maxWidth && it->maxHeight == maxHeight))
+    ++it;
+  return it;
+}
+
+void CSlideShowPicCache::CancelJobs(const std::vector<unsigned int> &jobs)
+{
+  for (std::vector<unsigned int>::const_iterator it = jobs.begin(); it != jobs.end(); ++it)
+    CJobManager::GetInstance().CancelJob(*it);
+}
+
+void CSlideShowPicCache::SetWanted(const std::vector<CStdString> &files, int maxWidth, int maxHeight, std::vector<CStdString> &added)
+{
+  std::vector<unsigned int> cancelled;
+  CSingleLock lock(m_section);
+  for (std::vector<CachedPic>::iterator it = m_pics.begin(); it != m_pics.end();)
+  {
+    if (it->maxWidth != maxWidth || it->maxHeight != maxHeight ||
+        std::find(files.begin(), files.end(), it->file) == files.end())
+    {
+      // a picture that is still being decoded is deleted once it's added
+      if (it->state == PIC_QUEUED && it->hasJob)
+        cancelled.push_back(it->jobID);
+      delete it->texture;
+      it = m_pics.erase(it);
+    }
+    else
+      ++it;
+  }
+
+  for (std::vector<CStdString>::const_iterator file = files.begin(); file != files.end(); ++file)
+  {
+    if (Find(*file, maxWidth, maxHeight) != m_pics.end())
+      continue;
+
+    CachedPic pic;
+    pic.file           = *file;
+    pic.maxWidth       = maxWidth;
+    pic.maxHeight      = maxHeight;
+    pic.state          = PIC_QUEUED;
+    pic.hasJob         = false;
+    pic.jobID          = 0;
+    pic.texture        = NULL;
+    pic.originalWidth  = 0;
+    pic.originalHeight = 0;
+    m_pics.push_back(pic);
+    added.push_back(*file);
+  }
+  m_decoded.notifyAll();
+  lock.Leave();
+
+  // cancelling deletes the queued jobs, which must not happen under our lock
+  CancelJobs(cancelled);
+}
+
+void CSlideShowPicCache::SetJob(const CStdString &file, int maxWidth, int maxHeight, unsigned int jobID)
+{
+  CSingleLock lock(m_section);
+  std::vector<CachedPic>::iterator it = Find(file, maxWidth, maxHeight);
+  if (it != m_pics.end())
+  {
+    it->hasJob = true;
+    it->jobID  = jobID;
+  }
+}
+
+bool CSlideShowPicCache::StartDecode(const CStdString &file, int maxWidth, int maxHeight)
+{
+  CSingleLock lock(m_section);
+  std::vector<CachedPic>::iterator it = Find(file, maxWidth, maxHeight);
+  if (it == m_pics.end() || it->state != PIC_QUEUED)
+    return false;
+  it->state = PIC_DECODING;
+  return true;
+}
+
+void CSlideShowPicCache::Add(const CStdString &file, int maxWidth, int maxHeight, CBaseTexture *texture, unsigned int originalWidth, unsigned int originalHeight)
+{
+  CSingleLock lock(m_section);
+  std::vector<CachedPic>::iterator it = Find(file, maxWidth, maxHeight);
+  if (it != m_pics.end() && it->state == PIC_DECODING)
+  {
+    it->state          = PIC_DONE;
+    it->texture        = texture;
+    it->originalWidth  = originalWidth;
+    it->originalHeight = originalHeight;
+  }
+  else // no longer wanted
+    delete texture;
+  m_decoded.notifyAll();
+}
+
+CBaseTexture *CSlideShowPicCache::Take(const CStdString &file, int maxWidth, int maxHeight, unsigned int &originalWidth, unsigned int &originalHeight)
+{
+  CSingleLock lock(m_section);
+  while (true)
+  {
+    std::vector<CachedPic>::iterator it = Find(file, maxWidth, maxHeight);
+    if (it == m_pics.end())
+      return NULL;
+
+    if (it->state == PIC_QUEUED)
+    { // the job hasn't started yet, so the caller decodes it without waiting for a free worker
+      bool hasJob = it->hasJob;
+      unsigned int jobID = it->jobID;
+      m_pics.erase(it);
+      lock.Leave();
+      if (hasJob)
+        CJobManager::GetInstance().CancelJob(jobID);
+      return NULL;
+    }
+
+    if (it->state == PIC_DECODING)
+    { // it's being decoded right now, which is quicker than starting over
+      m_decoded.wait(m_section);
+      continue;
+    }
+
+    CBaseTexture *texture = it->texture;
+    originalWidth  = it->originalWidth;
+    originalHeight = it->originalHeight;
+    m_pics.erase(it);
+    return texture;
+  }
+}
+
+void CSlideShowPicCache::Clear()
+{
+  std::vector<unsigned int> cancelled;
+  CSingleLock lock(m_section);
+  for (std::vector<CachedPic>::iterator it = m_pics.begin(); it != m_pics.end(); ++it)
+  {
+    if (it->state == PIC_QUEUED && it->hasJob)
+      cancelled.push_back(it->jobID);
+    delete it->texture;
+  }
+  m_pics.clear();
+  m_decoded.notifyAll();
+  lock.Leave();
+
+  CancelJobs(cancelled);
+}
+
 CBackgroundPicLoader::CBackgroundPicLoader() : CThread("CBackgroundPicLoader")
 {
   m_pCallback = NULL;
   m_isLoading = false;
+  m_bPreview = false;
+  m_cache.reset(new CSlideShowPicCache);
 }
 
 CBackgroundPicLoader::~CBackgroundPicLoader()
 {
   StopThread();
+  // prefetch jobs that are still running share the cache, and discard their pictures
+  CancelPrefetch();
 }
 
 void CBackgroundPicLoader::Create(CGUIWindowSlideShow *pCallback)
@@ -85,6 +272,29 @@ void CBackgroundPicLoader::Create(CGUIWindowSlideShow *pCallback)
   CThread::Create(false);
 }
 
+CBaseTexture *CBackgroundPicLoader::LoadTexture(const CStdString &strFileName, int maxWidth, int maxHeight, unsigned int &originalWidth, unsigned int &originalHeight)
+{
+  CBaseTexture* texture = new CTexture();
+  texture->LoadFromFile(strFileName, maxWidth, maxHeight, g_guiSettings.GetBool("pictures.useexifrotation"), &originalWidth, &originalHeight);
+  return texture;
+}
+
+bool CBackgroundPicLoader::IsFullSize(CBaseTexture *texture) const
+{
+  bool bFullSize = ((int)texture->GetWidth() < m_maxWidth) && ((int)texture->GetHeight() < m_maxHeight);
+  if (!bFullSize)
+  {
+    int iSize = texture->GetWidth() * texture->GetHeight() - MAX_PICTURE_SIZE;
+    if ((iSize + (int)texture->GetWidth() > 0) || (iSize + (int)texture->GetHeight() > 0))
+      bFullSize = true;
+    if (!bFullSize && texture->GetWidth() == g_Windowing.GetMaxTextureSize())
+      bFullSize = true;
+    if (!bFullSize && texture->GetHeight() == g_Windowing.GetMaxTextureSize())
+      bFullSize = true;
+  }
+  return bFullSize;
+}
+
 void CBackgroundPicLoader::Process()
 {
   unsigned int totalTime = 0;
@@ -96,25 +306,36 @@ void CBackgroundPicLoader::Process()
       if (m_pCallback)
       {
         unsigned int start = XbmcThreads::SystemClockMillis();
-        CBaseTexture* texture = new CTexture();
         unsigned int originalWidth = 0;
         unsigned int originalHeight = 0;
-        texture->LoadFromFile(m_strFileName, m_maxWidth, m_maxHeight, g_guiSettings.GetBool("pictures.useexifrotation"), &originalWidth, &originalHeight);
+        bool bPreviewShown = false;
+        // the slides around the current one are decoded in parallel, so the picture may be ready already
+        CBaseTexture* texture = m_cache->Take(m_strFileName, m_maxWidth, m_maxHeight, originalWidth, originalHeight);
+        if (!texture)
+        {
+          // jpegs are scaled while decoding, so a small preview can be shown quickly while the full picture is decoded
+          CStdString extension = URIUtils::GetExtension(m_strFileName);
+          if (m_bPreview && (extension.Equals(".jpg") || extension.Equals(".jpeg")))
+          {
+            CBaseTexture* preview = LoadTexture(m_strFileName, m_maxWidth / PREFETCH_PREVIEW_DIVIDER, m_maxHeight / PREFETCH_PREVIEW_DIVIDER, originalWidth, originalHeight);
+            if (preview->GetWidth() > 0 && preview->GetHeight() > 0)
+            {
+              m_pCallback->OnLoadPic(m_iPic, m_iSlideNumber, preview, originalWidth, originalHeight, false);
+              bPreviewShown = true;
+            }
+            else
+              delete preview;
+          }
+          texture = LoadTexture(m_strFileName, m_maxWidth, m_maxHeight, originalWidth, originalHeight);
+        }
         totalTime += XbmcThreads::SystemClockMillis() - start;
         count++;
         // tell our parent
-        bool bFullSize = ((int)texture->GetWidth() < m_maxWidth) && ((int)texture->GetHeight() < m_maxHeight);
-        if (!bFullSize)
-        {
-          int iSize = texture->GetWidth() * texture->GetHeight() - MAX_PICTURE_SIZE;
-          if ((iSize + (int)texture->GetWidth() > 0) || (iSize + (int)texture->GetHeight() > 0))
-            bFullSize = true;
-          if (!bFullSize && texture->GetWidth() == g_Windowing.GetMaxTextureSize())
-            bFullSize = true;
-          if (!bFullSize && texture->GetHeight() == g_Windowing.GetMaxTextureSize())
-            bFullSize = true;
-        }
-        m_pCallback->OnLoadPic(m_iPic, m_iSlideNumber, texture, originalWidth, originalHeight, bFullSize);
+        bool bFullSize = IsFullSize(texture);
+        if (bPreviewShown)
+          m_pCallback->OnUpdatePic(m_iPic, m_iSlideNumber, texture, originalWidth, originalHeight, bFullSize);
+        else
+          m_pCallback->OnLoadPic(m_iPic, m_iSlideNumber, texture, originalWidth, originalHeight, bFullSize);
         m_isLoading = false;
       }
     }
@@ -124,21 +345,39 @@ void CBackgroundPicLoader::Process()
               count, totalTime, totalTime / count);
 }
 
-void CBackgroundPicLoader::LoadPic(int iPic, int iSlideNumber, const CStdString &strFileName, const int maxWidth, const int maxHeight)
+void CBackgroundPicLoader::LoadPic(int iPic, int iSlideNumber, const CStdString &strFileName, const int maxWidth, const int maxHeight, bool bPreview /* = false */)
 {
   m_iPic = iPic;
   m_iSlideNumber = iSlideNumber;
   m_strFileName = strFileName;
   m_maxWidth = maxWidth;
   m_maxHeight = maxHeight;
+  m_bPreview = bPreview;
   m_isLoading = true;
   m_loadPic.Set();
 }
 
+void CBackgroundPicLoader::Prefetch(const std::vector<CStdString> &files, const int maxWidth, const int maxHeight)
+{
+  std::vector<CStdString> added;
+  m_cache->SetWanted(files, maxWidth, maxHeight, added);
+  for (std::vector<CStdString>::const_iterator it = added.begin(); it != added.end(); ++it)
+  {
+    unsigned int jobID = CJobManager::GetInstance().AddJob(new CSlideShowPrefetchJob(m_cache, *it, maxWidth, maxHeight), NULL, CJob::PRIORITY_NORMAL);
+    m_cache->SetJob(*it, maxWidth, maxHeight, jobID);
+  }
+}
+
+void CBackgroundPicLoader::CancelPrefetch()
+{
+  m_cache->Clear();
+}
+
 CGUIWindowSlideShow::CGUIWindowSlideShow(void)
     : CGUIWindow(WINDOW_SLIDESHOW, "SlideShow.xml")
 {
   m_pBackgroundLoader = NULL;
+  m_iPrefetchSlide = -1;
   m_slides = new CFileItemList;
   m_Resolution = RES_INVALID;
   Reset();
@@ -175,6 +414,9 @@ void CGUIWindowSlideShow::Reset()
   m_iNextSlide = 1;
   m_iCurrentPic = 0;
   m_iDirection = 1;
+  m_iPrefetchSlide = -1;
+  if (m_pBackgroundLoader)
+    m_pBackgroundLoader->CancelPrefetch();
   CSingleLock lock(m_slideSection);
   m_slides->Clear();
   m_Resolution = g_graphicsContext.GetVideoResolution();
@@ -194,6 +436,7 @@ void CGUIWindowSlideShow::FreeResources()
     delete m_pBackgroundLoader;
     m_pBackgroundLoader = NULL;
   }
+  m_iPrefetchSlide = -1;
   // and close the images.
   m_Image[0].Close();
   m_Image[1].Close();
@@ -368,7 +611,7 @@ void CGUIWindowSlideShow::Process(unsigned int currentTime, CDirtyRegionList &re
                     (float)g_settings.m_ResInfo[m_Resolution].iHeight * zoomamount[m_iZoomFactor - 1],
                     maxWidth, maxHeight);
     if (!m_slides->Get(m_iCurrentSlide)->IsVideo())
-      m_pBackgroundLoader->LoadPic(m_iCurrentPic, m_iCurrentSlide, m_slides->Get(m_iCurrentSlide)->GetPath(), maxWidth, maxHeight);
+      m_pBackgroundLoader->LoadPic(m_iCurrentPic, m_iCurrentSlide, m_slides->Get(m_iCurrentSlide)->GetPath(), maxWidth, maxHeight, true);
   }
 
   // check if we should discard an already loaded next slide
@@ -404,6 +647,10 @@ void CGUIWindowSlideShow::Process(unsigned int currentTime, CDirtyRegionList &re
   }
   else
   {
+    // decode the slides around the current one in the background, before the next one is requested
+    if (m_iPrefetchSlide != m_iCurrentSlide && m_Image[m_iCurrentPic].IsLoaded())
+      PrefetchSlides();
+
     if (m_iNextSlide != m_iCurrentSlide && m_Image[m_iCurrentPic].IsLoaded() && !m_Image[1 - m_iCurrentPic].IsLoaded() && !m_pBackgroundLoader->IsLoading() && !m_bWaitForNextPic)
     { // load the next image
       CLog::Log(LOGDEBUG, "Loading the next image %s", m_slides->Get(m_iNextSlide)->GetPath().c_str());
@@ -507,6 +754,36 @@ int CGUIWindowSlideShow::GetNextSlide()
     return (m_iCurrentSlide - 1 + m_slides->Size()) % m_slides->Size();
 }
 
+void CGUIWindowSlideShow::PrefetchSlides()
+{
+  m_iPrefetchSlide = m_iCurrentSlide;
+
+  // the next slide, the one after it and the previous one, so going back is quick as well
+  int iSlides = m_slides->Size();
+  int iDirection = (m_bSlideShow || m_iDirection >= 0) ? 1 : -1;
+  int candidates[3] = { m_iNextSlide,
+                        (m_iNextSlide + iDirection + iSlides) % iSlides,
+                        (m_iCurrentSlide - iDirection + iSlides) % iSlides };
+
+  std::vector<CStdString> files;
+  for (unsigned int i = 0; i < sizeof(candidates) / sizeof(candidates[0]); i++)
+  {
+    int iSlide = candidates[i];
+    if (iSlide == m_iCurrentSlide || m_slides->Get(iSlide)->IsVideo())
+      continue;
+    const CStdString &strFile = m_slides->Get(iSlide)->GetPath();
+    if (std::find(files.begin(), files.end(), strFile) == files.end())
+      files.push_back(strFile);
+  }
+
+  // the size the next slide is loaded at
+  int maxWidth, maxHeight;
+  GetCheckedSize((float)g_settings.m_ResInfo[m_Resolution].iWidth * zoomamount[m_iZoomFactor - 1],
+                 (float)g_settings.m_ResInfo[m_Resolution].iHeight * zoomamount[m_iZoomFactor - 1],
+                 maxWidth, maxHeight);
+  m_pBackgroundLoader->Prefetch(files, maxWidth, maxHeight);
+}
+
 EVENT_RESULT CGUIWindowSlideShow::OnMouseEvent(const CPoint &point, const CMouseEvent &event)
 {
   if (event.m_id == ACTION_GESTURE_NOTIFY)
@@ -893,6 +1170,21 @@ void CGUIWindowSlideShow::OnLoadPic(int iPic, int iSlideNumber, CBaseTexture* pT
   }
 }
 
+void CGUIWindowSlideShow::OnUpdatePic(int iPic, int iSlideNumber, CBaseTexture* pTexture, int iOriginalWidth, int iOriginalHeight, bool bFullSize)
+{
+  // replace the preview with the full picture, unless the slide was changed in the meantime
+  CSingleLock lock(m_slideSection);
+  if (!pTexture || iSlideNumber >= m_slides->Size() ||
+      !m_Image[iPic].IsLoaded() || m_Image[iPic].SlideNumber() != iSlideNumber)
+  {
+    delete pTexture;
+    return;
+  }
+  CLog::Log(LOGDEBUG, "Finished background loading %s after its preview", m_slides->Get(iSlideNumber)->GetPath().c_str());
+  m_Image[iPic].UpdateTexture(pTexture);
+  m_Image[iPic].SetOriginalSize(iOriginalWidth, iOriginalHeight, bFullSize);
+}
+
 void CGUIWindowSlideShow::Shuffle()
 {
   m_slides->Randomize();
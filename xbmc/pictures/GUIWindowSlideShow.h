@@ -22,18 +22,103 @@
  */
 
 #include <set>
+#include <vector>
 #include "guilib/GUIWindow.h"
 #include "threads/Thread.h"
 #include "threads/CriticalSection.h"
 #include "threads/Event.h"
+#include "threads/Condition.h"
 #include "SlideShowPicture.h"
 #include "DllImageLib.h"
 #include "SortFileItem.h"
+#include "boost/shared_ptr.hpp"
 
 class CFileItemList;
 
 class CGUIWindowSlideShow;
 
+/*!
+ \brief Decoded pictures of the slides around the current one.
+
+ The pictures are decoded in parallel by CSlideShowPrefetchJob. Only the wanted pictures
+ are kept, so the cache never holds more than the slides around the current one. The
+ jobs of pictures that are dropped before they are decoded are cancelled.
+ */
+class CSlideShowPicCache
+{
+public:
+  ~CSlideShowPicCache();
+
+  /*!
+   \brief Set the pictures that should be cached, dropping all others.
+   \param files the pictures to cache.
+   \param maxWidth the maximal width the pictures are decoded at.
+   \param maxHeight the maximal height the pictures are decoded at.
+   \param added filled with the pictures that need to be decoded.
+   \sa SetJob
+   */
+  void SetWanted(const std::vector<CStdString> &files, int maxWidth, int maxHeight, std::vector<CStdString> &added);
+
+  /*!
+   \brief Remember the job decoding a picture, so that it can be cancelled once the picture is no longer wanted.
+   */
+  void SetJob(const CStdString &file, int maxWidth, int maxHeight, unsigned int jobID);
+
+  /*!
+   \brief Called by the job before it decodes a picture.
+   \return false if the picture is no longer wanted or was claimed by Take, true if it should be decoded.
+   */
+  bool StartDecode(const CStdString &file, int maxWidth, int maxHeight);
+
+  /*!
+   \brief Store a decoded picture. Pictures that are no longer wanted are deleted.
+   \param texture the decoded picture, or NULL if it failed to decode.
+   */
+  void Add(const CStdString &file, int maxWidth, int maxHeight, CBaseTexture *texture, unsigned int originalWidth, unsigned int originalHeight);
+
+  /*!
+   \brief Take a picture out of the cache, waiting for it if it is being decoded right now.
+   A picture whose job hasn't started yet is claimed and its job cancelled, so the caller decodes it itself.
+   \return the picture, or NULL if the caller has to decode it.
+   */
+  CBaseTexture *Take(const CStdString &file, int maxWidth, int maxHeight, unsigned int &originalWidth, unsigned int &originalHeight);
+
+  /*!
+   \brief Drop all pictures and cancel the jobs that are still pending.
+   */
+  void Clear();
+
+private:
+  enum PicState
+  {
+    PIC_QUEUED = 0,
+    PIC_DECODING,
+    PIC_DONE
+  };
+
+  struct CachedPic
+  {
+    CStdString    file;
+    int           maxWidth;
+    int           maxHeight;
+    PicState      state;
+    bool          hasJob;
+    unsigned int  jobID;
+    CBaseTexture *texture;
+    unsigned int  originalWidth;
+    unsigned int  originalHeight;
+  };
+
+  std::vector<CachedPic>::iterator Find(const CStdString &file, int maxWidth, int maxHeight);
+  static void CancelJobs(const std::vector<unsigned int> &jobs);
+
+  std::vector<CachedPic> m_pics;
+  CCriticalSection m_section;
+  XbmcThreads::ConditionVariable m_decoded;
+};
+
+typedef boost::shared_ptr<CSlideShowPicCache> CSlideShowPicCachePtr;
+
 class CBackgroundPicLoader : public CThread
 {
 public:
@@ -41,20 +126,29 @@ public:
   ~CBackgroundPicLoader();
 
   void Create(CGUIWindowSlideShow *pCallback);
-  void LoadPic(int iPic, int iSlideNumber, const CStdString &strFileName, const int maxWidth, const int maxHeight);
+  void LoadPic(int iPic, int iSlideNumber, const CStdString &strFileName, const int maxWidth, const int maxHeight, bool bPreview = false);
+  void Prefetch(const std::vector<CStdString> &files, const int maxWidth, const int maxHeight);
+  void CancelPrefetch();
   bool IsLoading() { return m_isLoading;};
 
+  static CBaseTexture *LoadTexture(const CStdString &strFileName, int maxWidth, int maxHeight, unsigned int &originalWidth, unsigned int &originalHeight);
+
 private:
   void Process();
+  bool IsFullSize(CBaseTexture *texture) const;
+
   int m_iPic;
   int m_iSlideNumber;
   CStdString m_strFileName;
   int m_maxWidth;
   int m_maxHeight;
+  bool m_bPreview;
 
   CEvent m_loadPic;
   bool m_isLoading;
 
+  CSlideShowPicCachePtr m_cache;
+
   CGUIWindowSlideShow *m_pCallback;
 };
 
@@ -89,6 +183,7 @@ public:
   virtual void Process(unsigned int currentTime, CDirtyRegionList &regions);
   virtual void FreeResources();
   void OnLoadPic(int iPic, int iSlideNumber, CBaseTexture* pTexture, int iOriginalWidth, int iOriginalHeight, bool bFullSize);
+  void OnUpdatePic(int iPic, int iSlideNumber, CBaseTexture* pTexture, int iOriginalWidth, int iOriginalHeight, bool bFullSize);
   int NumSlides() const;
   int CurrentSlide() const;
   void Shuffle();
@@ -107,6 +202,7 @@ private:
   void Move(float fX, float fY);
   void GetCheckedSize(float width, float height, int &maxWidth, int &maxHeight);
   int  GetNextSlide();
+  void PrefetchSlides();
 
   int m_iCurrentSlide;
   int m_iNextSlide;
@@ -128,6 +224,7 @@ private:
   int m_iCurrentPic;
   // background loader
   CBackgroundPicLoader* m_pBackgroundLoader;
+  int m_iPrefetchSlide;
   bool m_bWaitForNextPic;
   bool m_bLoadNextPic;
   bool m_bReloadImage;
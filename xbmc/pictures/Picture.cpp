@@ -358,7 +358,9 @@ bool CPicture::OrientateImage(uint32_t *&pixels, unsigned int &width, unsigned i
   if (out)
   {
     pixels = out;
-    std::swap(width, height);
+    // only the transposing orientations swap the dimensions
+    if (orientation >= 4)
+      std::swap(width, height);
     return true;
   }
   return false;
@@ -408,89 +410,50 @@ uint32_t *CPicture::Rotate180CCW(uint32_t *pixels, unsigned int width, unsigned
   return pixels;
 }
 
-uint32_t *CPicture::Rotate90CCW(uint32_t *pixels, unsigned int width, unsigned int height)
+uint32_t *CPicture::TransposeInPlace(uint32_t *pixels, unsigned int width, unsigned int height)
 {
-  uint32_t *dest = new uint32_t[width * height * 4];
-  if (dest)
+  // move the pixels along the cycles of the transposition, so no second full size buffer is needed.
+  // pixel (x, y) moves from y * width + x to x * height + y. visited only needs a bit per pixel.
+  unsigned int size = width * height;
+  std::vector<bool> visited(size, false);
+  for (unsigned int start = 0; start < size; start++)
   {
-    unsigned int d_height = width, d_width = height;
-    for (unsigned int y = 0; y < d_height; y++)
+    if (visited[start])
+      continue;
+
+    uint32_t value = pixels[start];
+    unsigned int pos = start;
+    do
     {
-      const uint32_t *src = pixels + (d_height - 1 - y); // y-th col from right, starting at top
-      uint32_t *dst = dest + d_width * y;                // y-th row from top, starting at left
-      for (unsigned int x = 0; x < d_width; x++)
-      {
-        *dst++ = *src;
-        src += width;
-      }
-    }
+      unsigned int next = (pos % width) * height + pos / width;
+      std::swap(value, pixels[next]);
+      visited[next] = true;
+      pos = next;
+    } while (pos != start);
   }
-  delete[] pixels;
-  return dest;
+  return pixels;
 }
 
-uint32_t *CPicture::Rotate270CCW(uint32_t *pixels, unsigned int width, unsigned int height)
+uint32_t *CPicture::Rotate90CCW(uint32_t *pixels, unsigned int width, unsigned int height)
 {
-  uint32_t *dest = new uint32_t[width * height * 4];
-  if (!dest)
-    return NULL;
-
-  unsigned int d_height = width, d_width = height;
-  for (unsigned int y = 0; y < d_height; y++)
-  {
-    const uint32_t *src = pixels + width * (d_width - 1) + y; // y-th col from left, starting at bottom
-    uint32_t *dst = dest + d_width * y;                       // y-th row from top, starting at left
-    for (unsigned int x = 0; x < d_width; x++)
-    {
-      *dst++ = *src;
-      src -= width;
-    }
-  }
+  // transposing and flipping the rows is the same as rotating, and both can be done in-place
+  TransposeInPlace(pixels, width, height);
+  return FlipVertical(pixels, height, width);
+}
 
-  delete[] pixels;
-  return dest;
+uint32_t *CPicture::Rotate270CCW(uint32_t *pixels, unsigned int width, unsigned int height)
+{
+  TransposeInPlace(pixels, width, height);
+  return FlipHorizontal(pixels, height, width);
 }
 
 uint32_t *CPicture::Transpose(uint32_t *pixels, unsigned int width, unsigned int height)
 {
-  uint32_t *dest = new uint32_t[width * height * 4];
-  if (!dest)
-    return NULL;
-
-  unsigned int d_height = width, d_width = height;
-  for (unsigned int y = 0; y < d_height; y++)
-  {
-    const uint32_t *src = pixels + y;   // y-th col from left, starting at top
-    uint32_t *dst = dest + d_width * y; // y-th row from top, starting at left
-    for (unsigned int x = 0; x < d_width; x++)
-    {
-      *dst++ = *src;
-      src += width;
-    }
-  }
-
-  delete[] pixels;
-  return dest;
+  return TransposeInPlace(pixels, width, height);
 }
 
 uint32_t *CPicture::TransposeOffAxis(uint32_t *pixels, unsigned int width, unsigned int height)
 {
-  uint32_t *dest = new uint32_t[width * height * 4];
-  if (!dest)
-    return NULL;
-
-  unsigned int d_height = width, d_width = height;
-  for (unsigned int y = 0; y < d_height; y++)
-  {
-    const uint32_t *src = pixels + width * (d_width - 1) + (d_height - 1 - y); // y-th col from right, starting at bottom
-    uint32_t *dst = dest + d_width * y;                                        // y-th row, starting at left
-    for (unsigned int x = 0; x < d_width; x++)
-    {
-      *dst++ = *src;
-      src -= width;
-    }
-  }
-
-  delete[] pixels;
-  return dest;
+  TransposeInPlace(pixels, width, height);
+  return Rotate180CCW(pixels, height, width);
 }
@@ -66,6 +66,7 @@ private:
   static uint32_t *Rotate180CCW(uint32_t *pixels, unsigned int width, unsigned int height);
   static uint32_t *Transpose(uint32_t *pixels, unsigned int width, unsigned int height);
   static uint32_t *TransposeOffAxis(uint32_t *pixels, unsigned int width, unsigned int height);
+  static uint32_t *TransposeInPlace(uint32_t *pixels, unsigned int width, unsigned int height);
 };
 
 //this class calls CreateThumbnailFromSurface in a CJob, so a png file can be written without halting the render thread
@@ -29,6 +29,8 @@
 #include "channels/PVRChannelGroupsContainer.h"
 #include "addons/PVRClient.h"
 
+#include <set>
+
 using namespace std;
 using namespace dbiplus;
 using namespace PVR;
@@ -370,7 +372,7 @@ int CPVRDatabase::Get(CPVRChannelGroupInternal &results)
 
         CLog::Log(LOGDEBUG, "PVR - %s - channel '%s' loaded from the database", __FUNCTION__, channel->m_strChannelName.c_str());
         PVRChannelGroupMember newMember = { channel, m_pDS->fv("iChannelNumber").get_asInt() };
-        results.push_back(newMember);
+        results.AddMember(newMember);
 
         m_pDS->next();
         ++iReturn;
@@ -509,7 +511,7 @@ bool CPVRDatabase::RemoveChannelsFromGroup(const CPVRChannelGroup &group)
   return DeleteValues("map_channelgroups_channels", strWhereClause);
 }
 
-bool CPVRDatabase::GetCurrentGroupMembers(const CPVRChannelGroup &group, vector<int> &members)
+bool CPVRDatabase::GetCurrentGroupMembers(const CPVRChannelGroup &group, map<int, int> &members)
 {
   bool bReturn(false);
   /* invalid group id */
@@ -519,14 +521,14 @@ bool CPVRDatabase::GetCurrentGroupMembers(const CPVRChannelGroup &group, vector<
     return false;
   }
 
-  CStdString strCurrentMembersQuery = FormatSQL("SELECT idChannel FROM map_channelgroups_channels WHERE idGroup = %u", group.GroupID());
+  CStdString strCurrentMembersQuery = FormatSQL("SELECT idChannel, iChannelNumber FROM map_channelgroups_channels WHERE idGroup = %u", group.GroupID());
   if (ResultQuery(strCurrentMembersQuery))
   {
     try
     {
       while (!m_pDS->eof())
       {
-        members.push_back(m_pDS->fv("idChannel").get_asInt());
+        members[m_pDS->fv("idChannel").get_asInt()] = m_pDS->fv("iChannelNumber").get_asInt();
         m_pDS->next();
       }
       m_pDS->close();
@@ -591,7 +593,7 @@ bool CPVRDatabase::DeleteChannelsFromGroup(const CPVRChannelGroup &group, const
   return bDelete;
 }
 
-bool CPVRDatabase::RemoveStaleChannelsFromGroup(const CPVRChannelGroup &group)
+bool CPVRDatabase::RemoveStaleChannelsFromGroup(const CPVRChannelGroup &group, const map<int, int> &currentMembers)
 {
   bool bDelete(true);
   /* invalid group id */
@@ -610,18 +612,21 @@ bool CPVRDatabase::RemoveStaleChannelsFromGroup(const CPVRChannelGroup &group)
 
   if (group.size() > 0)
   {
-    vector<int> currentMembers;
-    if (GetCurrentGroupMembers(group, currentMembers))
+    set<int> groupMembers;
     {
-      vector<int> channelsToDelete;
-      for (unsigned int iChannelPtr = 0; iChannelPtr < currentMembers.size(); iChannelPtr++)
-      {
-        if (!group.IsGroupMember(currentMembers.at(iChannelPtr)))
-          channelsToDelete.push_back(currentMembers.at(iChannelPtr));
-      }
+      CSingleLock lock(group.m_critSection);
+      for (unsigned int iChannelPtr = 0; iChannelPtr < group.size(); iChannelPtr++)
+        groupMembers.insert(group.at(iChannelPtr).channel->ChannelID());
+    }
 
-      bDelete = DeleteChannelsFromGroup(group, channelsToDelete) && bDelete;
+    vector<int> channelsToDelete;
+    for (map<int, int>::const_iterator it = currentMembers.begin(); it != currentMembers.end(); it++)
+    {
+      if (groupMembers.find(it->first) == groupMembers.end())
+        channelsToDelete.push_back(it->first);
     }
+
+    bDelete = DeleteChannelsFromGroup(group, channelsToDelete) && bDelete;
   }
   else
   {
@@ -737,6 +742,7 @@ bool CPVRDatabase::PersistChannels(CPVRChannelGroup &group)
   if (m_sqlite)
     iLastChannel = GetLastChannelId();
 
+  vector<CPVRChannel *> persistedChannels;
   for (unsigned int iChannelPtr = 0; iChannelPtr < group.size(); iChannelPtr++)
   {
     PVRChannelGroupMember member = group.at(iChannelPtr);
@@ -745,9 +751,29 @@ bool CPVRDatabase::PersistChannels(CPVRChannelGroup &group)
       if (m_sqlite && member.channel->IsNew())
         member.channel->SetChannelID(++iLastChannel, false);
       bReturn &= Persist(*member.channel, m_sqlite || !member.channel->IsNew());
+      persistedChannels.push_back(member.channel);
+    }
+  }
+
+  if (persistedChannels.empty())
+    return bReturn;
+
+  CLog::Log(LOGDEBUG, "PVR - %s - persisting %u changed channels of group '%s'",
+      __FUNCTION__, (unsigned int) persistedChannels.size(), group.GroupName().c_str());
+
+  bReturn = CommitInsertQueries() && bReturn;
+
+  /* the changes are stored now, so they don't have to be written again with the next change */
+  if (bReturn)
+  {
+    for (unsigned int iChannelPtr = 0; iChannelPtr < persistedChannels.size(); iChannelPtr++)
+    {
+      CSingleLock lock(persistedChannels.at(iChannelPtr)->m_critSection);
+      persistedChannels.at(iChannelPtr)->m_bChanged = false;
     }
   }
-  return CommitInsertQueries();
+
+  return bReturn;
 }
 
 bool CPVRDatabase::PersistGroupMembers(CPVRChannelGroup &group)
@@ -759,27 +785,35 @@ bool CPVRDatabase::PersistGroupMembers(CPVRChannelGroup &group)
 
   if (group.size() > 0)
   {
+    /* get all stored members at once, so only new and renumbered members have to be written */
+    map<int, int> currentMembers;
+    GetCurrentGroupMembers(group, currentMembers);
+
+    unsigned int iChangedMembers(0);
     for (unsigned int iChannelPtr = 0; iChannelPtr < group.size(); iChannelPtr++)
     {
       PVRChannelGroupMember member = group.at(iChannelPtr);
 
-      CStdString strWhereClause = FormatSQL("idChannel = %u AND idGroup = %u AND iChannelNumber = %u",
-          member.channel->ChannelID(), group.GroupID(), member.iChannelNumber);
-
-      CStdString strValue = GetSingleValue("map_channelgroups_channels", "idChannel", strWhereClause);
-      if (strValue.IsEmpty())
+      map<int, int>::const_iterator it = currentMembers.find(member.channel->ChannelID());
+      if (it == currentMembers.end() || it->second != (int) member.iChannelNumber)
       {
         strQuery = FormatSQL("REPLACE INTO map_channelgroups_channels ("
             "idGroup, idChannel, iChannelNumber) "
             "VALUES (%i, %i, %i);",
             group.GroupID(), member.channel->ChannelID(), member.iChannelNumber);
         QueueInsertQuery(strQuery);
+        iChangedMembers++;
       }
     }
     lock.Leave();
 
-    bReturn = CommitInsertQueries();
-    bRemoveChannels = RemoveStaleChannelsFromGroup(group);
+    if (iChangedMembers > 0)
+    {
+      CLog::Log(LOGDEBUG, "PVR - %s - persisting %u changed members of group '%s'",
+          __FUNCTION__, iChangedMembers, group.GroupName().c_str());
+      bReturn = CommitInsertQueries();
+    }
+    bRemoveChannels = RemoveStaleChannelsFromGroup(group, currentMembers);
   }
 
   return bReturn && bRemoveChannels;
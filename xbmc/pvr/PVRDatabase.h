@@ -28,6 +28,8 @@
 #include "XBDateTime.h"
 #include "utils/log.h"
 
+#include <map>
+
 class CVideoSettings;
 
 namespace PVR
@@ -222,9 +224,9 @@ namespace PVR
      */
     int GetClientId(const CStdString &strClientUid);
 
-    bool GetCurrentGroupMembers(const CPVRChannelGroup &group, std::vector<int> &members);
+    bool GetCurrentGroupMembers(const CPVRChannelGroup &group, std::map<int, int> &members);
     int GetLastChannelId(void);
-    bool RemoveStaleChannelsFromGroup(const CPVRChannelGroup &group);
+    bool RemoveStaleChannelsFromGroup(const CPVRChannelGroup &group, const std::map<int, int> &currentMembers);
 
     /*!
      * @brief Update an old version of the database.
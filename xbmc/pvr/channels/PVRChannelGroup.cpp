@@ -106,7 +106,7 @@ CPVRChannelGroup::CPVRChannelGroup(const CPVRChannelGroup &group)
   m_bUsingBackendChannelNumbers = group.m_bUsingBackendChannelNumbers;
 
   for (int iPtr = 0; iPtr < group.Size(); iPtr++)
-    push_back(group.at(iPtr));
+    AddMember(group.at(iPtr));
 }
 
 int CPVRChannelGroup::Load(void)
@@ -140,7 +140,45 @@ int CPVRChannelGroup::Load(void)
 void CPVRChannelGroup::Unload(void)
 {
   g_guiSettings.UnregisterObserver(this);
+  CSingleLock lock(m_critSection);
   clear();
+  m_clientIndex.clear();
+}
+
+void CPVRChannelGroup::AddMember(const PVRChannelGroupMember &member)
+{
+  CSingleLock lock(m_critSection);
+  push_back(member);
+  if (member.channel)
+    m_clientIndex[PVRChannelClientKey(member.channel->ClientID(), member.channel->UniqueID())] = member.channel;
+}
+
+void CPVRChannelGroup::RemoveMember(unsigned int iIndex)
+{
+  CSingleLock lock(m_critSection);
+  if (iIndex >= size())
+    return;
+
+  CPVRChannel *channel = at(iIndex).channel;
+  if (channel)
+  {
+    std::map<PVRChannelClientKey, CPVRChannel *>::iterator it = m_clientIndex.find(PVRChannelClientKey(channel->ClientID(), channel->UniqueID()));
+    if (it != m_clientIndex.end() && it->second == channel)
+      m_clientIndex.erase(it);
+  }
+  erase(begin() + iIndex);
+}
+
+void CPVRChannelGroup::ReindexMember(CPVRChannel &channel, int iOldUniqueId, int iOldClientId)
+{
+  CSingleLock lock(m_critSection);
+  std::map<PVRChannelClientKey, CPVRChannel *>::iterator it = m_clientIndex.find(PVRChannelClientKey(iOldClientId, iOldUniqueId));
+  /* not a member of this group */
+  if (it == m_clientIndex.end() || it->second != &channel)
+    return;
+
+  m_clientIndex.erase(it);
+  m_clientIndex[PVRChannelClientKey(channel.ClientID(), channel.UniqueID())] = &channel;
 }
 
 bool CPVRChannelGroup::Update(void)
@@ -293,21 +331,10 @@ void CPVRChannelGroup::SortByChannelNumber(void)
 
 CPVRChannel *CPVRChannelGroup::GetByClient(int iUniqueChannelId, int iClientID) const
 {
-  CPVRChannel *channel = NULL;
   CSingleLock lock(m_critSection);
+  std::map<PVRChannelClientKey, CPVRChannel *>::const_iterator it = m_clientIndex.find(PVRChannelClientKey(iClientID, iUniqueChannelId));
 
-  for (unsigned int ptr = 0; ptr < size(); ptr++)
-  {
-    PVRChannelGroupMember groupMember = at(ptr);
-    if (groupMember.channel->UniqueID() == iUniqueChannelId &&
-        groupMember.channel->ClientID() == iClientID)
-    {
-      channel = groupMember.channel;
-      break;
-    }
-  }
-
-  return channel;
+  return it != m_clientIndex.end() ? it->second : NULL;
 }
 
 CPVRChannel *CPVRChannelGroup::GetByChannelID(int iChannelID) const
@@ -611,7 +638,7 @@ bool CPVRChannelGroup::RemoveDeletedChannels(const CPVRChannelGroup &channels)
         channel->Delete();
       }
 
-      erase(begin() + iChannelPtr);
+      RemoveMember(iChannelPtr);
       m_bChanged = true;
       bReturn = true;
     }
@@ -695,7 +722,7 @@ void CPVRChannelGroup::RemoveInvalidChannels(void)
       }
       else
       {
-        erase(begin() + ptr);
+        RemoveMember(ptr);
       }
       m_bChanged = true;
     }
@@ -712,7 +739,7 @@ bool CPVRChannelGroup::RemoveFromGroup(const CPVRChannel &channel)
     if (channel == *at(iChannelPtr).channel)
     {
       // TODO notify observers
-      erase(begin() + iChannelPtr);
+      RemoveMember(iChannelPtr);
       bReturn = true;
       m_bChanged = true;
       break;
@@ -742,7 +769,7 @@ bool CPVRChannelGroup::AddToGroup(CPVRChannel &channel, int iChannelNumber /* =
     if (realChannel)
     {
       PVRChannelGroupMember newMember = { realChannel, iChannelNumber };
-      push_back(newMember);
+      AddMember(newMember);
       m_bChanged = true;
 
       if (bSortAndRenumber)
@@ -764,19 +791,8 @@ bool CPVRChannelGroup::AddToGroup(CPVRChannel &channel, int iChannelNumber /* =
 
 bool CPVRChannelGroup::IsGroupMember(const CPVRChannel &channel) const
 {
-  bool bReturn(false);
-  CSingleLock lock(m_critSection);
-
-  for (unsigned int iChannelPtr = 0; iChannelPtr < size(); iChannelPtr++)
-  {
-    if (channel == *at(iChannelPtr).channel)
-    {
-      bReturn = true;
-      break;
-    }
-  }
-
-  return bReturn;
+  CPVRChannel *member = GetByClient(channel.UniqueID(), channel.ClientID());
+  return member && channel == *member;
 }
 
 bool CPVRChannelGroup::IsGroupMember(int iChannelId) const
@@ -25,6 +25,8 @@
 #include "PVRChannel.h"
 #include "utils/JobManager.h"
 
+#include <map>
+
 namespace EPG
 {
   struct EpgSearchFilter;
@@ -441,6 +443,29 @@ namespace PVR
      */
     virtual CPVRChannel *GetByChannelUpDown(const CPVRChannel &channel, bool bChannelUp) const;
 
+    /*!
+     * @brief Add a member to this group and to the client channel index.
+     * @param member The member to add.
+     */
+    void AddMember(const PVRChannelGroupMember &member);
+
+    /*!
+     * @brief Remove a member from this group and from the client channel index.
+     * @param iIndex The index of the member in this container.
+     */
+    void RemoveMember(unsigned int iIndex);
+
+    /*!
+     * @brief Update the client channel index after the client or unique ID of a member changed.
+     * Does nothing if the channel isn't a member of this group.
+     * @param channel The channel that changed.
+     * @param iOldUniqueId The unique ID the channel was indexed with.
+     * @param iOldClientId The client ID the channel was indexed with.
+     */
+    void ReindexMember(CPVRChannel &channel, int iOldUniqueId, int iOldClientId);
+
+    typedef std::pair<int, int> PVRChannelClientKey; /*!< client ID, unique channel ID */
+
     bool             m_bRadio;                      /*!< true if this container holds radio channels, false if it holds TV channels */
     int              m_iGroupType;                  /*!< The type of this group */
     int              m_iGroupId;                    /*!< The ID of this group in the database */
@@ -449,6 +474,7 @@ namespace PVR
     bool             m_bChanged;                    /*!< true if anything changed in this group that hasn't been persisted, false otherwise */
     bool             m_bUsingBackendChannelOrder;   /*!< true to use the channel order from backends, false otherwise */
     bool             m_bUsingBackendChannelNumbers; /*!< true to use the channel numbers from 1 backend, false otherwise */
+    std::map<PVRChannelClientKey, CPVRChannel *> m_clientIndex; /*!< the members of this group by client ID and unique channel ID */
     CCriticalSection m_critSection;
   };
 
@@ -301,17 +301,38 @@ bool CPVRChannelGroupInternal::UpdateChannel(const CPVRChannel &channel)
 {
   CSingleLock lock(m_critSection);
   CPVRChannel *updateChannel = (CPVRChannel *) GetByUniqueID(channel.UniqueID());
+  int iOldClientId(-1);
+  bool bReindex(false);
 
   if (!updateChannel)
   {
     updateChannel = new CPVRChannel(channel.IsRadio());
-    PVRChannelGroupMember newMember = { updateChannel, 0 };
-    push_back(newMember);
     updateChannel->SetUniqueID(channel.UniqueID());
+    updateChannel->UpdateFromClient(channel);
+
+    PVRChannelGroupMember newMember = { updateChannel, 0 };
+    AddMember(newMember);
+  }
+  else
+  {
+    iOldClientId = updateChannel->ClientID();
+    updateChannel->UpdateFromClient(channel);
+    if (updateChannel->ClientID() != iOldClientId)
+    {
+      ReindexMember(*updateChannel, updateChannel->UniqueID(), iOldClientId);
+      bReindex = true;
+    }
   }
-  updateChannel->UpdateFromClient(channel);
 
-  return updateChannel->Persist(!m_bLoaded);
+  bool bReturn = updateChannel->Persist(!m_bLoaded);
+  lock.Leave();
+
+  /* the other groups containing this channel index it by client too. done without
+     holding our lock, the groups container locks itself before its groups */
+  if (bReindex)
+    g_PVRChannelGroups->Get(m_bRadio)->ReindexMember(*updateChannel, updateChannel->UniqueID(), iOldClientId);
+
+  return bReturn;
 }
 
 bool CPVRChannelGroupInternal::AddAndUpdateChannels(const CPVRChannelGroup &channels, bool bUseBackendChannelNumbers)
@@ -330,11 +351,10 @@ bool CPVRChannelGroupInternal::AddAndUpdateChannels(const CPVRChannelGroup &chan
     CPVRChannel *existingChannel = (CPVRChannel *) GetByClient(member.channel->UniqueID(), member.channel->ClientID());
     if (existingChannel)
     {
-      /* if it's present, update the current tag */
+      /* if it's present, update the current tag. it's persisted together
+         with the other changes when the group is persisted */
       if (existingChannel->UpdateFromClient(*member.channel))
       {
-        existingChannel->Persist(!m_bLoaded);
-
         bReturn = true;
         CLog::Log(LOGINFO,"PVRChannelGroupInternal - %s - updated %s channel '%s'",
             __FUNCTION__, m_bRadio ? "radio" : "TV", member.channel->ChannelName().c_str());
@@ -193,6 +193,13 @@ void CPVRChannelGroups::RemoveFromAllGroups(CPVRChannel *channel)
   }
 }
 
+void CPVRChannelGroups::ReindexMember(CPVRChannel &channel, int iOldUniqueId, int iOldClientId)
+{
+  CSingleLock lock(m_critSection);
+  for (unsigned int iGroupPtr = 0; iGroupPtr < size(); iGroupPtr++)
+    at(iGroupPtr)->ReindexMember(channel, iOldUniqueId, iOldClientId);
+}
+
 bool CPVRChannelGroups::Update(bool bChannelsOnly /* = false */)
 {
   bool bReturn = true;
@@ -175,6 +175,14 @@ namespace PVR
      */
     void RemoveFromAllGroups(CPVRChannel *channel);
 
+    /*!
+     * @brief Update the client channel index of all groups containing a channel, after its client or unique ID changed.
+     * @param channel The channel that changed.
+     * @param iOldUniqueId The unique ID the channel was indexed with.
+     * @param iOldClientId The client ID the channel was indexed with.
+     */
+    void ReindexMember(CPVRChannel &channel, int iOldUniqueId, int iOldClientId);
+
     /*!
      * @brief Persist all changes in channel groups.
      * @return True if everything was persisted, false otherwise.
@@ -35,6 +35,7 @@
 #include "utils/URIUtils.h"
 #include "utils/XMLUtils.h"
 #include "utils/log.h"
+#include "threads/LockProfiler.h"
 #include "filesystem/SpecialProtocol.h"
 
 using namespace XFILE;
@@ -56,6 +57,9 @@ void CAdvancedSettings::Initialize()
   m_audioAudiophile = false;
   m_allChannelStereo = false;
   m_audioSinkBufferDurationMsec = 50;
+  m_audioPreloadTimeMsec = 5000;
+  m_audioDecodeBufferMsec = 5000;
+  m_audioDecodeBufferMaxKB = 8192;
 
   //default hold time of 25 ms, this allows a 20 hertz sine to pass undistorted
   m_limiterHold = 0.025f;
@@ -253,6 +257,7 @@ void CAdvancedSettings::Initialize()
   m_curlconnecttimeout = 10;
   m_curllowspeedtime = 20;
   m_curlretries = 2;
+  m_curlmaxhostconnections = 8;
   m_curlDisableIPV6 = false;      //Certain hardware/OS combinations have trouble
                                   //with ipv6.
 
@@ -304,6 +309,12 @@ void CAdvancedSettings::Initialize()
   m_jsonOutputCompact = true;
   m_jsonTcpPort = 9090;
 
+  m_pythonPoolSize = 0;
+  m_pythonPoolWatchdog = 120;
+
+  m_iListingCacheTTL = 0;
+  m_iListingCacheStaleTime = 86400;
+
   m_enableMultimediaKeys = false;
 
   m_canWindowed = true;
@@ -311,6 +322,7 @@ void CAdvancedSettings::Initialize()
   m_guiAlgorithmDirtyRegions = 0;
   m_guiDirtyRegionNoFlipTimeout = -1;
   m_logEnableAirtunes = false;
+  m_lockProfiling = false;
   m_airTunesPort = 36666;
   m_airPlayPort = 36667;
   m_initialized = true;
@@ -388,6 +400,9 @@ void CAdvancedSettings::ParseSettingsFile(const CStdString &file)
     XMLUtils::GetBoolean(pElement, "allchannelstereo", m_allChannelStereo);
     XMLUtils::GetString(pElement, "transcodeto", m_audioTranscodeTo);
     XMLUtils::GetInt(pElement, "audiosinkbufferdurationmsec", m_audioSinkBufferDurationMsec);
+    XMLUtils::GetInt(pElement, "preloadtimemsec", m_audioPreloadTimeMsec, 0, 60000);
+    XMLUtils::GetInt(pElement, "decodebuffermsec", m_audioDecodeBufferMsec, 500, 60000);
+    XMLUtils::GetInt(pElement, "decodebuffermaxkb", m_audioDecodeBufferMaxKB, 256, 262144);
 
     TiXmlElement* pAudioExcludes = pElement->FirstChildElement("excludefromlisting");
     if (pAudioExcludes)
@@ -676,6 +691,7 @@ void CAdvancedSettings::ParseSettingsFile(const CStdString &file)
     XMLUtils::GetInt(pElement, "curlclienttimeout", m_curlconnecttimeout, 1, 1000);
     XMLUtils::GetInt(pElement, "curllowspeedtime", m_curllowspeedtime, 1, 1000);
     XMLUtils::GetInt(pElement, "curlretries", m_curlretries, 0, 10);
+    XMLUtils::GetInt(pElement, "curlmaxhostconnections", m_curlmaxhostconnections, 1, 64);
     XMLUtils::GetBoolean(pElement,"disableipv6", m_curlDisableIPV6);
     XMLUtils::GetUInt(pElement, "cachemembuffersize", m_cacheMemBufferSize);
   }
@@ -687,6 +703,24 @@ void CAdvancedSettings::ParseSettingsFile(const CStdString &file)
     XMLUtils::GetUInt(pElement, "tcpport", m_jsonTcpPort);
   }
 
+  // idle plugin interpreters kept around for the next listing (0 disables)
+  // and the time in seconds after which a pooled plugin is stopped
+  pElement = pRootElement->FirstChildElement("pythonpool");
+  if (pElement)
+  {
+    XMLUtils::GetInt(pElement, "size", m_pythonPoolSize, 0, 16);
+    XMLUtils::GetInt(pElement, "watchdog", m_pythonPoolWatchdog, 0, 3600);
+  }
+
+  // listings of slow sources are kept on disk and used as is for ttl seconds
+  // (0, the default, disables), then for staletime seconds more while being refreshed
+  pElement = pRootElement->FirstChildElement("listingcache");
+  if (pElement)
+  {
+    XMLUtils::GetInt(pElement, "ttl", m_iListingCacheTTL, 0, 604800);
+    XMLUtils::GetInt(pElement, "staletime", m_iListingCacheStaleTime, 0, 2592000);
+  }
+
   pElement = pRootElement->FirstChildElement("samba");
   if (pElement)
   {
@@ -723,6 +757,10 @@ void CAdvancedSettings::ParseSettingsFile(const CStdString &file)
      
   XMLUtils::GetString(pRootElement, "cddbaddress", m_cddbAddress);
 
+  // lock contention profiling, dumped to the log on exit
+  XMLUtils::GetBoolean(pRootElement, "lockprofiling", m_lockProfiling);
+  XbmcThreads::LockProfiler::Enable(m_lockProfiling);
+
   //airtunes + airplay
   XMLUtils::GetBoolean(pRootElement, "enableairtunesdebuglog", m_logEnableAirtunes);
   XMLUtils::GetInt(pRootElement,     "airtunesport", m_airTunesPort);
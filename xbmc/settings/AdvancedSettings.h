@@ -101,6 +101,9 @@ class CAdvancedSettings
     bool m_audioAudiophile;
     bool m_allChannelStereo;
     int m_audioSinkBufferDurationMsec;
+    int m_audioPreloadTimeMsec;
+    int m_audioDecodeBufferMsec;
+    int m_audioDecodeBufferMaxKB;
     CStdString m_audioTranscodeTo;
     float m_limiterHold;
     float m_limiterRelease;
@@ -172,6 +175,7 @@ class CAdvancedSettings
     int m_busyDialogDelay;
     int m_logLevel;
     int m_logLevelHint;
+    bool m_lockProfiling;
     CStdString m_cddbAddress;
     
     //airtunes + airplay
@@ -282,6 +286,7 @@ class CAdvancedSettings
     int m_curllowspeedtime;
     int m_curlretries;
     bool m_curlDisableIPV6;
+    int m_curlmaxhostconnections;
 
     bool m_fullScreen;
     bool m_startFullScreen;
@@ -341,6 +346,12 @@ class CAdvancedSettings
     bool m_jsonOutputCompact;
     unsigned int m_jsonTcpPort;
 
+    int m_pythonPoolSize;
+    int m_pythonPoolWatchdog;
+
+    int m_iListingCacheTTL;
+    int m_iListingCacheStaleTime;
+
     bool m_enableMultimediaKeys;
     std::vector<CStdString> m_settingsFiles;
     void ParseSettingsFile(const CStdString &file);
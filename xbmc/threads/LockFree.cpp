@@ -273,6 +273,60 @@ void* lf_queue_dequeue(lf_queue* pQueue)
   return pVal;
 }
 
+///////////////////////////////////////////////////////////////////////////
+// Intrusive multi-producer/single-consumer queue
+// Producers swing head over to their node and then link the previous head
+// to it. Between those two steps the consumer sees a broken chain and
+// reports the queue as empty; the node is picked up on the next pop.
+///////////////////////////////////////////////////////////////////////////
+void lf_mpsc_init(lf_mpsc_queue* pQueue)
+{
+  pQueue->stub.next = NULL;
+  pQueue->head = &pQueue->stub;
+  pQueue->tail = &pQueue->stub;
+}
+
+void lf_mpsc_push(lf_mpsc_queue* pQueue, lf_mpsc_node* pNode)
+{
+  pNode->next = NULL;
+  lf_mpsc_node* prev;
+  do
+  {
+    prev = pQueue->head;
+  } while (cas((long*)&pQueue->head, (long)prev, (long)pNode) != (long)prev);
+  prev->next = pNode; // Link it in - the consumer can see it from now on
+}
+
+lf_mpsc_node* lf_mpsc_pop(lf_mpsc_queue* pQueue)
+{
+  lf_mpsc_node* tail = pQueue->tail;
+  lf_mpsc_node* next = tail->next;
+  if (tail == &pQueue->stub) // Skip over the stub
+  {
+    if (next == NULL)
+      return NULL; // Empty
+    pQueue->tail = next;
+    tail = next;
+    next = next->next;
+  }
+  if (next)
+  {
+    pQueue->tail = next;
+    return tail;
+  }
+  if (tail != pQueue->head)
+    return NULL; // A push is half way through
+  // tail is the last node - put the stub back behind it so we can take it
+  lf_mpsc_push(pQueue, &pQueue->stub);
+  next = tail->next;
+  if (next)
+  {
+    pQueue->tail = next;
+    return tail;
+  }
+  return NULL;
+}
+
 #ifdef __ppc__
 #pragma GCC optimization_level reset
 #endif
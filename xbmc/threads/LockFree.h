@@ -122,4 +122,26 @@ void lf_queue_deinit(lf_queue* pQueue);
 void lf_queue_enqueue(lf_queue* pQueue, void* pVal);
 void* lf_queue_dequeue(lf_queue* pQueue);
 
+///////////////////////////////////////////////////////////////////////////
+// Intrusive multi-producer/single-consumer queue
+// Only needs a single word cas, so it is lock-free everywhere (cas2 is
+// not available on x86_64). Any thread may push, but only one thread at a
+// time may pop. Nodes are owned by the caller.
+///////////////////////////////////////////////////////////////////////////
+struct lf_mpsc_node
+{
+  lf_mpsc_node* volatile next;
+};
+
+struct lf_mpsc_queue
+{
+  lf_mpsc_node* volatile head; // producers push here
+  lf_mpsc_node* tail;          // consumer pops from here
+  lf_mpsc_node stub;
+};
+
+void lf_mpsc_init(lf_mpsc_queue* pQueue);
+void lf_mpsc_push(lf_mpsc_queue* pQueue, lf_mpsc_node* pNode);
+lf_mpsc_node* lf_mpsc_pop(lf_mpsc_queue* pQueue);
+
 #endif
@@ -0,0 +1,225 @@
+/*
+ *      Copyright (C) 2012 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+ *  http://www.gnu.org/copyleft/gpl.html
+ *
+ */
+
+
+#include "threads/LockProfiler.h"
+#include "threads/CriticalSection.h"
+#include "threads/Thread.h"
+#include "commons/ilog.h"
+
+#include <algorithm>
+#include <map>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#pragma intrinsic(_ReturnAddress)
+#endif
+
+#if (defined TARGET_WINDOWS)
+#include <windows.h>
+#elif (defined TARGET_DARWIN)
+#include <sys/time.h>
+#else
+#include <time.h>
+#endif
+
+namespace XbmcThreads
+{
+  volatile bool LockProfiler::enabled = false;
+
+  namespace
+  {
+    struct SiteStats
+    {
+      unsigned int count;
+      uint64_t waitMicros;
+      SiteStats() : count(0), waitMicros(0) {}
+    };
+
+    typedef std::map<const void*, SiteStats> SiteMap;
+
+    struct Entry
+    {
+      unsigned int contentions;
+      uint64_t waitMicros;
+      uint64_t maxWaitMicros;
+      SiteMap holders;
+      SiteMap waiters;
+      Entry() : contentions(0), waitMicros(0), maxWaitMicros(0) {}
+    };
+
+    typedef std::map<const void*, Entry> EntryMap;
+
+    // the profiler can't use a profiled lock itself, so it only ever
+    // uses the native mutex underneath this critical section
+    CCriticalSection& GetSection()
+    {
+      static CCriticalSection section;
+      return section;
+    }
+
+    EntryMap& GetEntries()
+    {
+      static EntryMap entries;
+      return entries;
+    }
+
+    class NativeLock
+    {
+    public:
+      NativeLock() { GetSection().get_underlying().lock(); }
+      ~NativeLock() { GetSection().get_underlying().unlock(); }
+    };
+
+    void AddSite(SiteMap& sites, const void* address, uint64_t wait)
+    {
+      SiteStats& site = sites[address];
+      site.count++;
+      site.waitMicros += wait;
+    }
+
+    bool SortSites(const LockProfiler::CallSite& a, const LockProfiler::CallSite& b)
+    {
+      return a.waitMicros > b.waitMicros;
+    }
+
+    bool SortLocks(const LockProfiler::LockStats& a, const LockProfiler::LockStats& b)
+    {
+      return a.waitMicros > b.waitMicros;
+    }
+
+    void CopySites(const SiteMap& sites, std::vector<LockProfiler::CallSite>& out)
+    {
+      for (SiteMap::const_iterator it = sites.begin(); it != sites.end(); ++it)
+      {
+        LockProfiler::CallSite site;
+        site.address = it->first;
+        site.count = it->second.count;
+        site.waitMicros = it->second.waitMicros;
+        out.push_back(site);
+      }
+      std::sort(out.begin(), out.end(), SortSites);
+    }
+  }
+
+  void LockProfiler::Enable(bool enable)
+  {
+    if (enable)
+    { // make sure the statics exist before the first lock records into them
+      NativeLock lock;
+      GetEntries();
+    }
+    enabled = enable;
+  }
+
+  void LockProfiler::Reset()
+  {
+    NativeLock lock;
+    GetEntries().clear();
+  }
+
+  uint64_t LockProfiler::Now()
+  {
+#if (defined TARGET_WINDOWS)
+    static LARGE_INTEGER frequency = { 0 };
+    if (!frequency.QuadPart)
+      QueryPerformanceFrequency(&frequency);
+    LARGE_INTEGER now;
+    QueryPerformanceCounter(&now);
+    return (uint64_t)(now.QuadPart * 1000000 / frequency.QuadPart);
+#elif (defined TARGET_DARWIN)
+    struct timeval now;
+    gettimeofday(&now, NULL);
+    return (uint64_t)now.tv_sec * 1000000 + now.tv_usec;
+#else
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t)now.tv_sec * 1000000 + now.tv_nsec / 1000;
+#endif
+  }
+
+  const void* LockProfiler::GetCallSite()
+  {
+#ifdef _MSC_VER
+    return _ReturnAddress();
+#else
+    return __builtin_return_address(0);
+#endif
+  }
+
+  void LockProfiler::RecordWait(const void* lock, const void* holder, const void* waiter, uint64_t start)
+  {
+    uint64_t wait = Now() - start;
+
+    NativeLock guard;
+    Entry& entry = GetEntries()[lock];
+    entry.contentions++;
+    entry.waitMicros += wait;
+    entry.maxWaitMicros = std::max(entry.maxWaitMicros, wait);
+    AddSite(entry.holders, holder, wait);
+    AddSite(entry.waiters, waiter, wait);
+  }
+
+  void LockProfiler::GetStats(std::vector<LockStats>& stats)
+  {
+    stats.clear();
+
+    NativeLock guard;
+    const EntryMap& entries = GetEntries();
+    for (EntryMap::const_iterator it = entries.begin(); it != entries.end(); ++it)
+    {
+      LockStats lock;
+      lock.lock = it->first;
+      lock.contentions = it->second.contentions;
+      lock.waitMicros = it->second.waitMicros;
+      lock.maxWaitMicros = it->second.maxWaitMicros;
+      CopySites(it->second.holders, lock.holders);
+      CopySites(it->second.waiters, lock.waiters);
+      stats.push_back(lock);
+    }
+    std::sort(stats.begin(), stats.end(), SortLocks);
+  }
+
+  void LockProfiler::Dump(unsigned int maxLocks, XbmcCommons::ILogger* logger)
+  {
+    if (!logger)
+      logger = CThread::GetLogger();
+    if (!logger)
+      return;
+
+    std::vector<LockStats> stats;
+    GetStats(stats);
+
+    logger->Log(LOGNOTICE, "LockProfiler: %u contended locks", (unsigned int)stats.size());
+    for (unsigned int i = 0; i < stats.size() && i < maxLocks; i++)
+    {
+      const LockStats& lock = stats[i];
+      logger->Log(LOGNOTICE, "LockProfiler: lock %p waited %u times, %llu us total, %llu us max",
+                  lock.lock, lock.contentions, (unsigned long long)lock.waitMicros, (unsigned long long)lock.maxWaitMicros);
+      for (unsigned int j = 0; j < lock.holders.size() && j < 3; j++)
+        logger->Log(LOGNOTICE, "LockProfiler:   held at %p, %u times, %llu us",
+                    lock.holders[j].address, lock.holders[j].count, (unsigned long long)lock.holders[j].waitMicros);
+      for (unsigned int j = 0; j < lock.waiters.size() && j < 3; j++)
+        logger->Log(LOGNOTICE, "LockProfiler:   waited at %p, %u times, %llu us",
+                    lock.waiters[j].address, lock.waiters[j].count, (unsigned long long)lock.waiters[j].waitMicros);
+    }
+  }
+}
@@ -0,0 +1,108 @@
+/*
+ *      Copyright (C) 2012 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+ *  http://www.gnu.org/copyleft/gpl.html
+ *
+ */
+
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+
+/**
+ * Call site of a lock for the LockProfiler, NULL while it's disabled.
+ *
+ * This has to be evaluated in code that is inlined into the function taking
+ *  the lock (the guard constructors), as it's the return address of the
+ *  out of line LockProfiler::GetCallSite().
+ */
+#define XBMC_LOCK_CALLSITE() (XbmcThreads::LockProfiler::IsEnabled() ? XbmcThreads::LockProfiler::GetCallSite() : NULL)
+
+#ifdef _MSC_VER
+#define XBMC_LOCK_NOINLINE __declspec(noinline)
+#else
+#define XBMC_LOCK_NOINLINE __attribute__((noinline))
+#endif
+
+namespace XbmcCommons { class ILogger; }
+
+namespace XbmcThreads
+{
+  /**
+   * Opt-in contention profiler for CCriticalSection and CSharedSection.
+   *
+   * While enabled every lock acquisition that has to wait records the time
+   *  it waited, the call site that was waiting and the call site that held
+   *  the lock at the time, keyed by the address of the lock. Uncontended
+   *  acquisitions only cost a check of the enabled flag.
+   *
+   * Call sites are return addresses, they can be resolved with addr2line
+   *  or a debugger.
+   */
+  class LockProfiler
+  {
+    static volatile bool enabled;
+  public:
+    struct CallSite
+    {
+      const void* address;
+      unsigned int count;
+      uint64_t waitMicros;
+    };
+
+    struct LockStats
+    {
+      const void* lock;
+      unsigned int contentions;
+      uint64_t waitMicros;
+      uint64_t maxWaitMicros;
+      std::vector<CallSite> holders; // sorted by wait time they caused
+      std::vector<CallSite> waiters; // sorted by wait time they suffered
+    };
+
+    static inline bool IsEnabled() { return enabled; }
+    static void Enable(bool enable);
+    static void Reset();
+
+    /**
+     * Start time of a wait, only meaningful for passing to RecordWait.
+     */
+    static uint64_t Now();
+
+    /**
+     * Returns the address it returns to, i.e. a location in its caller.
+     */
+    XBMC_LOCK_NOINLINE static const void* GetCallSite();
+
+    static void RecordWait(const void* lock, const void* holder, const void* waiter, uint64_t start);
+
+    /**
+     * Returns the recorded locks sorted by the total time spent waiting on them.
+     */
+    static void GetStats(std::vector<LockStats>& stats);
+
+    /**
+     * Logs the most contended locks through the given logger (or the CThread
+     *  logger if none is given).
+     */
+    static void Dump(unsigned int maxLocks = 20, XbmcCommons::ILogger* logger = NULL);
+  };
+}
+
@@ -22,6 +22,7 @@
 #pragma once
 
 #include "threads/Helpers.h"
+#include "threads/LockProfiler.h"
 
 namespace XbmcThreads
 {
@@ -52,13 +53,50 @@ namespace XbmcThreads
   protected:
     L mutex;
     unsigned int count;
+    const void* holder; // call site of the owner, only kept while the LockProfiler is enabled
 
   public:
-    inline CountingLockable() : count(0) {}
+    inline CountingLockable() : count(0), holder(NULL) {}
 
     // boost::thread Lockable concept
-    inline void lock() { mutex.lock(); count++; }
-    inline bool try_lock() { return mutex.try_lock() ? count++, true : false; }
+    inline void lock() { lock(XBMC_LOCK_CALLSITE()); }
+    inline bool try_lock() { return try_lock(XBMC_LOCK_CALLSITE()); }
+
+    /**
+     * The caller is the call site reported by the LockProfiler. Guards
+     *  capture it where they are constructed, see XBMC_LOCK_CALLSITE.
+     */
+    inline void lock(const void* caller)
+    {
+      if (!LockProfiler::IsEnabled())
+      {
+        mutex.lock();
+        count++;
+        return;
+      }
+
+      if (!mutex.try_lock())
+      {
+        uint64_t start = LockProfiler::Now();
+        const void* current = holder;
+        mutex.lock();
+        LockProfiler::RecordWait(this, current, caller, start);
+      }
+      if (!count)
+        holder = caller;
+      count++;
+    }
+
+    inline bool try_lock(const void* caller)
+    {
+      if (!mutex.try_lock())
+        return false;
+      if (!count && LockProfiler::IsEnabled())
+        holder = caller;
+      count++;
+      return true;
+    }
+
     inline void unlock() { count--; mutex.unlock(); }
 
     /**
@@ -114,8 +152,8 @@ namespace XbmcThreads
   protected:
     L& mutex;
     bool owns;
-    inline UniqueLock(L& lockable) : mutex(lockable), owns(true) { mutex.lock(); }
-    inline UniqueLock(L& lockable, bool try_to_lock_discrim ) : mutex(lockable) { owns = mutex.try_lock(); }
+    inline UniqueLock(L& lockable, const void* caller) : mutex(lockable), owns(true) { mutex.lock(caller); }
+    inline UniqueLock(L& lockable, bool try_to_lock_discrim, const void* caller) : mutex(lockable) { owns = mutex.try_lock(caller); }
     inline ~UniqueLock() { if (owns) mutex.unlock(); }
 
   public:
@@ -123,8 +161,8 @@ namespace XbmcThreads
     inline bool owns_lock() const { return owns; }
 
     //This also implements lockable
-    inline void lock() { mutex.lock(); owns=true; }
-    inline bool try_lock() { return (owns = mutex.try_lock()); }
+    inline void lock() { mutex.lock(XBMC_LOCK_CALLSITE()); owns=true; }
+    inline bool try_lock() { return (owns = mutex.try_lock(XBMC_LOCK_CALLSITE())); }
     inline void unlock() { if (owns) { mutex.unlock(); owns=false; } }
 
     /**
@@ -149,12 +187,12 @@ namespace XbmcThreads
   protected:
     L& mutex;
     bool owns;
-    inline SharedLock(L& lockable) : mutex(lockable), owns(true) { mutex.lock_shared(); }
+    inline SharedLock(L& lockable, const void* caller) : mutex(lockable), owns(true) { mutex.lock_shared(caller); }
     inline ~SharedLock() { if (owns) mutex.unlock_shared(); }
 
     inline bool owns_lock() const { return owns; }
-    inline void lock() { mutex.lock_shared(); owns = true; }
-    inline bool try_lock() { return (owns = mutex.try_lock_shared()); }
+    inline void lock() { mutex.lock_shared(XBMC_LOCK_CALLSITE()); owns = true; }
+    inline bool try_lock() { return (owns = mutex.try_lock_shared(XBMC_LOCK_CALLSITE())); }
     inline void unlock() { if (owns) mutex.unlock_shared(); owns = false; }
 
     /**
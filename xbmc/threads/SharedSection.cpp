@@ -0,0 +1,276 @@
+/*
+ *      Copyright (C) 2012 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+ *  http://www.gnu.org/copyleft/gpl.html
+ *
+ */
+
+
+#include "threads/SharedSection.h"
+#include "threads/Atomics.h"
+#include "threads/LockProfiler.h"
+#include "threads/SystemClock.h"
+
+#include <limits>
+
+#define INFINITE_WAIT std::numeric_limits<unsigned int>::max()
+
+// a thread's holds on a section: the shared count in the low bits, the
+// exclusive count above
+#define HOLD_SHARED    ((intptr_t)1)
+#define HOLD_EXCLUSIVE ((intptr_t)1 << 16)
+#define SHARED_HOLDS(holds)    ((holds) & (HOLD_EXCLUSIVE - 1))
+#define EXCLUSIVE_HOLDS(holds) ((holds) / HOLD_EXCLUSIVE)
+
+CSharedSection::CSharedSection() : m_state(0), m_holder(NULL)
+{
+}
+
+intptr_t CSharedSection::GetHolds()
+{
+  return (intptr_t)m_holds.get();
+}
+
+void CSharedSection::AddHolds(intptr_t amount)
+{
+  m_holds.set((void*)(GetHolds() + amount));
+}
+
+void CSharedSection::Notify()
+{
+  CSingleLock lock(m_waitSection);
+  m_readers.notifyAll();
+  m_writers.notifyAll();
+}
+
+bool CSharedSection::LockShared(unsigned int millis, bool wait, const void* caller)
+{
+  // who may pass: everyone if there's no writer, threads that already hold
+  // shared locks while the writer is only waiting, the writer itself always
+  const intptr_t holds = GetHolds();
+  const long blocking = EXCLUSIVE_HOLDS(holds) ? 0 : (SHARED_HOLDS(holds) ? WriterActive : (WriterActive | WriterWaiting));
+
+  XbmcThreads::EndTime endTime;
+  uint64_t start = 0;
+  bool waited = false;
+
+  while (true)
+  {
+    long state = m_state;
+    if (!(state & blocking))
+    {
+      if (cas(&m_state, state, state + 1) == state)
+        break;
+      continue;
+    }
+
+    if (!wait)
+      return false;
+
+    if (!waited)
+    {
+      waited = true;
+      if (millis != INFINITE_WAIT)
+        endTime.Set(millis);
+      if (XbmcThreads::LockProfiler::IsEnabled())
+        start = XbmcThreads::LockProfiler::Now();
+    }
+
+    CSingleLock lock(m_waitSection);
+    if (!(m_state & blocking))
+      continue;
+
+    if (millis == INFINITE_WAIT)
+      m_readers.wait(lock);
+    else if (endTime.IsTimePast() || !m_readers.wait(lock, endTime.MillisLeft()))
+    {
+      if (!(m_state & blocking))
+        continue;
+      return false;
+    }
+  }
+
+  AddHolds(HOLD_SHARED);
+  if (waited && start)
+    XbmcThreads::LockProfiler::RecordWait(this, m_holder, caller, start);
+  return true;
+}
+
+bool CSharedSection::LockExclusive(unsigned int millis, bool wait, const void* caller)
+{
+  if (EXCLUSIVE_HOLDS(GetHolds()))
+  {
+    AddHolds(HOLD_EXCLUSIVE);
+    return true;
+  }
+
+  XbmcThreads::EndTime endTime;
+  if (millis != INFINITE_WAIT)
+    endTime.Set(millis);
+  uint64_t start = 0;
+  bool waited = false;
+
+  // claim the one writer slot, this keeps new readers out
+  while (true)
+  {
+    long state = m_state;
+    if (!(state & (WriterWaiting | WriterActive)))
+    {
+      if (cas(&m_state, state, state | WriterWaiting) == state)
+        break;
+      continue;
+    }
+
+    if (!wait)
+      return false;
+
+    if (!waited)
+    {
+      waited = true;
+      if (XbmcThreads::LockProfiler::IsEnabled())
+        start = XbmcThreads::LockProfiler::Now();
+    }
+
+    CSingleLock lock(m_waitSection);
+    if (!(m_state & (WriterWaiting | WriterActive)))
+      continue;
+
+    if (millis == INFINITE_WAIT)
+      m_writers.wait(lock);
+    else if (endTime.IsTimePast() || !m_writers.wait(lock, endTime.MillisLeft()))
+    {
+      if (!(m_state & (WriterWaiting | WriterActive)))
+        continue;
+      return false;
+    }
+  }
+
+  // wait for the readers to drain
+  while (true)
+  {
+    long state = m_state;
+    if (!(state & ReadersMask))
+    {
+      if (cas(&m_state, state, (state & ~WriterWaiting) | WriterActive) == state)
+        break;
+      continue;
+    }
+
+    bool timedOut = !wait;
+    if (!timedOut)
+    {
+      if (!waited)
+      {
+        waited = true;
+        if (XbmcThreads::LockProfiler::IsEnabled())
+          start = XbmcThreads::LockProfiler::Now();
+      }
+
+      CSingleLock lock(m_waitSection);
+      if (!(m_state & ReadersMask))
+        continue;
+
+      if (millis == INFINITE_WAIT)
+        m_writers.wait(lock);
+      else if (endTime.IsTimePast() || !m_writers.wait(lock, endTime.MillisLeft()))
+        timedOut = (m_state & ReadersMask) != 0;
+    }
+
+    if (timedOut)
+    { // give up the slot and let the readers blocked by it in again
+      do
+      {
+        state = m_state;
+      } while (cas(&m_state, state, state & ~WriterWaiting) != state);
+      Notify();
+      return false;
+    }
+  }
+
+  AddHolds(HOLD_EXCLUSIVE);
+
+  if (XbmcThreads::LockProfiler::IsEnabled())
+  {
+    if (waited && start)
+      XbmcThreads::LockProfiler::RecordWait(this, m_holder, caller, start);
+    m_holder = caller;
+  }
+  return true;
+}
+
+void CSharedSection::lock(const void* caller)
+{
+  LockExclusive(INFINITE_WAIT, true, caller);
+}
+
+bool CSharedSection::try_lock(const void* caller)
+{
+  return LockExclusive(0, false, caller);
+}
+
+bool CSharedSection::timed_lock(unsigned int millis, const void* caller)
+{
+  return LockExclusive(millis, true, caller);
+}
+
+void CSharedSection::unlock()
+{
+  AddHolds(-HOLD_EXCLUSIVE);
+  if (EXCLUSIVE_HOLDS(GetHolds()))
+    return;
+
+  long state;
+  do
+  {
+    state = m_state;
+  } while (cas(&m_state, state, state & ~WriterActive) != state);
+
+  Notify();
+}
+
+void CSharedSection::lock_shared(const void* caller)
+{
+  LockShared(INFINITE_WAIT, true, caller);
+}
+
+bool CSharedSection::try_lock_shared(const void* caller)
+{
+  return LockShared(0, false, caller);
+}
+
+bool CSharedSection::timed_lock_shared(unsigned int millis, const void* caller)
+{
+  return LockShared(millis, true, caller);
+}
+
+void CSharedSection::unlock_shared()
+{
+  AddHolds(-HOLD_SHARED);
+
+  long state;
+  do
+  {
+    state = m_state;
+  } while (cas(&m_state, state, state - 1) != state);
+
+  // the last reader out wakes up a writer waiting for them
+  if ((state & WriterWaiting) && (state & ReadersMask) == 1)
+  {
+    CSingleLock lock(m_waitSection);
+    m_writers.notifyAll();
+  }
+}
@@ -24,35 +24,75 @@
 #include "threads/Condition.h"
 #include "threads/SingleLock.h"
 #include "threads/Helpers.h"
+#include "threads/ThreadLocal.h"
+#include "threads/platform/ThreadImpl.h"
 
 /**
  * A CSharedSection is a mutex that satisfies the Shared Lockable concept (see Lockables.h).
+ *
+ * Shared owners only touch a single atomic word as long as no writer is
+ *  around, so readers don't serialize on a mutex. A writer that wants the
+ *  lock blocks new readers until it got it (writer preference). Threads
+ *  already holding a shared lock can still take more shared locks while
+ *  a writer waits, so recursive shared locking doesn't deadlock.
+ *
+ * Like before the exclusive lock is recursive and its owner may also take
+ *  shared locks.
  */
-class CSharedSection
+class CSharedSection : public XbmcThreads::NonCopyable
 {
-  CCriticalSection sec;
-  XbmcThreads::ConditionVariable actualCv;
-  XbmcThreads::TightConditionVariable<XbmcThreads::InversePredicate<unsigned int&> > cond;
+  static const long WriterWaiting = 0x40000000;
+  static const long WriterActive  = 0x20000000;
+  static const long ReadersMask   = 0x1fffffff;
+
+  // number of shared owners plus the writer flags, only changed using cas()
+  volatile long m_state;
+
+  // only guards the waiting below, it's never held while owning the section
+  CCriticalSection m_waitSection;
+  XbmcThreads::ConditionVariable m_readers;
+  XbmcThreads::ConditionVariable m_writers;
 
-  unsigned int sharedCount;
+  // how often the current thread holds this section shared and exclusively,
+  //  packed into the pointer. Only the thread itself ever touches its holds.
+  XbmcThreads::ThreadLocal<void> m_holds;
+
+  // call site of the last writer, only kept while the LockProfiler is enabled
+  const void* m_holder;
+
+  intptr_t GetHolds();
+  void AddHolds(intptr_t amount);
+  bool LockShared(unsigned int millis, bool wait, const void* caller);
+  bool LockExclusive(unsigned int millis, bool wait, const void* caller);
+  void Notify();
 
 public:
-  inline CSharedSection() : cond(actualCv,XbmcThreads::InversePredicate<unsigned int&>(sharedCount)), sharedCount(0)  {}
+  CSharedSection();
+
+  // the caller is the call site reported by the LockProfiler, see XBMC_LOCK_CALLSITE
+  void lock(const void* caller);
+  bool try_lock(const void* caller);
+  bool timed_lock(unsigned int millis, const void* caller);
+  void unlock();
 
-  inline void lock() { CSingleLock l(sec); if (sharedCount) cond.wait(l); sec.lock(); }
-  inline bool try_lock() { return (sec.try_lock() ? ((sharedCount == 0) ? true : (sec.unlock(), false)) : false); }
-  inline void unlock() { sec.unlock(); }
+  void lock_shared(const void* caller);
+  bool try_lock_shared(const void* caller);
+  bool timed_lock_shared(unsigned int millis, const void* caller);
+  void unlock_shared();
 
-  inline void lock_shared() { CSingleLock l(sec); sharedCount++; }
-  inline bool try_lock_shared() { return (sec.try_lock() ? sharedCount++, sec.unlock(), true : false); }
-  inline void unlock_shared() { CSingleLock l(sec); sharedCount--; if (!sharedCount) { cond.notifyAll(); } }
+  inline void lock() { lock(XBMC_LOCK_CALLSITE()); }
+  inline bool try_lock() { return try_lock(XBMC_LOCK_CALLSITE()); }
+  inline bool timed_lock(unsigned int millis) { return timed_lock(millis, XBMC_LOCK_CALLSITE()); }
+  inline void lock_shared() { lock_shared(XBMC_LOCK_CALLSITE()); }
+  inline bool try_lock_shared() { return try_lock_shared(XBMC_LOCK_CALLSITE()); }
+  inline bool timed_lock_shared(unsigned int millis) { return timed_lock_shared(millis, XBMC_LOCK_CALLSITE()); }
 };
 
 class CSharedLock : public XbmcThreads::SharedLock<CSharedSection>
 {
 public:
-  inline CSharedLock(CSharedSection& cs) : XbmcThreads::SharedLock<CSharedSection>(cs) {}
-  inline CSharedLock(const CSharedSection& cs) : XbmcThreads::SharedLock<CSharedSection>((CSharedSection&)cs) {}
+  inline CSharedLock(CSharedSection& cs) : XbmcThreads::SharedLock<CSharedSection>(cs, XBMC_LOCK_CALLSITE()) {}
+  inline CSharedLock(const CSharedSection& cs) : XbmcThreads::SharedLock<CSharedSection>((CSharedSection&)cs, XBMC_LOCK_CALLSITE()) {}
 
   inline bool IsOwner() const { return owns_lock(); }
   inline void Enter() { lock(); }
@@ -62,8 +102,8 @@ public:
 class CExclusiveLock : public XbmcThreads::UniqueLock<CSharedSection>
 {
 public:
-  inline CExclusiveLock(CSharedSection& cs) : XbmcThreads::UniqueLock<CSharedSection>(cs) {}
-  inline CExclusiveLock(const CSharedSection& cs) : XbmcThreads::UniqueLock<CSharedSection> ((CSharedSection&)cs) {}
+  inline CExclusiveLock(CSharedSection& cs) : XbmcThreads::UniqueLock<CSharedSection>(cs, XBMC_LOCK_CALLSITE()) {}
+  inline CExclusiveLock(const CSharedSection& cs) : XbmcThreads::UniqueLock<CSharedSection> ((CSharedSection&)cs, XBMC_LOCK_CALLSITE()) {}
 
   inline bool IsOwner() const { return owns_lock(); }
   inline void Leave() { unlock(); }
@@ -34,13 +34,13 @@
 class CSingleLock : public XbmcThreads::UniqueLock<CCriticalSection>
 {
 public:
-  inline CSingleLock(CCriticalSection& cs) : XbmcThreads::UniqueLock<CCriticalSection>(cs) {}
-  inline CSingleLock(const CCriticalSection& cs) : XbmcThreads::UniqueLock<CCriticalSection> ((CCriticalSection&)cs) {}
+  inline CSingleLock(CCriticalSection& cs) : XbmcThreads::UniqueLock<CCriticalSection>(cs, XBMC_LOCK_CALLSITE()) {}
+  inline CSingleLock(const CCriticalSection& cs) : XbmcThreads::UniqueLock<CCriticalSection> ((CCriticalSection&)cs, XBMC_LOCK_CALLSITE()) {}
 
   inline void Leave() { unlock(); }
   inline void Enter() { lock(); }
 protected:
-  inline CSingleLock(CCriticalSection& cs, bool dicrim) : XbmcThreads::UniqueLock<CCriticalSection>(cs,true) {}
+  inline CSingleLock(CCriticalSection& cs, bool dicrim) : XbmcThreads::UniqueLock<CCriticalSection>(cs, true, XBMC_LOCK_CALLSITE()) {}
 };
 
 /**
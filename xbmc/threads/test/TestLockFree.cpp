@@ -0,0 +1,95 @@
+/*
+ *      Copyright (C) 2005-2012 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+ *  http://www.gnu.org/copyleft/gpl.html
+ *
+ */
+
+#include "TestHelpers.h"
+#include "threads/LockFree.h"
+
+#include <boost/shared_array.hpp>
+#include <boost/bind.hpp>
+
+#define TESTNUM 100000l
+#define NUMTHREADS 10l
+
+struct TestNode
+{
+  lf_mpsc_node node; // must be first
+  long producer;
+  long sequence;
+};
+
+void doPush(lf_mpsc_queue* queue, TestNode* nodes, long producer)
+{
+  for (long i = 0; i < TESTNUM; i++)
+  {
+    nodes[i].producer = producer;
+    nodes[i].sequence = i;
+    lf_mpsc_push(queue, &nodes[i].node);
+  }
+}
+
+TEST(TestMpscQueueEmpty)
+{
+  lf_mpsc_queue queue;
+  lf_mpsc_init(&queue);
+  CHECK(lf_mpsc_pop(&queue) == NULL);
+
+  TestNode node;
+  lf_mpsc_push(&queue, &node.node);
+  CHECK(lf_mpsc_pop(&queue) == &node.node);
+  CHECK(lf_mpsc_pop(&queue) == NULL);
+
+  // and again, now that the stub has been cycled through
+  lf_mpsc_push(&queue, &node.node);
+  CHECK(lf_mpsc_pop(&queue) == &node.node);
+  CHECK(lf_mpsc_pop(&queue) == NULL);
+}
+
+TEST(TestMpscQueueMassPush)
+{
+  lf_mpsc_queue queue;
+  lf_mpsc_init(&queue);
+
+  boost::shared_array<TestNode> nodes(new TestNode[NUMTHREADS * TESTNUM]);
+  boost::shared_array<thread> t(new thread[NUMTHREADS]);
+  for (long i = 0; i < NUMTHREADS; i++)
+    t[i] = thread(boost::bind(&doPush, &queue, &nodes[i * TESTNUM], i));
+
+  // pop concurrently, checking each producer's nodes come out in order
+  long next[NUMTHREADS] = { 0 };
+  long popped = 0;
+  bool ordered = true;
+  for (long spins = 0; popped < NUMTHREADS * TESTNUM && spins < 100000000l; spins++)
+  {
+    TestNode* node = (TestNode*)lf_mpsc_pop(&queue);
+    if (!node)
+      continue;
+    if (node->sequence != next[node->producer]++)
+      ordered = false;
+    popped++;
+  }
+
+  for (long i = 0; i < NUMTHREADS; i++)
+    t[i].join();
+
+  CHECK_EQUAL(NUMTHREADS * TESTNUM, popped);
+  CHECK(ordered);
+  CHECK(lf_mpsc_pop(&queue) == NULL);
+}
@@ -85,7 +85,7 @@ TEST(TestGetSharedLockWhileTryingExclusiveLock)
 
   CSharedLock l1(sec); // get a shared lock
 
-  locker<CExclusiveLock> l2(sec,&mutex);
+  locker<CExclusiveLock> l2(sec,&mutex,&event);
   thread waitThread1(ref(l2)); // try to get an exclusive lock
 
   CHECK(waitForThread(mutex,1,10000));
@@ -94,30 +94,131 @@ TEST(TestGetSharedLockWhileTryingExclusiveLock)
   CHECK(!l2.haslock);  // this thread is waiting ...
   CHECK(!l2.obtainedlock);  // this thread is waiting ...
 
-  // now try and get a SharedLock
+  // now try and get a SharedLock. Writers are preferred so this
+  //  thread must queue up behind the waiting exclusive lock.
   locker<CSharedLock> l3(sec,&mutex,&event);
   thread waitThread3(ref(l3)); // try to get a shared lock
   CHECK(waitForThread(mutex,2,10000));
   SleepMillis(10);
-  CHECK(l3.haslock);
+  CHECK(!l3.haslock);
+  CHECK(!l3.obtainedlock);
+
+  // let it go
+  l1.Leave(); // the last shared lock leaves.
+
+  // the exclusive lock goes first ...
+  CHECK(waitForWaiters(event,1,10000));
+  SleepMillis(10);
+  CHECK(l2.haslock);
+  CHECK(!l3.obtainedlock);
 
+  // ... and the shared lock follows once it's released.
   event.Set();
-  CHECK(waitThread3.timed_join(MILLIS(10000)));
+  CHECK(waitThread1.timed_join(MILLIS(10000)));
+  CHECK(l2.obtainedlock);  // the exclusive lock was captured
+  CHECK(!l2.haslock);  // ... but it doesn't have it anymore
 
-  // l3 should have released.
+  CHECK(waitForWaiters(event,1,10000));
+  CHECK(l3.haslock);
+  event.Set();
+  CHECK(waitThread3.timed_join(MILLIS(10000)));
   CHECK(!l3.haslock);
+}
 
-  // but the exclusive lock should still not have happened
-  CHECK(!l2.haslock);  // this thread is waiting ...
-  CHECK(!l2.obtainedlock);  // this thread is waiting ...
+TEST(TestRecursiveSharedLockWhileTryingExclusiveLock)
+{
+  volatile long mutex = 0;
 
-  // let it go
-  l1.Leave(); // the last shared lock leaves.
+  CSharedSection sec;
+
+  CSharedLock l1(sec); // get a shared lock
+
+  locker<CExclusiveLock> l2(sec,&mutex);
+  thread waitThread1(ref(l2)); // try to get an exclusive lock
+
+  CHECK(waitForThread(mutex,1,10000));
+  SleepMillis(10);
+  CHECK(!l2.haslock);
+
+  // a thread that already holds a shared lock must not block behind
+  //  the waiting writer or it would deadlock.
+  {
+    CSharedLock l1again(sec);
+    CHECK(l1again.IsOwner());
+  }
+
+  l1.Leave();
 
   CHECK(waitThread1.timed_join(MILLIS(10000)));
+  CHECK(l2.obtainedlock);
+}
 
-  CHECK(l2.obtainedlock);  // the exclusive lock was captured
-  CHECK(!l2.haslock);  // ... but it doesn't have it anymore
+TEST(TestSharedLockOnOtherSectionWhileTryingExclusiveLock)
+{
+  volatile long mutex = 0;
+
+  CSharedSection sec;
+  CSharedSection other;
+
+  CSharedLock l1(sec);
+  CSharedLock lother(other); // only a hold on the other section
+
+  locker<CExclusiveLock> l2(sec,&mutex);
+  thread waitThread1(ref(l2)); // try to get an exclusive lock
+
+  CHECK(waitForThread(mutex,1,10000));
+  SleepMillis(10);
+  CHECK(!l2.haslock);
+
+  // holding some other section doesn't let this thread pass the writer
+  locker<CSharedLock> l3(sec,&mutex);
+  thread waitThread3(ref(l3));
+  CHECK(waitForThread(mutex,2,10000));
+  SleepMillis(10);
+  CHECK(!l3.obtainedlock);
+
+  // ... and holding a shared lock doesn't make it the exclusive owner
+  CHECK(!sec.try_lock());
+
+  l1.Leave();
+
+  CHECK(waitThread1.timed_join(MILLIS(10000)));
+  CHECK(l2.obtainedlock);
+  CHECK(waitThread3.timed_join(MILLIS(10000)));
+  CHECK(l3.obtainedlock);
+}
+
+TEST(TestSharedSectionTryLock)
+{
+  CSharedSection sec;
+
+  {
+    CSharedLock l1(sec);
+    CHECK(sec.try_lock_shared());
+    sec.unlock_shared();
+    CHECK(!sec.try_lock());
+    CHECK(!sec.timed_lock(10));
+  }
+
+  CHECK(sec.try_lock());
+  CHECK(sec.try_lock()); // the exclusive lock is recursive ...
+  CHECK(sec.try_lock_shared()); // ... and the owner may read
+  sec.unlock_shared();
+  sec.unlock();
+
+  volatile long mutex = 0;
+  locker<CSharedLock> l2(sec,&mutex);
+  thread waitThread1(ref(l2));
+  CHECK(waitForThread(mutex,1,10000));
+  SleepMillis(10);
+  CHECK(!l2.obtainedlock);
+
+  sec.unlock();
+  CHECK(waitThread1.timed_join(MILLIS(10000)));
+  CHECK(l2.obtainedlock);
+
+  CHECK(sec.timed_lock_shared(10));
+  sec.unlock_shared();
 }
 
 TEST(TestSharedSection2Case)
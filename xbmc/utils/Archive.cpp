@@ -23,6 +23,8 @@
 #include "filesystem/File.h"
 #include "Variant.h"
 
+#include <algorithm>
+
 using namespace XFILE;
 
 #define BUFFER_MAX 4096
@@ -36,6 +38,7 @@ CArchive::CArchive(CFile* pFile, int mode)
   memset(m_pBuffer, 0, BUFFER_MAX);
 
   m_BufferPos = 0;
+  m_BufferRemain = 0;
 }
 
 CArchive::~CArchive()
@@ -184,21 +187,23 @@ CArchive& CArchive::operator<<(const CStdStringW& str)
 {
   *this << str.GetLength();
 
-  int size = str.GetLength();
+  // the length is in characters, the data is written byte wise
+  const uint8_t *data = (const uint8_t*)str.c_str();
+  int size = str.GetLength() * sizeof(wchar_t);
   if (m_BufferPos + size >= BUFFER_MAX)
     FlushBuffer();
 
   int iBufferMaxParts=size/BUFFER_MAX;
   for (int i=0; i<iBufferMaxParts; ++i)
   {
-    memcpy(&m_pBuffer[m_BufferPos], str.c_str()+(i*BUFFER_MAX), BUFFER_MAX);
+    memcpy(&m_pBuffer[m_BufferPos], data+(i*BUFFER_MAX), BUFFER_MAX);
     m_BufferPos+=BUFFER_MAX;
     FlushBuffer();
   }
 
   int iPos=iBufferMaxParts*BUFFER_MAX;
   int iSizeLeft=size-iPos;
-  memcpy(&m_pBuffer[m_BufferPos], str.c_str()+iPos, iSizeLeft);
+  memcpy(&m_pBuffer[m_BufferPos], data+iPos, iSizeLeft);
   m_BufferPos+=iSizeLeft;
 
   return *this;
@@ -285,58 +290,42 @@ CArchive& CArchive::operator<<(const std::vector<int>& iArray)
 
 CArchive& CArchive::operator>>(float& f)
 {
-  m_pFile->Read((void*)&f, sizeof(float));
-
-  return *this;
+  return streamin(&f, sizeof(float));
 }
 
 CArchive& CArchive::operator>>(double& d)
 {
-  m_pFile->Read((void*)&d, sizeof(double));
-
-  return *this;
+  return streamin(&d, sizeof(double));
 }
 
 CArchive& CArchive::operator>>(int& i)
 {
-  m_pFile->Read((void*)&i, sizeof(int));
-
-  return *this;
+  return streamin(&i, sizeof(int));
 }
 
 CArchive& CArchive::operator>>(unsigned int& i)
 {
-  m_pFile->Read((void*)&i, sizeof(unsigned int));
-
-  return *this;
+  return streamin(&i, sizeof(unsigned int));
 }
 
 CArchive& CArchive::operator>>(int64_t& i64)
 {
-  m_pFile->Read((void*)&i64, sizeof(int64_t));
-
-  return *this;
+  return streamin(&i64, sizeof(int64_t));
 }
 
 CArchive& CArchive::operator>>(uint64_t& ui64)
 {
-  m_pFile->Read((void*)&ui64, sizeof(uint64_t));
-
-  return *this;
+  return streamin(&ui64, sizeof(uint64_t));
 }
 
 CArchive& CArchive::operator>>(bool& b)
 {
-  m_pFile->Read((void*)&b, sizeof(bool));
-
-  return *this;
+  return streamin(&b, sizeof(bool));
 }
 
 CArchive& CArchive::operator>>(char& c)
 {
-  m_pFile->Read((void*)&c, sizeof(char));
-
-  return *this;
+  return streamin(&c, sizeof(char));
 }
 
 CArchive& CArchive::operator>>(CStdString& str)
@@ -344,9 +333,14 @@ CArchive& CArchive::operator>>(CStdString& str)
   int iLength = 0;
   *this >> iLength;
 
-  m_pFile->Read((void*)str.GetBufferSetLength(iLength), iLength);
-  str.ReleaseBuffer();
+  if (iLength <= 0)
+  {
+    str.Empty();
+    return *this;
+  }
 
+  streamin(str.GetBufferSetLength(iLength), iLength);
+  str.ReleaseBuffer();
 
   return *this;
 }
@@ -356,18 +350,21 @@ CArchive& CArchive::operator>>(CStdStringW& str)
   int iLength = 0;
   *this >> iLength;
 
-  m_pFile->Read((void*)str.GetBufferSetLength(iLength), iLength);
-  str.ReleaseBuffer();
+  if (iLength <= 0)
+  {
+    str.Empty();
+    return *this;
+  }
 
+  streamin(str.GetBufferSetLength(iLength), iLength * sizeof(wchar_t));
+  str.ReleaseBuffer();
 
   return *this;
 }
 
 CArchive& CArchive::operator>>(SYSTEMTIME& time)
 {
-  m_pFile->Read((void*)&time, sizeof(SYSTEMTIME));
-
-  return *this;
+  return streamin(&time, sizeof(SYSTEMTIME));
 }
 
 CArchive& CArchive::operator>>(IArchivable& obj)
@@ -485,9 +482,54 @@ CArchive& CArchive::operator>>(std::vector<int>& iArray)
   return *this;
 }
 
+CArchive& CArchive::streamin(void *dataPtr, const size_t size)
+{
+  uint8_t *ptr = (uint8_t*)dataPtr;
+  size_t left = size;
+
+  // serve loads from a read ahead buffer, cached listings are deserialized
+  // field by field and would otherwise cost a file read for every few bytes
+  while (left > 0)
+  {
+    if (m_BufferRemain == 0)
+    {
+      // big blocks go straight to their destination
+      if (left >= BUFFER_MAX)
+      {
+        unsigned int read = m_pFile->Read(ptr, left);
+        if (read > left) // failed reads return (unsigned int)-1
+          read = 0;
+        if (read < left)
+          memset(ptr + read, 0, left - read);
+        break;
+      }
+
+      m_BufferPos = 0;
+      unsigned int read = m_pFile->Read(m_pBuffer, BUFFER_MAX);
+      if (read == 0 || read > BUFFER_MAX)
+      {
+        // truncated archive or failed read, hand out zeros instead of garbage
+        m_BufferRemain = 0;
+        memset(ptr, 0, left);
+        break;
+      }
+      m_BufferRemain = read;
+    }
+
+    size_t chunk = std::min(left, (size_t)m_BufferRemain);
+    memcpy(ptr, &m_pBuffer[m_BufferPos], chunk);
+    m_BufferPos += chunk;
+    m_BufferRemain -= chunk;
+    ptr += chunk;
+    left -= chunk;
+  }
+
+  return *this;
+}
+
 void CArchive::FlushBuffer()
 {
-  if (m_BufferPos > 0)
+  if (m_iMode == store && m_BufferPos > 0)
   {
     m_pFile->Write(m_pBuffer, m_BufferPos);
     m_BufferPos = 0;
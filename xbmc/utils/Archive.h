@@ -86,10 +86,12 @@ public:
   enum Mode {load = 0, store};
 
 protected:
+  CArchive& streamin(void *dataPtr, const size_t size);
   void FlushBuffer();
   XFILE::CFile* m_pFile;
   int m_iMode;
   uint8_t *m_pBuffer;
   int m_BufferPos;
+  int m_BufferRemain;
 };
 
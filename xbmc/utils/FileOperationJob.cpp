@@ -22,6 +22,7 @@
 #include "FileOperationJob.h"
 #include "filesystem/File.h"
 #include "filesystem/Directory.h"
+#include "filesystem/DirectoryWalker.h"
 #include "filesystem/ZipManager.h"
 #include "filesystem/FileDirectoryFactory.h"
 #include "filesystem/MultiPathDirectory.h"
@@ -60,7 +61,8 @@ bool CFileOperationJob::DoWork()
 {
   FileOperationList ops;
   double totalTime = 0.0;
-  bool success = DoProcess(m_action, m_items, m_strDestFile, ops, totalTime);
+  CDirectoryWalker walker("", DIR_FLAG_NO_FILE_DIRS | DIR_FLAG_GET_HIDDEN);
+  bool success = DoProcess(m_action, m_items, m_strDestFile, ops, totalTime, walker);
 
   unsigned int size = ops.size();
 
@@ -91,7 +93,7 @@ bool CFileOperationJob::DoProcessFile(FileAction action, const CStdString& strFi
   return true;
 }
 
-bool CFileOperationJob::DoProcessFolder(FileAction action, const CStdString& strPath, const CStdString& strDestFile, FileOperationList &fileOperations, double &totalTime)
+bool CFileOperationJob::DoProcessFolder(FileAction action, const CStdString& strPath, const CStdString& strDestFile, FileOperationList &fileOperations, double &totalTime, CDirectoryWalker &walker)
 {
   // check whether this folder is a filedirectory - if so, we don't process it's contents
   CFileItem item(strPath, false);
@@ -104,7 +106,7 @@ bool CFileOperationJob::DoProcessFolder(FileAction action, const CStdString& str
   CLog::Log(LOGDEBUG,"FileManager, processing folder: %s",strPath.c_str());
   CFileItemList items;
   //m_rootDir.GetDirectory(strPath, items);
-  CDirectory::GetDirectory(strPath, items, "", DIR_FLAG_NO_FILE_DIRS | DIR_FLAG_GET_HIDDEN);
+  walker.GetDirectory(strPath, items);
   for (int i = 0; i < items.Size(); i++)
   {
     CFileItemPtr pItem = items[i];
@@ -112,7 +114,7 @@ bool CFileOperationJob::DoProcessFolder(FileAction action, const CStdString& str
     CLog::Log(LOGDEBUG,"  -- %s",pItem->GetPath().c_str());
   }
 
-  if (!DoProcess(action, items, strDestFile, fileOperations, totalTime)) return false;
+  if (!DoProcess(action, items, strDestFile, fileOperations, totalTime, walker)) return false;
 
   if (action == ActionMove)
   {
@@ -123,7 +125,7 @@ bool CFileOperationJob::DoProcessFolder(FileAction action, const CStdString& str
   return true;
 }
 
-bool CFileOperationJob::DoProcess(FileAction action, CFileItemList & items, const CStdString& strDestFile, FileOperationList &fileOperations, double &totalTime)
+bool CFileOperationJob::DoProcess(FileAction action, CFileItemList & items, const CStdString& strDestFile, FileOperationList &fileOperations, double &totalTime, CDirectoryWalker &walker)
 {
   for (int iItem = 0; iItem < items.Size(); ++iItem)
   {
@@ -164,8 +166,8 @@ bool CFileOperationJob::DoProcess(FileAction action, CFileItemList & items, cons
         if (action != ActionDelete)
           DoProcessFile(ActionCreateFolder, strnewDestFile, "", fileOperations, totalTime);
         if (action == ActionReplace && CDirectory::Exists(strnewDestFile))
-          DoProcessFolder(ActionDelete, strnewDestFile, "", fileOperations, totalTime);
-        if (!DoProcessFolder(subdirAction, pItem->GetPath(), strnewDestFile, fileOperations, totalTime))
+          DoProcessFolder(ActionDelete, strnewDestFile, "", fileOperations, totalTime, walker);
+        if (!DoProcessFolder(subdirAction, pItem->GetPath(), strnewDestFile, fileOperations, totalTime, walker))
           return false;
         if (action == ActionDelete)
           DoProcessFile(ActionDeleteFolder, pItem->GetPath(), "", fileOperations, totalTime);
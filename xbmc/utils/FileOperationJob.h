@@ -25,6 +25,11 @@
 #include "Job.h"
 #include "filesystem/File.h"
 
+namespace XFILE
+{
+  class CDirectoryWalker;
+}
+
 class CFileOperationJob : public CJob
 {
 public:
@@ -64,8 +69,8 @@ private:
   };
   friend class CFileOperation;
   typedef std::vector<CFileOperation> FileOperationList;
-  bool DoProcess(FileAction action, CFileItemList & items, const CStdString& strDestFile, FileOperationList &fileOperations, double &totalTime);
-  bool DoProcessFolder(FileAction action, const CStdString& strPath, const CStdString& strDestFile, FileOperationList &fileOperations, double &totalTime);
+  bool DoProcess(FileAction action, CFileItemList & items, const CStdString& strDestFile, FileOperationList &fileOperations, double &totalTime, XFILE::CDirectoryWalker &walker);
+  bool DoProcessFolder(FileAction action, const CStdString& strPath, const CStdString& strDestFile, FileOperationList &fileOperations, double &totalTime, XFILE::CDirectoryWalker &walker);
   bool DoProcessFile(FileAction action, const CStdString& strFileA, const CStdString& strFileB, FileOperationList &fileOperations, double &totalTime);
 
   static inline bool CanBeRenamed(const CStdString &strFileA, const CStdString &strFileB);
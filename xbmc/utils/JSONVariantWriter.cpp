@@ -19,50 +19,86 @@
  *
  */
 
-#include <locale>
+#include <locale.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
 
 #include "JSONVariantWriter.h"
 
 using namespace std;
 
-string CJSONVariantWriter::Write(const CVariant &value, bool compact)
+// yajl formats doubles with printf, which uses the decimal point of the
+// current locale. Format them here and fix the decimal point up instead of
+// switching the locale of the whole process while serializing.
+static bool WriteDouble(yajl_gen g, double value)
 {
-  string output;
+  // NaN and infinity have no JSON representation
+  if (value != value || value - value != 0)
+    return false;
+
+  // the shortest of the usual precisions that reads back as the same value
+  char number[40];
+  int length = sprintf(number, "%.15g", value);
+  if (length > 0 && strtod(number, NULL) != value)
+    length = sprintf(number, "%.17g", value);
+  if (length <= 0)
+    return false;
+
+  const char *point = localeconv()->decimal_point;
+  size_t pointLength = point ? strlen(point) : 0;
+  if (pointLength > 0 && strcmp(point, ".") != 0)
+  {
+    char *pos = strstr(number, point);
+    if (pos)
+    {
+      *pos = '.';
+      memmove(pos + 1, pos + pointLength, number + length - (pos + pointLength) + 1);
+      length -= pointLength - 1;
+    }
+  }
+
+  return yajl_gen_status_ok == yajl_gen_number(g, number, length);
+}
 
 #if YAJL_MAJOR == 2
-  yajl_gen g = yajl_gen_alloc(NULL);
-  yajl_gen_config(g, yajl_gen_beautify, compact ? 0 : 1);
-  yajl_gen_config(g, yajl_gen_indent_string, "\t");
+static void PrintCallback(void *ctx, const char *str, size_t len)
 #else
-  yajl_gen_config conf = { compact ? 0 : 1, "\t" };
-  yajl_gen g = yajl_gen_alloc(&conf, NULL);
+static void PrintCallback(void *ctx, const char *str, unsigned int len)
 #endif
+{
+  ((IJSONOutputStream *)ctx)->Write(str, len);
+}
 
-  // Set locale to classic ("C") to ensure valid JSON numbers
-  std::string currentLocale = setlocale(LC_NUMERIC, NULL);
-  setlocale(LC_NUMERIC, "C");
+string CJSONVariantWriter::Write(const CVariant &value, bool compact)
+{
+  string output;
+  CJSONStringOutputStream stream(output);
+  if (!Write(value, stream, compact))
+    output.clear();
 
-  if (InternalWrite(g, value))
-  {
-    const unsigned char * buffer;
+  return output;
+}
 
+bool CJSONVariantWriter::Write(const CVariant &value, IJSONOutputStream &stream, bool compact)
+{
+  // yajl hands every token straight to the stream instead of collecting
+  // the whole document in its own buffer first
 #if YAJL_MAJOR == 2
-    size_t length;
-    yajl_gen_get_buf(g, &buffer, &length);
+  yajl_gen g = yajl_gen_alloc(NULL);
+  yajl_gen_config(g, yajl_gen_beautify, compact ? 0 : 1);
+  yajl_gen_config(g, yajl_gen_indent_string, "\t");
+  yajl_gen_config(g, yajl_gen_print_callback, PrintCallback, &stream);
 #else
-    unsigned int length;
-    yajl_gen_get_buf(g, &buffer, &length);
+  yajl_gen_config conf = { compact ? 0 : 1, "\t" };
+  yajl_gen g = yajl_gen_alloc2(PrintCallback, &conf, NULL, &stream);
 #endif
-    output = string((const char *)buffer, length);
-  }
 
-  // Re-set locale to what it was before using yajl
-  setlocale(LC_NUMERIC, currentLocale.c_str());
+  bool success = InternalWrite(g, value);
 
-  yajl_gen_clear(g);
   yajl_gen_free(g);
 
-  return output;
+  return success;
 }
 
 bool CJSONVariantWriter::InternalWrite(yajl_gen g, const CVariant &value)
@@ -86,7 +122,7 @@ bool CJSONVariantWriter::InternalWrite(yajl_gen g, const CVariant &value)
 #endif
     break;
   case CVariant::VariantTypeDouble:
-    success = yajl_gen_status_ok == yajl_gen_double(g, value.asDouble());
+    success = WriteDouble(g, value.asDouble());
     break;
   case CVariant::VariantTypeBoolean:
     success = yajl_gen_status_ok == yajl_gen_bool(g, value.asBoolean() ? 1 : 0);
@@ -27,10 +27,34 @@
 #include <yajl/yajl_version.h>
 #endif
 
+/*!
+ \brief Sink for serialized JSON output
+
+ The writer hands the generated text to the stream piece by piece while it
+ walks the variant, so the complete document never has to exist as one
+ string unless the stream itself collects it.
+ */
+class IJSONOutputStream
+{
+public:
+  virtual ~IJSONOutputStream() { }
+  virtual void Write(const char *data, size_t length) = 0;
+};
+
+class CJSONStringOutputStream : public IJSONOutputStream
+{
+public:
+  CJSONStringOutputStream(std::string &output) : m_output(output) { }
+  virtual void Write(const char *data, size_t length) { m_output.append(data, length); }
+private:
+  std::string &m_output;
+};
+
 class CJSONVariantWriter
 {
 public:
   static std::string Write(const CVariant &value, bool compact);
+  static bool Write(const CVariant &value, IJSONOutputStream &stream, bool compact);
 private:
   static bool InternalWrite(yajl_gen g, const CVariant &value);
 };
@@ -0,0 +1,433 @@
+/*
+ *      Copyright (C) 2012 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+ *  http://www.gnu.org/copyleft/gpl.html
+ *
+ */
+
+
+#include "LibraryWatcher.h"
+#include "filesystem/File.h"
+#include "threads/SingleLock.h"
+#include "threads/SystemClock.h"
+#include "utils/Archive.h"
+#include "utils/log.h"
+
+#ifdef HAVE_INOTIFY
+#include <errno.h>
+#include <sys/inotify.h>
+#include <sys/vfs.h>
+#include <poll.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+using namespace XFILE;
+
+#define JOURNAL_FILE    "special://profile/Database/LibraryWatcher.dat"
+#define JOURNAL_VERSION 2
+#define JOURNAL_DELAY   5000 // ms without changes before the journal is rewritten
+
+#ifdef HAVE_INOTIFY
+#define WATCH_MASK (IN_CREATE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO | IN_CLOSE_WRITE | IN_ATTRIB | IN_DELETE_SELF | IN_MOVE_SELF)
+
+// file systems whose changes are made elsewhere and never show up as inotify events
+static bool IsNetworkFileSystem(const CStdString &path)
+{
+  struct statfs buf;
+  if (statfs(path.c_str(), &buf) != 0)
+    return true;
+
+  switch ((unsigned int)buf.f_type)
+  {
+    case 0x6969:     // NFS
+    case 0x517B:     // SMB
+    case 0xFF534D42: // CIFS
+    case 0xFE534D42: // SMB2
+    case 0x65735546: // FUSE (sshfs, curlftpfs, ...)
+    case 0x73757245: // CODA
+    case 0x5346414F: // AFS
+      return true;
+    default:
+      return false;
+  }
+}
+#endif
+
+CLibraryWatcher::CLibraryWatcher() : CThread("CLibraryWatcher")
+{
+  m_scanning = 0;
+  m_lastChange = 0;
+  m_journalDirty = false;
+  m_fd = -1;
+  m_initialized = false;
+  m_limitReached = false;
+}
+
+CLibraryWatcher::~CLibraryWatcher()
+{
+  StopWatching();
+}
+
+CLibraryWatcher &CLibraryWatcher::Get()
+{
+  static CLibraryWatcher sWatcher;
+  return sWatcher;
+}
+
+bool CLibraryWatcher::Initialize()
+{
+  if (m_initialized)
+    return m_fd >= 0;
+  m_initialized = true;
+
+#ifdef HAVE_INOTIFY
+  m_fd = inotify_init();
+  if (m_fd < 0)
+  {
+    CLog::Log(LOGWARNING, "%s - unable to initialize inotify (%i), library updates will hash all folders", __FUNCTION__, errno);
+    return false;
+  }
+
+  LoadJournal();
+  Create();
+  return true;
+#else
+  return false;
+#endif
+}
+
+void CLibraryWatcher::StopWatching()
+{
+  StopThread();
+
+  CSingleLock lock(m_critSection);
+  if (m_fd < 0)
+    return;
+
+  if (m_journalDirty)
+    SaveJournal();
+
+#ifdef HAVE_INOTIFY
+  close(m_fd);
+#endif
+  m_fd = -1;
+  m_watches.clear();
+  m_paths.clear();
+  m_journal.clear();
+}
+
+void CLibraryWatcher::BeginScan(Library library, set<CStdString> &paths)
+{
+  CSingleLock lock(m_critSection);
+  if (!Initialize())
+    return;
+
+  for (set<CStdString>::const_iterator it = paths.begin(); it != paths.end(); ++it)
+    AddWatch(library, *it);
+
+  // watch everything this library watched before the restart again, so a
+  // folder only keeps its trust if none of the folders below it changed.
+  // Parents sort before their subfolders, so a subfolder that can't be
+  // watched anymore takes the trust of its parents.
+  map<CStdString, CWatch> journal(m_journal);
+  for (map<CStdString, CWatch>::const_iterator it = journal.begin(); it != journal.end(); ++it)
+  {
+    if (it->second.libraries & library)
+      AddWatch(library, it->first);
+  }
+
+  // folders trusted now stay trusted unless they change while we scan,
+  // every other folder has to be processed by this scan first
+  for (map<CStdString, CWatch>::iterator it = m_watches.begin(); it != m_watches.end(); ++it)
+  {
+    CWatch &watch = it->second;
+    if (!(watch.libraries & library))
+      continue;
+
+    if (watch.trusted & library)
+      watch.pending |= library;
+    else
+    {
+      watch.pending &= ~library;
+      paths.insert(it->first);
+    }
+  }
+  m_scanning |= library;
+}
+
+void CLibraryWatcher::EndScan(Library library, bool completed)
+{
+  CSingleLock lock(m_critSection);
+  if (!(m_scanning & library))
+    return;
+  m_scanning &= ~library;
+
+  unsigned int trusted = 0;
+  for (map<CStdString, CWatch>::iterator it = m_watches.begin(); it != m_watches.end(); ++it)
+  {
+    CWatch &watch = it->second;
+    if (completed)
+      watch.trusted = (watch.trusted & ~library) | (watch.pending & library);
+    watch.pending &= ~library;
+    if (watch.trusted & library)
+      trusted++;
+  }
+
+  if (completed)
+  {
+    CLog::Log(LOGDEBUG, "%s - %u of %u watched folders unchanged since this scan", __FUNCTION__, trusted, (unsigned int)m_watches.size());
+    SaveJournal();
+  }
+}
+
+bool CLibraryWatcher::WatchDirectory(Library library, const CStdString &path)
+{
+  CSingleLock lock(m_critSection);
+  if (!(m_scanning & library))
+    return false;
+
+  if (!AddWatch(library, path))
+    return false;
+
+  m_watches[path].pending |= library;
+  return true;
+}
+
+void CLibraryWatcher::InvalidateDirectory(Library library, const CStdString &path)
+{
+  CSingleLock lock(m_critSection);
+  map<CStdString, CWatch>::iterator it = m_watches.find(path);
+  if (it == m_watches.end())
+    return;
+
+  if (it->second.trusted & library)
+    m_journalDirty = true;
+  it->second.trusted &= ~library;
+  it->second.pending &= ~library;
+}
+
+bool CLibraryWatcher::IsUnchanged(Library library, const CStdString &path)
+{
+  CSingleLock lock(m_critSection);
+  if (!(m_scanning & library))
+    return false;
+
+  map<CStdString, CWatch>::const_iterator it = m_watches.find(path);
+  return it != m_watches.end() && (it->second.trusted & library);
+}
+
+bool CLibraryWatcher::AddWatch(Library library, const CStdString &path)
+{
+  map<CStdString, CWatch>::iterator it = m_watches.find(path);
+  if (it != m_watches.end())
+  {
+    it->second.libraries |= library;
+    return true;
+  }
+
+#ifdef HAVE_INOTIFY
+  // only plain local folders, anything else keeps using the path hashes
+  int wd = -1;
+  struct __stat64 buffer;
+  if (m_fd >= 0 && !m_limitReached && !path.IsEmpty() && path[0] == '/' && !IsNetworkFileSystem(path) &&
+      CFile::Stat(path, &buffer) == 0)
+  {
+    wd = inotify_add_watch(m_fd, path.c_str(), WATCH_MASK | IN_ONLYDIR);
+    if (wd < 0 && errno == ENOSPC)
+    {
+      CLog::Log(LOGWARNING, "%s - inotify watch limit reached after %u folders, increase fs.inotify.max_user_watches to watch the whole library", __FUNCTION__, (unsigned int)m_watches.size());
+      m_limitReached = true;
+    }
+  }
+  if (wd < 0)
+  {
+    InvalidateParents(path);
+    return false;
+  }
+
+  CWatch &watch = m_watches[path];
+  watch.wd = wd;
+  watch.mtime = buffer.st_mtime;
+  watch.libraries = library;
+  m_paths[wd] = path;
+
+  // restore the trust from before the restart if nothing was added,
+  // removed or renamed in the folder in the meantime
+  map<CStdString, CWatch>::iterator journal = m_journal.find(path);
+  if (journal != m_journal.end())
+  {
+    if (journal->second.mtime == watch.mtime)
+    {
+      watch.trusted = journal->second.trusted;
+      watch.libraries |= journal->second.libraries;
+    }
+    m_journal.erase(journal);
+  }
+  return true;
+#else
+  return false;
+#endif
+}
+
+void CLibraryWatcher::Process()
+{
+#ifdef HAVE_INOTIFY
+  while (!m_bStop)
+  {
+    struct pollfd pfd;
+    pfd.fd = m_fd;
+    pfd.events = POLLIN;
+    pfd.revents = 0;
+
+    int ret = poll(&pfd, 1, 500);
+    if (ret > 0 && (pfd.revents & POLLIN))
+      ProcessEvents();
+    else if (ret < 0 && errno != EINTR)
+      break;
+
+    CSingleLock lock(m_critSection);
+    if (m_journalDirty && XbmcThreads::SystemClockMillis() - m_lastChange > JOURNAL_DELAY)
+      SaveJournal();
+  }
+#endif
+}
+
+void CLibraryWatcher::ProcessEvents()
+{
+#ifdef HAVE_INOTIFY
+  char buffer[16384] __attribute__ ((aligned(__alignof__(struct inotify_event))));
+  ssize_t length = read(m_fd, buffer, sizeof(buffer));
+  if (length <= 0)
+    return;
+
+  CSingleLock lock(m_critSection);
+  for (char *ptr = buffer; ptr < buffer + length; )
+  {
+    const struct inotify_event *event = (const struct inotify_event *)ptr;
+    ptr += sizeof(struct inotify_event) + event->len;
+
+    if (event->mask & IN_Q_OVERFLOW)
+    { // events were lost, nothing can be trusted anymore
+      CLog::Log(LOGWARNING, "%s - inotify queue overflow, next library update will check all folders", __FUNCTION__);
+      for (map<CStdString, CWatch>::iterator it = m_watches.begin(); it != m_watches.end(); ++it)
+        Invalidate(it->second);
+      continue;
+    }
+
+    map<int, CStdString>::iterator path = m_paths.find(event->wd);
+    if (path == m_paths.end())
+      continue;
+
+    if (event->mask & IN_IGNORED)
+    { // folder was removed or unmounted, the scanner will notice it's gone
+      InvalidateParents(path->second);
+      m_watches.erase(path->second);
+      m_paths.erase(path);
+      m_journalDirty = true;
+      continue;
+    }
+
+    Invalidate(m_watches[path->second]);
+  }
+  m_lastChange = XbmcThreads::SystemClockMillis();
+#endif
+}
+
+void CLibraryWatcher::Invalidate(CWatch &watch)
+{
+  if (watch.trusted)
+    m_journalDirty = true;
+  watch.trusted = 0;
+  watch.pending = 0;
+}
+
+void CLibraryWatcher::InvalidateParents(const CStdString &path)
+{
+  // the scanners skip everything below an unchanged folder, so a folder
+  // can't be trusted while anything below it isn't watched
+  size_t pos = path.size() > 1 ? path.rfind('/', path.size() - 2) : CStdString::npos;
+  for (; pos != CStdString::npos; pos = pos > 0 ? path.rfind('/', pos - 1) : CStdString::npos)
+  {
+    map<CStdString, CWatch>::iterator it = m_watches.find(path.Left(pos + 1));
+    if (it != m_watches.end())
+      Invalidate(it->second);
+  }
+}
+
+void CLibraryWatcher::LoadJournal()
+{
+  CFile file;
+  if (!file.Open(JOURNAL_FILE))
+    return;
+
+  CArchive ar(&file, CArchive::load);
+  int version = 0;
+  unsigned int count = 0;
+  ar >> version;
+  if (version == JOURNAL_VERSION)
+  {
+    ar >> count;
+    for (unsigned int i = 0; i < count; i++)
+    {
+      CStdString path;
+      CWatch watch;
+      ar >> path;
+      ar >> watch.mtime;
+      ar >> watch.libraries;
+      ar >> watch.trusted;
+      if (!path.IsEmpty())
+        m_journal[path] = watch;
+    }
+  }
+  ar.Close();
+  file.Close();
+
+  CLog::Log(LOGDEBUG, "%s - restored %u folders", __FUNCTION__, (unsigned int)m_journal.size());
+}
+
+void CLibraryWatcher::SaveJournal()
+{
+  m_journalDirty = false;
+
+  // folders not watched again since the restart keep their old state. Folders
+  // that aren't trusted are kept as well, as they have to be watched again
+  // before any folder above them can be trusted.
+  map<CStdString, CWatch> entries(m_journal);
+  for (map<CStdString, CWatch>::const_iterator it = m_watches.begin(); it != m_watches.end(); ++it)
+    entries[it->first] = it->second;
+
+  CFile file;
+  if (!file.OpenForWrite(JOURNAL_FILE, true))
+  {
+    CLog::Log(LOGERROR, "%s - unable to write %s", __FUNCTION__, JOURNAL_FILE);
+    return;
+  }
+
+  CArchive ar(&file, CArchive::store);
+  ar << (int)JOURNAL_VERSION;
+  ar << (unsigned int)entries.size();
+  for (map<CStdString, CWatch>::const_iterator it = entries.begin(); it != entries.end(); ++it)
+  {
+    ar << it->first;
+    ar << it->second.mtime;
+    ar << it->second.libraries;
+    ar << it->second.trusted;
+  }
+  ar.Close();
+  file.Close();
+}
@@ -0,0 +1,136 @@
+#pragma once
+/*
+ *      Copyright (C) 2012 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+ *  http://www.gnu.org/copyleft/gpl.html
+ *
+ */
+
+
+#include "StdString.h"
+#include "threads/CriticalSection.h"
+#include "threads/Thread.h"
+
+#include <map>
+#include <set>
+
+/*!
+ \brief Watches local library folders for changes between scans
+
+ The video and music scanners register every local folder they visit. On
+ platforms with inotify the watcher then records which folders changed, so
+ a full library update only has to look at the folders that changed since
+ the last completed scan instead of listing and hashing every folder again.
+ Folders that are not watched (network shares, network mounts, no inotify,
+ watch limit reached) are never reported as unchanged and fall back to the
+ path hashes. As the scanners skip everything below an unchanged folder,
+ neither are the folders above them.
+
+ The trust state is written to a journal after every completed scan and
+ restored on the next start for folders whose modification time did not
+ change in the meantime.
+ */
+class CLibraryWatcher : public CThread
+{
+public:
+  enum Library
+  {
+    LibraryVideo = 0x01,
+    LibraryMusic = 0x02
+  };
+
+  static CLibraryWatcher &Get();
+
+  /*!
+   \brief Start a full scan of the given library
+   Watches the folders the scan starts from and adds the watched folders
+   of this library that changed since its last completed scan, as they may
+   not be reached otherwise when their parent is skipped.
+   \param library the library being scanned
+   \param paths [in/out] folders the scan will process
+   */
+  void BeginScan(Library library, std::set<CStdString> &paths);
+
+  /*!
+   \brief Finish the scan started with BeginScan()
+   \param library the library that was scanned
+   \param completed true if every folder was processed, false if the scan was cancelled
+   */
+  void EndScan(Library library, bool completed);
+
+  /*!
+   \brief Watch a folder the scanner is about to process
+   Must be called before the folder is listed or hashed so that changes
+   during the scan are not missed, and the scan must either go on into its
+   subfolders or skip the folder together with them. The folder is trusted
+   after the scan completes.
+   \return true if the folder is watched, in which case its subfolders have to be listed after they are watched as well
+   */
+  bool WatchDirectory(Library library, const CStdString &path);
+
+  /*!
+   \brief Don't trust a folder the running scan failed to process
+   The folder is processed again by the next scan even if it doesn't change.
+   */
+  void InvalidateDirectory(Library library, const CStdString &path);
+
+  /*!
+   \brief Check whether a folder is known to be unchanged since the last completed scan
+   Always false outside of a scan started with BeginScan().
+   */
+  bool IsUnchanged(Library library, const CStdString &path);
+
+  void StopWatching();
+
+protected:
+  virtual void Process();
+
+private:
+  CLibraryWatcher();
+  virtual ~CLibraryWatcher();
+
+  class CWatch
+  {
+  public:
+    CWatch() : wd(-1), mtime(0), libraries(0), trusted(0), pending(0) {};
+    int wd;
+    int64_t mtime;          ///< modification time of the folder when the watch was added
+    unsigned int libraries; ///< libraries that watch this folder
+    unsigned int trusted;   ///< libraries for which the folder is unchanged since their last scan
+    unsigned int pending;   ///< libraries for which the folder will be trusted once the running scan completes
+  };
+
+  bool Initialize();
+  bool AddWatch(Library library, const CStdString &path);
+  void ProcessEvents();
+  void Invalidate(CWatch &watch);
+  void InvalidateParents(const CStdString &path);
+  void RemoveWatch(int wd);
+  void LoadJournal();
+  void SaveJournal();
+
+  CCriticalSection m_critSection;
+  std::map<CStdString, CWatch> m_watches;
+  std::map<int, CStdString> m_paths;
+  std::map<CStdString, CWatch> m_journal;
+  unsigned int m_scanning;
+  unsigned int m_lastChange;
+  bool m_journalDirty;
+  int m_fd;
+  bool m_initialized;
+  bool m_limitReached;
+};
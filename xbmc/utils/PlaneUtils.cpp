@@ -0,0 +1,213 @@
+/*
+ *      Copyright (C) 2012 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+ *  http://www.gnu.org/copyleft/gpl.html
+ *
+ */
+
+
+#include <string.h>
+
+#include "PlaneUtils.h"
+#include "fastmemcpy.h"
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+#ifdef __ARM_NEON__
+#include <arm_neon.h>
+#endif
+
+// the SSE2 kernels are only built when the compiler targets SSE2 itself
+// (always on x86-64), so the rest of the binary requires it already.
+
+// planes bigger than this are written with non-temporal stores, they would
+// only evict the decoder's working set from the cache otherwise.
+#define STREAMING_COPY_THRESHOLD (512 * 1024)
+
+#ifdef __SSE2__
+static void CopyRowStreamSSE2(uint8_t *d, const uint8_t *s, int w)
+{
+  // d must be 16 byte aligned
+  int x = 0;
+  for (; x + 64 <= w; x += 64)
+  {
+    __m128i a = _mm_loadu_si128((const __m128i*)(s + x));
+    __m128i b = _mm_loadu_si128((const __m128i*)(s + x + 16));
+    __m128i c = _mm_loadu_si128((const __m128i*)(s + x + 32));
+    __m128i e = _mm_loadu_si128((const __m128i*)(s + x + 48));
+    _mm_stream_si128((__m128i*)(d + x),      a);
+    _mm_stream_si128((__m128i*)(d + x + 16), b);
+    _mm_stream_si128((__m128i*)(d + x + 32), c);
+    _mm_stream_si128((__m128i*)(d + x + 48), e);
+  }
+  for (; x + 16 <= w; x += 16)
+    _mm_stream_si128((__m128i*)(d + x), _mm_loadu_si128((const __m128i*)(s + x)));
+  if (x < w)
+    memcpy(d + x, s + x, w - x);
+}
+#endif
+
+void CPlaneUtils::CopyPlane(uint8_t *d, int dstStride, const uint8_t *s, int srcStride, int w, int h)
+{
+  if (w <= 0 || h <= 0)
+    return;
+
+#ifdef __SSE2__
+  if (w * h >= STREAMING_COPY_THRESHOLD
+  && ((uintptr_t)d & 15) == 0 && (dstStride & 15) == 0)
+  {
+    for (int y = 0; y < h; y++)
+    {
+      CopyRowStreamSSE2(d, s, w);
+      s += srcStride;
+      d += dstStride;
+    }
+    _mm_sfence();
+    return;
+  }
+#endif
+
+  CopyPlaneC(d, dstStride, s, srcStride, w, h);
+}
+
+void CPlaneUtils::CopyPlaneC(uint8_t *d, int dstStride, const uint8_t *s, int srcStride, int w, int h)
+{
+  if (w <= 0 || h <= 0)
+    return;
+
+  if (w == srcStride && w == dstStride)
+  {
+    fast_memcpy(d, s, w * h);
+    return;
+  }
+
+  for (int y = 0; y < h; y++)
+  {
+    fast_memcpy(d, s, w);
+    s += srcStride;
+    d += dstStride;
+  }
+}
+
+void CPlaneUtils::InterleaveUVRow(uint8_t *d, const uint8_t *u, const uint8_t *v, int w)
+{
+  int x = 0;
+#if defined(__SSE2__)
+  for (; x + 16 <= w; x += 16)
+  {
+    __m128i mu = _mm_loadu_si128((const __m128i*)(u + x));
+    __m128i mv = _mm_loadu_si128((const __m128i*)(v + x));
+    _mm_storeu_si128((__m128i*)(d + x * 2),      _mm_unpacklo_epi8(mu, mv));
+    _mm_storeu_si128((__m128i*)(d + x * 2 + 16), _mm_unpackhi_epi8(mu, mv));
+  }
+#elif defined(__ARM_NEON__)
+  for (; x + 16 <= w; x += 16)
+  {
+    uint8x16x2_t uv;
+    uv.val[0] = vld1q_u8(u + x);
+    uv.val[1] = vld1q_u8(v + x);
+    vst2q_u8(d + x * 2, uv);
+  }
+#endif
+  InterleaveUVRowC(d + x * 2, u + x, v + x, w - x);
+}
+
+void CPlaneUtils::InterleaveUVRowC(uint8_t *d, const uint8_t *u, const uint8_t *v, int w)
+{
+  for (int x = 0; x < w; x++)
+  {
+    d[x * 2]     = u[x];
+    d[x * 2 + 1] = v[x];
+  }
+}
+
+void CPlaneUtils::PackYUV422Row(uint8_t *d, const uint8_t *y, const uint8_t *u, const uint8_t *v, int w, bool uyvy)
+{
+  int x = 0;
+#if defined(__SSE2__)
+  for (; x + 16 <= w; x += 16)
+  {
+    __m128i my  = _mm_loadu_si128((const __m128i*)(y + x));
+    __m128i muv = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i*)(u + x / 2)),
+                                    _mm_loadl_epi64((const __m128i*)(v + x / 2)));
+    if (uyvy)
+    {
+      _mm_storeu_si128((__m128i*)(d + x * 2),      _mm_unpacklo_epi8(muv, my));
+      _mm_storeu_si128((__m128i*)(d + x * 2 + 16), _mm_unpackhi_epi8(muv, my));
+    }
+    else
+    {
+      _mm_storeu_si128((__m128i*)(d + x * 2),      _mm_unpacklo_epi8(my, muv));
+      _mm_storeu_si128((__m128i*)(d + x * 2 + 16), _mm_unpackhi_epi8(my, muv));
+    }
+  }
+#elif defined(__ARM_NEON__)
+  for (; x + 16 <= w; x += 16)
+  {
+    uint8x8x2_t my = vuzp_u8(vld1_u8(y + x), vld1_u8(y + x + 8));
+    uint8x8x4_t px;
+    if (uyvy)
+    {
+      px.val[0] = vld1_u8(u + x / 2);
+      px.val[1] = my.val[0];
+      px.val[2] = vld1_u8(v + x / 2);
+      px.val[3] = my.val[1];
+    }
+    else
+    {
+      px.val[0] = my.val[0];
+      px.val[1] = vld1_u8(u + x / 2);
+      px.val[2] = my.val[1];
+      px.val[3] = vld1_u8(v + x / 2);
+    }
+    vst4_u8(d + x * 2, px);
+  }
+#endif
+  PackYUV422RowC(d + x * 2, y + x, u + x / 2, v + x / 2, w - x, uyvy);
+}
+
+void CPlaneUtils::PackYUV422RowC(uint8_t *d, const uint8_t *y, const uint8_t *u, const uint8_t *v, int w, bool uyvy)
+{
+  for (int x = 0; x + 1 < w; x += 2)
+  {
+    uint8_t *p = d + x * 2;
+    if (uyvy)
+    {
+      p[0] = u[x / 2]; p[1] = y[x]; p[2] = v[x / 2]; p[3] = y[x + 1];
+    }
+    else
+    {
+      p[0] = y[x]; p[1] = u[x / 2]; p[2] = y[x + 1]; p[3] = v[x / 2];
+    }
+  }
+
+  // the last pixel of an odd row only has room for its Y and U samples
+  if (w > 0 && (w & 1))
+  {
+    uint8_t *p = d + (w - 1) * 2;
+    if (uyvy)
+    {
+      p[0] = u[w / 2]; p[1] = y[w - 1];
+    }
+    else
+    {
+      p[0] = y[w - 1]; p[1] = u[w / 2];
+    }
+  }
+}
@@ -0,0 +1,56 @@
+#pragma once
+/*
+ *      Copyright (C) 2012 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+ *  http://www.gnu.org/copyleft/gpl.html
+ *
+ */
+
+
+#include <stdint.h>
+
+/*!
+ \brief Copy and repack the planes of decoded video pictures
+
+ The functions use SSE2 or NEON kernels where the build targets them and finish
+ the rows with plain C. The C versions are always available, so the
+ vectorized ones can be checked against them.
+ */
+class CPlaneUtils
+{
+public:
+  /*!
+   \brief Copy a width x height byte plane between buffers with (possibly) different strides
+   */
+  static void CopyPlane(uint8_t *dst, int dstStride, const uint8_t *src, int srcStride, int width, int height);
+
+  /*!
+   \brief Interleave a row of separate U and V samples into packed UV (NV12)
+   \param width the number of U (and V) samples
+   */
+  static void InterleaveUVRow(uint8_t *dst, const uint8_t *u, const uint8_t *v, int width);
+
+  /*!
+   \brief Pack a row of planar 4:2:0 into YUYV or UYVY
+   \param width the luma width, a trailing odd pixel gets its Y and U samples only
+   */
+  static void PackYUV422Row(uint8_t *dst, const uint8_t *y, const uint8_t *u, const uint8_t *v, int width, bool uyvy);
+
+  static void CopyPlaneC(uint8_t *dst, int dstStride, const uint8_t *src, int srcStride, int width, int height);
+  static void InterleaveUVRowC(uint8_t *dst, const uint8_t *u, const uint8_t *v, int width);
+  static void PackYUV422RowC(uint8_t *dst, const uint8_t *y, const uint8_t *u, const uint8_t *v, int width, bool uyvy);
+};
@@ -0,0 +1,81 @@
+/*
+ *      Copyright (C) 2012 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+ *  http://www.gnu.org/copyleft/gpl.html
+ *
+ */
+
+
+#include "ReadAheadEstimator.h"
+
+// transfer samples are collected until they cover this many ms, shorter
+// ones are dominated by the granularity of the clock
+#define MIN_SAMPLE_TIME 100
+
+// new samples count for a quarter of the smoothed value
+static unsigned int Smooth(unsigned int average, unsigned int sample)
+{
+  if (average == 0)
+    return sample;
+  return (unsigned int)(((int64_t)average * 3 + sample) / 4);
+}
+
+CReadAheadEstimator::CReadAheadEstimator(unsigned int minimum, unsigned int maximum)
+{
+  m_minimum = minimum;
+  m_maximum = maximum;
+  m_latency = 0;
+  m_bandwidth = 0;
+  m_pendingBytes = 0;
+  m_pendingTime = 0;
+}
+
+void CReadAheadEstimator::AddLatency(unsigned int latency)
+{
+  if (latency > 0)
+    m_latency = Smooth(m_latency, latency);
+}
+
+void CReadAheadEstimator::AddTransfer(int64_t bytes, unsigned int time)
+{
+  if (bytes <= 0)
+    return;
+
+  m_pendingBytes += bytes;
+  m_pendingTime += time;
+  if (m_pendingTime < MIN_SAMPLE_TIME)
+    return;
+
+  int64_t bandwidth = m_pendingBytes * 1000 / m_pendingTime;
+  m_bandwidth = Smooth(m_bandwidth, bandwidth > 0xFFFFFFFF ? 0xFFFFFFFF : (unsigned int)bandwidth);
+  m_pendingBytes = 0;
+  m_pendingTime = 0;
+}
+
+unsigned int CReadAheadEstimator::GetReadThroughSize() const
+{
+  int64_t bdp = (int64_t)m_bandwidth * m_latency / 1000;
+  return bdp < m_maximum ? (unsigned int)bdp : m_maximum;
+}
+
+unsigned int CReadAheadEstimator::GetReadAheadSize() const
+{
+  unsigned int size = GetReadThroughSize();
+  if (size < m_minimum)
+    return m_minimum;
+  return size;
+}
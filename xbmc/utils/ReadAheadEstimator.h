@@ -0,0 +1,83 @@
+#pragma once
+/*
+ *      Copyright (C) 2012 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+ *  http://www.gnu.org/copyleft/gpl.html
+ *
+ */
+
+
+#include <stdint.h>
+
+/*!
+ \brief Sizes the read-ahead of a network stream from its latency and bandwidth
+
+ Latency is the time to the first byte of a request, bandwidth the rate at
+ which data comes in while waiting on the network. Both are smoothed over
+ the samples added. Their product is how much data the link delivers in the
+ time a new request takes to get going: gaps up to that size are cheaper to
+ read through than to request anew, and a sequential reader has to fetch at
+ least that far ahead to keep the link busy.
+ */
+class CReadAheadEstimator
+{
+public:
+  /*!
+   \param minimum the read-ahead size to use until the link is known, and never go below
+   \param maximum the largest read-ahead and read-through size to hand out
+   */
+  CReadAheadEstimator(unsigned int minimum, unsigned int maximum);
+
+  void SetMinimum(unsigned int minimum) { m_minimum = minimum; }
+
+  /*!
+   \brief Add the time a request took until its first byte came in
+   \param latency time to the first byte in ms
+   */
+  void AddLatency(unsigned int latency);
+
+  /*!
+   \brief Add data that came in while waiting on the network
+   Samples are collected until they cover enough time to give a rate.
+   \param bytes the amount of data received
+   \param time the time spent waiting for it in ms
+   */
+  void AddTransfer(int64_t bytes, unsigned int time);
+
+  unsigned int GetLatency() const { return m_latency; }     ///< smoothed latency in ms, 0 if unknown
+  unsigned int GetBandwidth() const { return m_bandwidth; } ///< smoothed bandwidth in bytes per second, 0 if unknown
+
+  /*!
+   \brief Largest forward gap that is cheaper to read through than to request anew
+   \return the bandwidth-delay product, at most the maximum, 0 while the link is unknown
+   */
+  unsigned int GetReadThroughSize() const;
+
+  /*!
+   \brief How far ahead to fetch
+   \return the bandwidth-delay product, within the minimum and the maximum
+   */
+  unsigned int GetReadAheadSize() const;
+
+private:
+  unsigned int m_minimum;
+  unsigned int m_maximum;
+  unsigned int m_latency;
+  unsigned int m_bandwidth;
+  int64_t      m_pendingBytes; ///< transfer samples not yet in m_bandwidth
+  unsigned int m_pendingTime;
+};
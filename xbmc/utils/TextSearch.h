@@ -39,6 +39,16 @@ public:
   bool Search(const CStdString &strHaystack) const;
   bool IsValid(void) const;
 
+  /*!
+   * @return The terms that all have to be present in a match.
+   */
+  const std::vector<CStdString> &GetAndTerms(void) const { return m_AND; }
+
+  /*!
+   * @return The terms of which at least one has to be present in a match.
+   */
+  const std::vector<CStdString> &GetOrTerms(void) const { return m_OR; }
+
 private:
   void GetAndCutNextTerm(CStdString &strSearchTerm, CStdString &strNextTerm);
   void ExtractSearchTerms(const CStdString &strSearchTerm, TextSearchDefault defaultSearchMode);
@@ -0,0 +1,90 @@
+/*
+ *      Copyright (C) 2012 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+ *  http://www.gnu.org/copyleft/gpl.html
+ *
+ */
+
+
+#include "utils/ReadAheadEstimator.h"
+
+#include <boost/test/unit_test.hpp>
+
+BOOST_AUTO_TEST_CASE(TestReadAheadUnknownLink)
+{
+  CReadAheadEstimator estimator(32768, 2*1024*1024);
+  BOOST_CHECK_EQUAL(estimator.GetReadThroughSize(), 0u);
+  BOOST_CHECK_EQUAL(estimator.GetReadAheadSize(), 32768u);
+
+  // latency alone doesn't tell how much data is in flight
+  estimator.AddLatency(200);
+  BOOST_CHECK_EQUAL(estimator.GetReadAheadSize(), 32768u);
+}
+
+BOOST_AUTO_TEST_CASE(TestReadAheadBandwidthDelayProduct)
+{
+  CReadAheadEstimator estimator(32768, 2*1024*1024);
+  estimator.AddLatency(200);
+  estimator.AddTransfer(1000000, 1000);
+  BOOST_CHECK_EQUAL(estimator.GetLatency(), 200u);
+  BOOST_CHECK_EQUAL(estimator.GetBandwidth(), 1000000u);
+  BOOST_CHECK_EQUAL(estimator.GetReadThroughSize(), 200000u);
+  BOOST_CHECK_EQUAL(estimator.GetReadAheadSize(), 200000u);
+
+  // a fast local link stays at the minimum
+  estimator.SetMinimum(512*1024);
+  BOOST_CHECK_EQUAL(estimator.GetReadThroughSize(), 200000u);
+  BOOST_CHECK_EQUAL(estimator.GetReadAheadSize(), 512u*1024);
+}
+
+BOOST_AUTO_TEST_CASE(TestReadAheadMaximum)
+{
+  CReadAheadEstimator estimator(32768, 2*1024*1024);
+  estimator.AddLatency(2000);
+  estimator.AddTransfer(100*1024*1024, 1000);
+  BOOST_CHECK_EQUAL(estimator.GetReadThroughSize(), 2u*1024*1024);
+  BOOST_CHECK_EQUAL(estimator.GetReadAheadSize(), 2u*1024*1024);
+}
+
+BOOST_AUTO_TEST_CASE(TestReadAheadSmoothing)
+{
+  CReadAheadEstimator estimator(0, 2*1024*1024);
+  estimator.AddLatency(100);
+  estimator.AddLatency(500);
+  BOOST_CHECK_EQUAL(estimator.GetLatency(), 200u);
+
+  estimator.AddTransfer(400000, 1000);
+  estimator.AddTransfer(800000, 1000);
+  BOOST_CHECK_EQUAL(estimator.GetBandwidth(), 500000u);
+
+  // empty reads and failed connects don't count
+  estimator.AddLatency(0);
+  estimator.AddTransfer(0, 1000);
+  BOOST_CHECK_EQUAL(estimator.GetLatency(), 200u);
+  BOOST_CHECK_EQUAL(estimator.GetBandwidth(), 500000u);
+}
+
+BOOST_AUTO_TEST_CASE(TestReadAheadShortSamples)
+{
+  CReadAheadEstimator estimator(0, 2*1024*1024);
+  for (int i = 0; i < 9; i++)
+    estimator.AddTransfer(10000, 10);
+  BOOST_CHECK_EQUAL(estimator.GetBandwidth(), 0u);
+
+  estimator.AddTransfer(10000, 10);
+  BOOST_CHECK_EQUAL(estimator.GetBandwidth(), 1000000u);
+}
@@ -65,19 +65,35 @@ using namespace PVR;
 
 //********************************************************************************************************************************
 CVideoDatabase::CVideoDatabase(void)
+  : m_pathCache("path"), m_genreCache("genre"), m_studioCache("studio"),
+    m_countryCache("country"), m_setCache("sets"), m_actorCache("actors")
 {
 }
 
 //********************************************************************************************************************************
 CVideoDatabase::~CVideoDatabase(void)
-{}
+{
+  EmptyCache();
+}
 
 //********************************************************************************************************************************
 bool CVideoDatabase::Open()
 {
+  // another client may have changed a shared database while we were closed
+  EmptyCache();
   return CDatabase::Open(g_advancedSettings.m_databaseVideo);
 }
 
+void CVideoDatabase::EmptyCache()
+{
+  m_pathCache.Clear();
+  m_genreCache.Clear();
+  m_studioCache.Clear();
+  m_countryCache.Clear();
+  m_setCache.Clear();
+  m_actorCache.Clear();
+}
+
 bool CVideoDatabase::CreateTables()
 {
   /* indexes should be added on any columns that are used in in  */
@@ -586,9 +602,16 @@ int CVideoDatabase::AddPath(const CStdString& strPath, const CStdString &strDate
   CStdString strSQL;
   try
   {
-    int idPath = GetPathId(strPath);
+    int idPath;
+    if (m_pathCache.Get(strPath, idPath))
+      return idPath;
+
+    idPath = GetPathId(strPath);
     if (idPath >= 0)
+    {
+      m_pathCache.Set(strPath, idPath);
       return idPath; // already have the path
+    }
 
     if (NULL == m_pDB.get()) return -1;
     if (NULL == m_pDS.get()) return -1;
@@ -606,6 +629,7 @@ int CVideoDatabase::AddPath(const CStdString& strPath, const CStdString &strDate
       strSQL=PrepareSQL("insert into path (idPath, strPath, strContent, strScraper) values (NULL,'%s','','')", strPath1.c_str());
     m_pDS->exec(strSQL.c_str());
     idPath = (int)m_pDS->lastinsertid();
+    m_pathCache.Set(strPath, idPath);
     return idPath;
   }
   catch (...)
@@ -1216,13 +1240,17 @@ int CVideoDatabase::AddMusicVideo(const CStdString& strFilenameAndPath)
 }
 
 //********************************************************************************************************************************
-int CVideoDatabase::AddToTable(const CStdString& table, const CStdString& firstField, const CStdString& secondField, const CStdString& value)
+int CVideoDatabase::AddToTable(const CStdString& table, const CStdString& firstField, const CStdString& secondField, const CStdString& value, CDatabaseIdCache &cache)
 {
   try
   {
     if (NULL == m_pDB.get()) return -1;
     if (NULL == m_pDS.get()) return -1;
 
+    int id;
+    if (cache.Get(value, id))
+      return id;
+
     CStdString strSQL = PrepareSQL("select %s from %s where %s like '%s'", firstField.c_str(), table.c_str(), secondField.c_str(), value.c_str());
     m_pDS->query(strSQL.c_str());
     if (m_pDS->num_rows() == 0)
@@ -1231,15 +1259,15 @@ int CVideoDatabase::AddToTable(const CStdString& table, const CStdString& firstF
       // doesnt exists, add it
       strSQL = PrepareSQL("insert into %s (%s, %s) values( NULL, '%s')", table.c_str(), firstField.c_str(), secondField.c_str(), value.c_str());
       m_pDS->exec(strSQL.c_str());
-      int id = (int)m_pDS->lastinsertid();
-      return id;
+      id = (int)m_pDS->lastinsertid();
     }
     else
     {
-      int id = m_pDS->fv(firstField).get_asInt();
+      id = m_pDS->fv(firstField).get_asInt();
       m_pDS->close();
-      return id;
     }
+    cache.Set(value, id);
+    return id;
   }
   catch (...)
   {
@@ -1251,23 +1279,23 @@ int CVideoDatabase::AddToTable(const CStdString& table, const CStdString& firstF
 
 int CVideoDatabase::AddSet(const CStdString& strSet)
 {
-  return AddToTable("sets", "idSet", "strSet", strSet);
+  return AddToTable("sets", "idSet", "strSet", strSet, m_setCache);
 }
 
 int CVideoDatabase::AddGenre(const CStdString& strGenre)
 {
-  return AddToTable("genre", "idGenre", "strGenre", strGenre);
+  return AddToTable("genre", "idGenre", "strGenre", strGenre, m_genreCache);
 }
 
 int CVideoDatabase::AddStudio(const CStdString& strStudio)
 {
-  return AddToTable("studio", "idStudio", "strStudio", strStudio);
+  return AddToTable("studio", "idStudio", "strStudio", strStudio, m_studioCache);
 }
 
 //********************************************************************************************************************************
 int CVideoDatabase::AddCountry(const CStdString& strCountry)
 {
-  return AddToTable("country", "idCountry", "strCountry", strCountry);
+  return AddToTable("country", "idCountry", "strCountry", strCountry, m_countryCache);
 }
 
 int CVideoDatabase::AddActor(const CStdString& strActor, const CStdString& thumbURLs, const CStdString &thumb)
@@ -1277,7 +1305,21 @@ int CVideoDatabase::AddActor(const CStdString& strActor, const CStdString& thumb
     if (NULL == m_pDB.get()) return -1;
     if (NULL == m_pDS.get()) return -1;
     int idActor = -1;
-    CStdString strSQL=PrepareSQL("select idActor from actors where strActor like '%s'", strActor.c_str());
+    CStdString strSQL;
+    if (m_actorCache.Get(strActor, idActor))
+    {
+      // update the thumb url's
+      if (!thumbURLs.IsEmpty())
+      {
+        strSQL=PrepareSQL("update actors set strThumb='%s' where idActor=%i",thumbURLs.c_str(),idActor);
+        m_pDS->exec(strSQL.c_str());
+      }
+      if (!thumb.IsEmpty())
+        SetArtForItem(idActor, "actor", "thumb", thumb);
+      return idActor;
+    }
+
+    strSQL=PrepareSQL("select idActor from actors where strActor like '%s'", strActor.c_str());
     m_pDS->query(strSQL.c_str());
     if (m_pDS->num_rows() == 0)
     {
@@ -1298,6 +1340,7 @@ int CVideoDatabase::AddActor(const CStdString& strActor, const CStdString& thumb
         m_pDS->exec(strSQL.c_str());
       }
     }
+    m_actorCache.Set(strActor, idActor);
     // add artwork
     if (!thumb.IsEmpty())
       SetArtForItem(idActor, "actor", "thumb", thumb);
@@ -2804,6 +2847,7 @@ void CVideoDatabase::DeleteSet(int idSet)
     CStdString strSQL;
     strSQL=PrepareSQL("delete from sets where idSet=%i", idSet);
     m_pDS->exec(strSQL.c_str());
+    m_setCache.Remove(idSet);
     strSQL=PrepareSQL("delete from setlinkmovie where idSet=%i", idSet);
     m_pDS->exec(strSQL.c_str());
   }
@@ -7344,6 +7388,9 @@ void CVideoDatabase::CleanDatabase(IVideoInfoScannerObserver* pObserver, const s
     unsigned int time = XbmcThreads::SystemClockMillis();
     CLog::Log(LOGNOTICE, "%s: Starting videodatabase cleanup ..", __FUNCTION__);
 
+    // cached ids may refer to rows removed below
+    EmptyCache();
+
     BeginTransaction();
 
     // find all the files
@@ -20,6 +20,7 @@
  *
  */
 #include "dbwrappers/Database.h"
+#include "dbwrappers/DatabaseIdCache.h"
 #include "VideoInfoTag.h"
 #include "addons/Scraper.h"
 #include "Bookmark.h"
@@ -695,7 +696,7 @@ protected:
    */
   int GetFileId(const CStdString& url);
 
-  int AddToTable(const CStdString& table, const CStdString& firstField, const CStdString& secondField, const CStdString& value);
+  int AddToTable(const CStdString& table, const CStdString& firstField, const CStdString& secondField, const CStdString& value, CDatabaseIdCache &cache);
   int AddGenre(const CStdString& strGenre1);
   int AddActor(const CStdString& strActor, const CStdString& thumbURL, const CStdString &thumb = "");
   int AddCountry(const CStdString& strCountry);
@@ -757,6 +758,18 @@ protected:
   CStdString GetValueString(const CVideoInfoTag &details, int min, int max, const SDbTableOffsets *offsets) const;
   bool GetStreamDetails(CVideoInfoTag& tag) const;
 
+  /*! \brief Drop all cached lookup table ids
+   Must be called whenever rows of the cached tables may have been deleted.
+   */
+  void EmptyCache();
+
+  CDatabaseIdCache m_pathCache;
+  CDatabaseIdCache m_genreCache;
+  CDatabaseIdCache m_studioCache;
+  CDatabaseIdCache m_countryCache;
+  CDatabaseIdCache m_setCache;
+  CDatabaseIdCache m_actorCache;
+
 private:
   virtual bool CreateTables();
   virtual bool UpdateOldVersion(int version);
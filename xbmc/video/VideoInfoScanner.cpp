@@ -24,6 +24,7 @@
 #include "VideoInfoScanner.h"
 #include "addons/AddonManager.h"
 #include "filesystem/DirectoryCache.h"
+#include "filesystem/DirectoryWalker.h"
 #include "Util.h"
 #include "NfoFile.h"
 #include "utils/RegExp.h"
@@ -46,6 +47,7 @@
 #include "utils/log.h"
 #include "utils/URIUtils.h"
 #include "utils/Variant.h"
+#include "utils/LibraryWatcher.h"
 #include "ThumbLoader.h"
 #include "TextureCache.h"
 
@@ -98,6 +100,7 @@ namespace VIDEO
       m_bCanInterrupt = false;
 
       bool bCancelled = false;
+      CDirectoryWalker walker(g_settings.m_videoExtensions);
       while (!bCancelled && m_pathsToScan.size())
       {
         /*
@@ -107,10 +110,12 @@ namespace VIDEO
          * occurs.
          */
         CStdString directory = *m_pathsToScan.begin();
-        if (!DoScan(directory))
+        if (!DoScan(directory, walker))
           bCancelled = true;
       }
 
+      CLibraryWatcher::Get().EndScan(CLibraryWatcher::LibraryVideo, !bCancelled);
+
       if (!bCancelled)
       {
         if (m_bClean)
@@ -135,6 +140,7 @@ namespace VIDEO
     }
     catch (...)
     {
+      CLibraryWatcher::Get().EndScan(CLibraryWatcher::LibraryVideo, false);
       CLog::Log(LOGERROR, "VideoInfoScanner: Exception while scanning.");
     }
   }
@@ -160,6 +166,11 @@ namespace VIDEO
     m_bClean = g_advancedSettings.m_bVideoLibraryCleanOnUpdate;
 
     StopThread();
+
+    // let the watcher skip local folders that didn't change since the last update
+    if (strDirectory.IsEmpty() && !scanAll)
+      CLibraryWatcher::Get().BeginScan(CLibraryWatcher::LibraryVideo, m_pathsToScan);
+
     Create();
     m_bRunning = true;
   }
@@ -191,7 +202,7 @@ namespace VIDEO
     m_pObserver = pObserver;
   }
 
-  bool CVideoInfoScanner::DoScan(const CStdString& strDirectory)
+  bool CVideoInfoScanner::DoScan(const CStdString& strDirectory, CDirectoryWalker &walker)
   {
     if (m_pObserver)
     {
@@ -234,16 +245,31 @@ namespace VIDEO
       if (m_pObserver)
         m_pObserver->OnStateChanged(content == CONTENT_MOVIES ? FETCHING_MOVIE_INFO : FETCHING_MUSICVIDEO_INFO);
 
-      CStdString fastHash = GetFastHash(strDirectory);
-      if (m_database.GetPathHash(strDirectory, dbHash) && !fastHash.IsEmpty() && fastHash == dbHash)
-      { // fast hashes match - no need to process anything
-        CLog::Log(LOGDEBUG, "VideoInfoScanner: Skipping dir '%s' due to no change (fasthash)", strDirectory.c_str());
-        hash = fastHash;
+      CStdString fastHash;
+      bool watched = false;
+      if (CLibraryWatcher::Get().IsUnchanged(CLibraryWatcher::LibraryVideo, strDirectory) && m_database.GetPathHash(strDirectory, dbHash))
+      { // folder has been watched since the last update and didn't change
+        CLog::Log(LOGDEBUG, "VideoInfoScanner: Skipping dir '%s' due to no change (watched)", strDirectory.c_str());
+        hash = dbHash;
         bSkip = true;
       }
+      else
+      { // watch the folder before it is hashed so that no later change is missed. It is trusted
+        // once the scan completes whether or not its fast hash lets us skip it, otherwise its
+        // trusted parent would skip it on the next update and it would never be checked again.
+        watched = CLibraryWatcher::Get().WatchDirectory(CLibraryWatcher::LibraryVideo, strDirectory);
+        fastHash = GetFastHash(strDirectory);
+        if (m_database.GetPathHash(strDirectory, dbHash) && !fastHash.IsEmpty() && fastHash == dbHash)
+        { // fast hashes match - no need to process anything
+          CLog::Log(LOGDEBUG, "VideoInfoScanner: Skipping dir '%s' due to no change (fasthash)", strDirectory.c_str());
+          hash = fastHash;
+          bSkip = true;
+        }
+      }
       if (!bSkip)
-      { // need to fetch the folder
-        CDirectory::GetDirectory(strDirectory, items, g_settings.m_videoExtensions);
+      { // need to fetch the folder - subfolders we'll recurse into are fetched in the meantime, unless
+        // they are watched, as they have to be listed after their watch is in place.
+        walker.GetDirectory(strDirectory, items, settings.recurse > 0 && content != CONTENT_TVSHOWS && !watched);
         items.Stack();
         // compute hash
         GetPathHash(items, hash);
@@ -337,7 +363,7 @@ namespace VIDEO
       // do not recurse for tv shows - we have already looked recursively for episodes
       if (pItem->m_bIsFolder && !pItem->IsParentFolder() && !pItem->IsPlayList() && settings.recurse > 0 && content != CONTENT_TVSHOWS)
       {
-        if (!DoScan(pItem->GetPath()))
+        if (!DoScan(pItem->GetPath(), walker))
         {
           m_bStop = true;
         }
@@ -28,6 +28,11 @@
 
 class CRegExp;
 
+namespace XFILE
+{
+  class CDirectoryWalker;
+}
+
 namespace VIDEO
 {
   typedef struct SScanSettings
@@ -137,7 +142,7 @@ namespace VIDEO
 
   protected:
     virtual void Process();
-    bool DoScan(const CStdString& strDirectory);
+    bool DoScan(const CStdString& strDirectory, XFILE::CDirectoryWalker &walker);
 
     INFO_RET RetrieveInfoForTvShow(CFileItemPtr pItem, bool bDirNames, ADDON::ScraperPtr &scraper, bool useLocal, CScraperUrl* pURL, bool fetchEpisodes, CGUIDialogProgress* pDlgProgress);
     INFO_RET RetrieveInfoForMovie(CFileItemPtr pItem, bool bDirNames, ADDON::ScraperPtr &scraper, bool useLocal, CScraperUrl* pURL, CGUIDialogProgress* pDlgProgress);
@@ -30,8 +30,10 @@
 #include "guilib/GUIControlFactory.h"
 #include "guilib/GUIFontManager.h"
 #include "guilib/GUITextLayout.h"
+#include "guilib/GUITextLayoutCache.h"
 #include "guilib/GUIWindowManager.h"
 #include "guilib/GUIControlProfiler.h"
+#include "guilib/GUITextBatch.h"
 #include "GUIInfoManager.h"
 #include "utils/Variant.h"
 
@@ -110,6 +112,18 @@ void CGUIWindowDebugInfo::Process(unsigned int currentTime, CDirtyRegionList &di
     info.Format("LOG: %sxbmc.log\nMEM: %"PRIu64"/%"PRIu64" KB - FPS: %2.1f fps\nCPU: %s (CPU-XBMC %4.2f%%%s)", g_settings.m_logFolder.c_str(),
                 stat.ullAvailPhys/1024, stat.ullTotalPhys/1024, g_infoManager.GetFPS(), strCores.c_str(), dCPU, profiling.c_str());
 #endif
+    unsigned int drawCalls, labels, vertexBytes;
+    CGUITextBatch::GetStats(drawCalls, labels, vertexBytes);
+    CStdString text;
+    text.Format("\nTEXT: %u draw calls, %u batched labels, %u KB vertices", drawCalls, labels, vertexBytes / 1024);
+    info += text;
+    unsigned int hits, misses;
+    CGUITextLayoutCache::GetInstance().GetStats(hits, misses);
+    if (hits + misses)
+    {
+      text.Format(" - layout cache %.1f%% of %u", 100.0f * hits / (hits + misses), hits + misses);
+      info += text;
+    }
   }
 
   // render the skin debug info